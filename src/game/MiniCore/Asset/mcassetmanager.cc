@@ -72,6 +72,12 @@ void MCAssetManager::load()
     loadMeshes();
 }
 
+void MCAssetManager::setGeometryOnly(bool geometryOnly)
+{
+    m_surfaceManager->setGeometryOnly(geometryOnly);
+    m_meshManager->setGeometryOnly(geometryOnly);
+}
+
 void MCAssetManager::loadSurfaces()
 {
     if (m_surfaceConfigPath != "")
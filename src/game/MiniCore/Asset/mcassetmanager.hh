@@ -51,6 +51,11 @@ public:
     //! Loads all assets.
     void load();
 
+    /*! Load only asset geometry: no textures are uploaded and no GL buffers
+     *  are created. Enables headless use without an OpenGL context.
+     *  Must be called before load(). */
+    void setGeometryOnly(bool geometryOnly);
+
     //! Destructor.
     ~MCAssetManager();
 
@@ -34,12 +34,25 @@
 #include <exception>
 
 MCMeshManager::MCMeshManager()
+: m_geometryOnly(false)
 {
 }
 
+void MCMeshManager::setGeometryOnly(bool geometryOnly)
+{
+    m_geometryOnly = geometryOnly;
+}
+
 MCMesh & MCMeshManager::createMesh(
     const MCMeshMetaData & data, const MCMesh::FaceVector & faces)
 {
+    if (m_geometryOnly)
+    {
+        MeshPtr mesh(new MCMesh(faces));
+        m_meshMap[data.handle] = mesh;
+        return *mesh;
+    }
+
     // Create material
     MCGLMaterialPtr material(new MCGLMaterial);
 
@@ -78,6 +78,10 @@ public:
     MCMesh & createMesh(
         const MCMeshMetaData & data, const MCMesh::FaceVector & faces);
 
+    //! Enable/disable geometry-only mode. In geometry-only mode meshes are created
+    //! without materials and GL buffers. Must be set before load(). Default is false.
+    void setGeometryOnly(bool geometryOnly);
+
 private:
 
     //! Map for resulting mesh objects
@@ -85,6 +89,8 @@ private:
     typedef std::unordered_map<std::string, MeshPtr> MeshHash;
     MeshHash m_meshMap;
 
+    bool m_geometryOnly;
+
     DISABLE_COPY(MCMeshManager);
     DISABLE_ASSI(MCMeshManager);
 };
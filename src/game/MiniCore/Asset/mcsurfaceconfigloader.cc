@@ -66,6 +66,7 @@ void MCSurfaceConfigLoader::parseAttributes(const QDomElement & element, Surface
     newData->handle2 = element.attribute("handle2", "").toStdString();
     newData->handle3 = element.attribute("handle3", "").toStdString();
     newData->xAxisMirror = element.attribute("xAxisMirror", "0").toInt();
+    newData->atlas = element.attribute("atlas", "0").toInt();
 
     if (element.hasAttribute("z")) // Shorthand z
     {
@@ -18,6 +18,7 @@
 //
 
 #include "mctypes.hh"
+#include "mcglscene.hh"
 #include "mcsurface.hh"
 #include "mcsurfaceconfigloader.hh"
 #include "mcsurfacemanager.hh"
@@ -26,15 +27,81 @@
 #include <QDir>
 #include <QFile>
 #include <QImage>
+#include <QImageReader>
 #include <QSysInfo>
 #include <MCGLEW>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <exception>
 
+namespace {
+
+//! Preferred size of the texture atlases.
+const int ATLAS_SIZE = 1024;
+
+//! Space around the images in an atlas. Filled by repeating the edge pixels
+//! so that linear filtering doesn't blend in neighbouring images.
+const int ATLAS_PADDING = 2;
+
+//! Position of an image in an atlas.
+struct AtlasPlacement
+{
+    const MCSurfaceMetaData * data;
+    const QImage * image;
+    int x;
+    int y;
+};
+
+std::pair<GLint, GLint> textureFilters(const MCSurfaceMetaData & data)
+{
+    return std::make_pair(
+        data.minFilter.second ? data.minFilter.first : GL_NEAREST,
+        data.magFilter.second ? data.magFilter.first : GL_NEAREST);
+}
+
+//! Copy the GL formatted images into a new atlas image.
+QImage composeAtlas(const std::vector<AtlasPlacement> & placements, int atlasSize)
+{
+    QImage atlas(atlasSize, atlasSize, QImage::Format_ARGB32);
+    atlas.fill(0);
+
+    for (const AtlasPlacement & placement : placements)
+    {
+        const QImage & image = *placement.image;
+        const int w = image.width();
+        const int h = image.height();
+        for (int row = -ATLAS_PADDING; row < h + ATLAS_PADDING; row++)
+        {
+            const quint32 * src = reinterpret_cast<const quint32 *>(
+                image.constScanLine(std::min(std::max(row, 0), h - 1)));
+            quint32 * dst = reinterpret_cast<quint32 *>(atlas.scanLine(placement.y + row)) + placement.x;
+            for (int col = -ATLAS_PADDING; col < w + ATLAS_PADDING; col++)
+            {
+                dst[col] = src[std::min(std::max(col, 0), w - 1)];
+            }
+        }
+    }
+
+    return atlas;
+}
+
+} // namespace
+
 MCSurfaceManager::MCSurfaceManager()
+: m_geometryOnly(false)
+{
+}
+
+void MCSurfaceManager::setGeometryOnly(bool geometryOnly)
 {
+    m_geometryOnly = geometryOnly;
+}
+
+bool MCSurfaceManager::geometryOnly() const
+{
+    return m_geometryOnly;
 }
 
 inline bool colorMatch(int val1, int val2, int threshold)
@@ -156,9 +223,14 @@ static void convertToGLFormatHelper(QImage &dst, const QImage &img, GLenum textu
 
 MCSurface & MCSurfaceManager::createSurfaceFromImage(const MCSurfaceMetaData & data, QImage image)
 {
-    // Store original width of the image
-    int origH = data.height.second ? data.height.first : image.height();
-    int origW = data.width.second  ? data.width.first  : image.width();
+    if (m_geometryOnly)
+    {
+        return createGeometryOnlySurface(data, image.width(), image.height());
+    }
+
+    // Store original size of the image
+    const int imageWidth = image.width();
+    const int imageHeight = image.height();
 
     // Take maximum supported texture size into account
     GLint maxTextureSize;
@@ -168,10 +240,19 @@ MCSurface & MCSurfaceManager::createSurfaceFromImage(const MCSurfaceMetaData & d
         image = image.scaled(image.width() / 2, image.height() / 2);
     }
 
+    return createSurfaceFromTexture(data, create2DTextureFromImage(data, image), imageWidth, imageHeight);
+}
+
+MCSurface & MCSurfaceManager::createSurfaceFromTexture(
+    const MCSurfaceMetaData & data, GLuint texture, int imageWidth, int imageHeight)
+{
+    const int origH = data.height.second ? data.height.first : imageHeight;
+    const int origW = data.width.second  ? data.width.first  : imageWidth;
+
     // Create material. Possible secondary textures are taken from surfaces
     // that are initialized before this surface.
     MCGLMaterialPtr material(new MCGLMaterial);
-    material->setTexture(create2DTextureFromImage(data, image), 0);
+    material->setTexture(texture, 0);
     material->setTexture(data.handle2.length() ? surface(data.handle2).material()->texture(0) : 0, 1);
     material->setTexture(data.handle3.length() ? surface(data.handle3).material()->texture(0) : 0, 2);
 
@@ -190,6 +271,103 @@ MCSurface & MCSurfaceManager::createSurfaceFromImage(const MCSurfaceMetaData & d
     return *surface;
 }
 
+bool MCSurfaceManager::canPackIntoAtlas(
+    const MCSurfaceMetaData & data, const QImage & image, const std::set<std::string> & secondaryHandles) const
+{
+    // Secondary textures and wrapping textures use the whole texture.
+    return data.atlas &&
+        data.handle2.empty() && data.handle3.empty() && !secondaryHandles.count(data.handle) &&
+        (!data.wrapS.second || data.wrapS.first == GL_CLAMP_TO_EDGE) &&
+        (!data.wrapT.second || data.wrapT.first == GL_CLAMP_TO_EDGE) &&
+        image.width() > 0 && image.width() <= ATLAS_SIZE / 2 &&
+        image.height() > 0 && image.height() <= ATLAS_SIZE / 2;
+}
+
+void MCSurfaceManager::createAtlasSurfaces(const MCSurfaceManager::AtlasImages & images)
+{
+    if (images.empty())
+    {
+        return;
+    }
+
+    GLint maxTextureSize;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+    const int atlasSize = std::min(ATLAS_SIZE, static_cast<int>(maxTextureSize));
+
+    // Group by the filters. Taller images first, so that the shelves are filled better.
+    AtlasImages sorted(images);
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [] (const AtlasImages::value_type & l, const AtlasImages::value_type & r) {
+        const std::pair<GLint, GLint> lFilters = textureFilters(*l.first);
+        const std::pair<GLint, GLint> rFilters = textureFilters(*r.first);
+        return lFilters != rFilters ? lFilters < rFilters : l.second.height() > r.second.height();
+    });
+
+    std::vector<AtlasPlacement> page;
+    const auto createPage = [&] () {
+        const GLuint texture = create2DTexture(*page.front().data, composeAtlas(page, atlasSize));
+        for (const AtlasPlacement & placement : page)
+        {
+            MCSurface & surface = createSurfaceFromTexture(
+                *placement.data, texture, placement.image->width(), placement.image->height());
+
+            const GLfloat u0 = static_cast<GLfloat>(placement.x) / atlasSize;
+            const GLfloat u1 = static_cast<GLfloat>(placement.x + placement.image->width()) / atlasSize;
+            const GLfloat v0 = static_cast<GLfloat>(placement.y) / atlasSize;
+            const GLfloat v1 = static_cast<GLfloat>(placement.y + placement.image->height()) / atlasSize;
+            const MCGLTexCoord texCoords[4] = {{u0, v0}, {u0, v1}, {u1, v1}, {u1, v0}};
+            surface.setTexCoords(texCoords);
+        }
+        page.clear();
+    };
+
+    // Simple shelf packing: fill rows left to right, start a new row when
+    // the current one is full and a new atlas when the atlas is full.
+    int x = 0, y = 0, shelfHeight = 0;
+    for (const AtlasImages::value_type & entry : sorted)
+    {
+        const int w = entry.second.width() + 2 * ATLAS_PADDING;
+        const int h = entry.second.height() + 2 * ATLAS_PADDING;
+
+        if (x + w > atlasSize)
+        {
+            x = 0;
+            y += shelfHeight;
+            shelfHeight = 0;
+        }
+
+        if (!page.empty() &&
+            (y + h > atlasSize || textureFilters(*entry.first) != textureFilters(*page.front().data)))
+        {
+            createPage();
+            x = y = shelfHeight = 0;
+        }
+
+        page.push_back({entry.first, &entry.second, x + ATLAS_PADDING, y + ATLAS_PADDING});
+        x += w;
+        shelfHeight = std::max(shelfHeight, h);
+    }
+
+    if (!page.empty())
+    {
+        createPage();
+    }
+}
+
+MCSurface & MCSurfaceManager::createGeometryOnlySurface(
+    const MCSurfaceMetaData & data, int imageWidth, int imageHeight)
+{
+    const int origH = data.height.second ? data.height.first : imageHeight;
+    const int origW = data.width.second  ? data.width.first  : imageWidth;
+
+    MCSurface * surface = new MCSurface(origW, origH, data.z0, data.z1, data.z2, data.z3);
+
+    assert(surface);
+    createSurfaceCommon(*surface, data);
+
+    return *surface;
+}
+
 void MCSurfaceManager::createSurfaceCommon(MCSurface & surface, const MCSurfaceMetaData & data)
 {
     // Enable alpha blend, if set
@@ -208,6 +386,12 @@ void MCSurfaceManager::createSurfaceCommon(MCSurface & surface, const MCSurfaceM
 
 GLuint MCSurfaceManager::create2DTextureFromImage(
     const MCSurfaceMetaData & data, const QImage & image)
+{
+    return create2DTexture(data, createGLFormattedImage(data, image));
+}
+
+QImage MCSurfaceManager::createGLFormattedImage(
+    const MCSurfaceMetaData & data, const QImage & image) const
 {
     QImage textureImage = image;
 
@@ -228,13 +412,18 @@ GLuint MCSurfaceManager::create2DTextureFromImage(
 
     QImage glFormattedImage(textureImage.width(), textureImage.height(), textureImage.format());
     convertToGLFormatHelper(glFormattedImage, textureImage, GL_RGBA);
+    return glFormattedImage;
+}
 
+GLuint MCSurfaceManager::create2DTexture(
+    const MCSurfaceMetaData & data, const QImage & glFormattedImage)
+{
     // Let OpenGL generate a texture handle
     GLuint textureHandle;
     glGenTextures(1, &textureHandle);
 
     // Bind the texture object
-    glBindTexture(GL_TEXTURE_2D, textureHandle);
+    MCGLScene::instance().stateCache().bindTexture(0, textureHandle);
 
     // Set min filter.
     if (data.minFilter.second)
@@ -304,22 +493,34 @@ void MCSurfaceManager::applyColorKey(QImage & textureImage, MCUint r, MCUint g,
 
 MCSurfaceManager::~MCSurfaceManager()
 {
-    // Delete OpenGL textures and Textures
+    // Delete OpenGL textures and Textures. Textures are shared by atlas
+    // surfaces and multi-texture surfaces, so delete each only once.
+    std::set<GLuint> textures;
     auto iter(m_surfaceMap.begin());
     while (iter != m_surfaceMap.end())
     {
         if (iter->second)
         {
             MCSurface * p = iter->second;
-            for (unsigned int i = 0; i < MCGLMaterial::MAX_TEXTURES; i++)
+            if (p->material())
             {
-                GLuint dummyHandle1 = p->material()->texture(i);
-                glDeleteTextures(1, &dummyHandle1);
+                for (unsigned int i = 0; i < MCGLMaterial::MAX_TEXTURES; i++)
+                {
+                    if (p->material()->texture(i))
+                    {
+                        textures.insert(p->material()->texture(i));
+                    }
+                }
             }
             delete p;
         }
         iter++;
     }
+
+    for (GLuint texture : textures)
+    {
+        glDeleteTextures(1, &texture);
+    }
 }
 
 void MCSurfaceManager::load(
@@ -330,6 +531,16 @@ void MCSurfaceManager::load(
     // Parse the texture config file
     if (loader.load(configFilePath))
     {
+        // Surfaces used as secondary textures can't be packed into atlases.
+        std::set<std::string> secondaryHandles;
+        for (unsigned int i = 0; i < loader.surfaceCount(); i++)
+        {
+            secondaryHandles.insert(loader.surface(i).handle2);
+            secondaryHandles.insert(loader.surface(i).handle3);
+        }
+
+        AtlasImages atlasImages;
+
         for (unsigned int i = 0; i < loader.surfaceCount(); i++)
         {
             const MCSurfaceMetaData & metaData = loader.surface(i);
@@ -340,6 +551,28 @@ void MCSurfaceManager::load(
             path.replace("./", "");
             path.replace("//", "/");
 
+            if (m_geometryOnly)
+            {
+                // Only the dimensions are needed: don't decode the image at all
+                // if they are given in the config, otherwise read just the header.
+                int imageWidth = 0, imageHeight = 0;
+                if (!metaData.width.second || !metaData.height.second)
+                {
+                    QFile imageFile(path);
+                    if (!imageFile.open(QIODevice::ReadOnly))
+                    {
+                        throw std::runtime_error("Cannot read file '" + path.toStdString() + "'");
+                    }
+
+                    const QSize imageSize = QImageReader(&imageFile).size();
+                    imageWidth  = imageSize.width();
+                    imageHeight = imageSize.height();
+                }
+
+                createGeometryOnlySurface(metaData, imageWidth, imageHeight);
+                continue;
+            }
+
             QFile imageFile(path);
             if (!imageFile.open(QIODevice::ReadOnly))
             {
@@ -349,8 +582,18 @@ void MCSurfaceManager::load(
 
             QImage textureImage;
             textureImage.loadFromData(blob);
-            createSurfaceFromImage(metaData, textureImage);
+
+            if (canPackIntoAtlas(metaData, textureImage, secondaryHandles))
+            {
+                atlasImages.push_back(std::make_pair(&metaData, createGLFormattedImage(metaData, textureImage)));
+            }
+            else
+            {
+                createSurfaceFromImage(metaData, textureImage);
+            }
         }
+
+        createAtlasSurfaces(atlasImages);
     }
     else
     {
@@ -20,8 +20,11 @@
 #ifndef MCSURFACEMANAGER_HH
 #define MCSURFACEMANAGER_HH
 
+#include <set>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "mcmacros.hh"
 #include "mcsurfacemetadata.hh"
@@ -41,6 +44,13 @@ class MCSurface;
  *
  * Texture surfaces will also be flipped about X-axis if desired.
  *
+ * Surfaces marked with atlas="1" are packed into shared texture atlases by
+ * load(), and their texture coordinates are set to their area of the atlas.
+ * This way objects of different types can share the texture binding. Only
+ * single-texture surfaces that clamp (the default wrap mode) and are not used
+ * as handle2 or handle3 of another surface are packed. Surfaces with the
+ * same filters share the same atlases.
+ *
  * MCSurface objects can be accessed via handles specified in the XML-based mapping file
  * and are loaded with MCSurfaceManager::load().
  *
@@ -58,6 +68,7 @@ class MCSurface;
  *   <surface handle="wall" image="wall.png"/>
  *   <surface handle="wallMultiTexture" image="wall.bmp" handle2="wall"/>
  *   <surface handle="Track" image="track.bmp"/>
+ *   <surface handle="Tree" image="tree.png" atlas="1"/>
  *   <surface handle="Bazooka" image="bazooka.jpg">
  *     <center x="10" y="5"/>
  *     <colorKey r="255" g="0" b="0"/>
@@ -100,14 +111,46 @@ public:
      *  MCSurfaceManager keeps the ownership. */
     MCSurface & createSurfaceFromImage(const MCSurfaceMetaData & data, QImage image);
 
+    /*! Enable/disable geometry-only mode. In geometry-only mode no textures
+     *  are uploaded and the created surfaces carry only their dimensions,
+     *  so surfaces can be loaded and used for object sizing without an
+     *  OpenGL context. Must be set before load(). Default is false. */
+    void setGeometryOnly(bool geometryOnly);
+
+    //! \return true if geometry-only mode is enabled.
+    bool geometryOnly() const;
+
 private:
 
+    //! Helper to create a surface without a texture.
+    MCSurface & createGeometryOnlySurface(const MCSurfaceMetaData & data, int imageWidth, int imageHeight);
+
     //! Apply given color key (set alpha values on / off based on the given color).
     void applyColorKey(QImage & textureImage, MCUint r, MCUint g, MCUint b) const;
 
     //! Helper to create the actual OpenGL texture.
     GLuint create2DTextureFromImage(const MCSurfaceMetaData & data, const QImage & image);
 
+    //! Helper to mirror, color key and convert the image into the GL format.
+    QImage createGLFormattedImage(const MCSurfaceMetaData & data, const QImage & image) const;
+
+    //! Helper to upload a GL formatted image using the filters and wraps of data.
+    GLuint create2DTexture(const MCSurfaceMetaData & data, const QImage & glFormattedImage);
+
+    //! Helper to create a surface using the given texture.
+    MCSurface & createSurfaceFromTexture(
+        const MCSurfaceMetaData & data, GLuint texture, int imageWidth, int imageHeight);
+
+    //! \return true if the surface can be packed into an atlas.
+    bool canPackIntoAtlas(
+        const MCSurfaceMetaData & data, const QImage & image, const std::set<std::string> & secondaryHandles) const;
+
+    //! Images waiting to be packed by createAtlasSurfaces().
+    typedef std::vector<std::pair<const MCSurfaceMetaData *, QImage> > AtlasImages;
+
+    //! Pack the images into atlases and create their surfaces.
+    void createAtlasSurfaces(const AtlasImages & images);
+
     //! Helper to set surface meta data.
     void createSurfaceCommon(MCSurface & surface, const MCSurfaceMetaData & data);
 
@@ -115,6 +158,8 @@ private:
     typedef std::unordered_map<std::string, MCSurface *> SurfaceHash;
     SurfaceHash m_surfaceMap;
 
+    bool m_geometryOnly;
+
     DISABLE_COPY(MCSurfaceManager);
     DISABLE_ASSI(MCSurfaceManager);
 };
@@ -33,6 +33,7 @@ struct MCSurfaceMetaData
     MCSurfaceMetaData()
     : colorKeySet(false)
     , xAxisMirror(false)
+    , atlas(false)
     , z0(0.0f)
     , z1(0.0f)
     , z2(0.0f)
@@ -89,6 +90,9 @@ struct MCSurfaceMetaData
     //! True if X-Axis mirroring is wanted
     bool xAxisMirror;
 
+    //! True if the texture may be packed into a shared texture atlas
+    bool atlas;
+
     //! Min filter value
     std::pair<GLint, bool> minFilter;
 
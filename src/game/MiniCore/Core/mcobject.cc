@@ -38,7 +38,8 @@
 
 MCUint MCObject::m_typeIDCount = 1;
 MCObject::TypeHash MCObject::m_typeHash;
-MCObject::TimerEventObjectsList MCObject::m_timerEventObjects;
+std::mutex MCObject::m_typeHashMutex;
+thread_local MCObject::TimerEventObjectsList MCObject::m_timerEventObjects;
 
 MCObject::MCObject(const std::string & typeId)
     : m_physicsComponent(nullptr)
@@ -85,6 +86,7 @@ void MCObject::init(const std::string & typeId)
     m_i1                     = 0;
     m_j0                     = 0;
     m_j1                     = 0;
+    m_renderGridIndex        = -1;
     m_initialAngle           = 0;
     m_timerEventObjectsIndex = -1;
     m_physicsObject          = true;
@@ -99,6 +101,7 @@ void MCObject::init(const std::string & typeId)
 
 MCUint MCObject::getTypeIDForName(const std::string & typeName)
 {
+    std::lock_guard<std::mutex> lock(m_typeHashMutex);
     auto i(m_typeHash.find(typeName));
     return i == m_typeHash.end() ? 0 : i->second;
 }
@@ -131,6 +134,8 @@ MCObject & MCObject::parent() const
 
 MCUint MCObject::registerType(const std::string & typeName)
 {
+    // Type ids are shared by all worlds and threads.
+    std::lock_guard<std::mutex> lock(m_typeHashMutex);
     auto i(m_typeHash.find(typeName));
     if (i == m_typeHash.end())
     {
@@ -432,6 +437,11 @@ void MCObject::translate(const MCVector3dF & newLocation)
     {
         MCWorld::instance().objectGrid().insert(*this);
     }
+
+    if (m_renderGridIndex >= 0)
+    {
+        MCWorld::instance().renderer().renderGrid().update(*this);
+    }
 }
 
 void MCObject::displace(const MCVector3dF & displacement)
@@ -627,42 +637,6 @@ bool MCObject::removing() const
     return m_removing;
 }
 
-void MCObject::addContact(MCContact & contact)
-{
-    m_contacts[&contact.object()].push_back(&contact);
-}
-
-const MCObject::ContactHash & MCObject::contacts() const
-{
-    return m_contacts;
-}
-
-void MCObject::deleteContacts()
-{
-    auto i(m_contacts.begin());
-    for (; i != m_contacts.end(); i++)
-    {
-        for (MCUint j = 0; j < i->second.size(); j++)
-        {
-            i->second[j]->free();
-        }
-    }
-    m_contacts.clear();
-}
-
-void MCObject::deleteContacts(MCObject & object)
-{
-    auto i(m_contacts.find(&object));
-    if (i != m_contacts.end())
-    {
-        for (MCUint j = 0; j < i->second.size(); j++)
-        {
-            i->second[j]->free();
-        }
-        i->second.clear();
-    }
-}
-
 void MCObject::setInitialLocation(const MCVector3dF & location)
 {
     m_initialLocation = location;
@@ -725,6 +699,5 @@ MCPhysicsComponent & MCObject::physicsComponent()
 MCObject::~MCObject()
 {
     removeFromWorldNow();
-    deleteContacts();
     delete m_physicsComponent;
 }
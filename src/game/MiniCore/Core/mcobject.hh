@@ -21,7 +21,6 @@
 #define MCOBJECT_HH
 
 #include "mcbbox.hh"
-#include "mccontact.hh"
 #include "mcmacros.hh"
 #include "mcobjectgrid.hh"
 #include "mcshape.hh"
@@ -31,6 +30,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -54,9 +54,6 @@ class MCObject
 {
 public:
 
-    //! Hash container for contacts. Prefer map here for iteration performance.
-    typedef std::map<MCObject *, std::vector<MCContact *> > ContactHash;
-
     /*! Constructor.
      *  \param typeId Type ID string e.g. "MY_OBJECT_CLASS". */
     explicit MCObject(const std::string & typeId);
@@ -111,7 +108,7 @@ public:
     static void unsubscribeTimerEvent(MCObject & object);
 
     /*! Send the given timer event to all objects that
-     *  have subscribed to timer events. */
+     *  have subscribed to timer events in the calling thread. */
     static void sendTimerEvent(MCTimerEvent & event);
 
     /*! Render the object.
@@ -250,18 +247,6 @@ public:
     //! Return the collision layer.
     int collisionLayer() const;
 
-    //! Add a collision contact.
-    void addContact(MCContact & contact);
-
-    //! Get collision contact hash.
-    const ContactHash & contacts() const;
-
-    //! Delete current contacts.
-    void deleteContacts();
-
-    //! Delete all contacts with the given object.
-    void deleteContacts(MCObject & object);
-
     //! Return index in MCWorld's object vector. Returns -1 if not in the world.
     int index() const;
 
@@ -364,6 +349,7 @@ private:
     int                          m_collisionLayer;
     int                          m_index;
     MCUint                       m_i0, m_i1, m_j0, m_j1;
+    int                          m_renderGridIndex;
     MCVector3dF                  m_initialLocation;
     int                          m_initialAngle;
     MCVector3dF                  m_location;
@@ -372,10 +358,10 @@ private:
     MCShapePtr                   m_shape;
     typedef std::unordered_map<std::string, MCUint> TypeHash;
     static TypeHash              m_typeHash;
+    static std::mutex            m_typeHashMutex;
     typedef std::vector<MCObject * > TimerEventObjectsList;
-    static TimerEventObjectsList m_timerEventObjects;
+    static thread_local TimerEventObjectsList m_timerEventObjects;
     static MCUint                m_typeIDCount;
-    MCObject::ContactHash        m_contacts;
     int                          m_timerEventObjectsIndex;
     bool                         m_physicsObject;
     bool                         m_triggerObject;
@@ -396,6 +382,7 @@ private:
 
     friend class MCObjectGrid;
     friend class MCObjectGridImpl;
+    friend class MCRenderGrid;
     friend class MCWorld;
     friend class MCCollisionDetector;
 };
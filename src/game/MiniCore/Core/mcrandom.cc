@@ -49,7 +49,7 @@ private:
   friend class MCRandom;
 };
 
-std::unique_ptr<MCRandomImpl> const MCRandom::m_impl(new MCRandomImpl);
+thread_local std::unique_ptr<MCRandomImpl> const MCRandom::m_impl(new MCRandomImpl);
 
 MCRandomImpl::MCRandomImpl() :
     m_valPtr(0),
@@ -88,6 +88,8 @@ MCFloat MCRandom::getValue()
 void MCRandom::setSeed(int seed)
 {
     MCRandom::m_impl->m_seed = seed;
+    MCRandom::m_impl->m_valPtr = 0;
+    MCRandom::m_impl->m_isBuilt = false;
 }
 
 MCVector2dF MCRandom::randomVector2d()
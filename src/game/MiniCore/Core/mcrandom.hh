@@ -29,7 +29,7 @@
 
 class MCRandomImpl;
 
-//! MCRandom number LUT.
+//! MCRandom number LUT. Each thread has its own table and seed.
 class MCRandom
 {
 public:
@@ -46,7 +46,7 @@ public:
     //! Return a random 3d vector with a positive Z only
     static MCVector3dF randomVector3dPositiveZ();
 
-    //! Set random seed (before getValue() is called the first time).
+    //! Set random seed of the calling thread. The table is rebuilt on the next getValue().
     static void setSeed(int seed);
 
 private:
@@ -60,7 +60,7 @@ private:
     //! Disable assignment
     DISABLE_ASSI(MCRandom);
 
-    static std::unique_ptr<MCRandomImpl> const m_impl;
+    static thread_local std::unique_ptr<MCRandomImpl> const m_impl;
 };
 
 #endif // MCRANDOM_HH
@@ -22,6 +22,7 @@
 #include "mcbbox.hh"
 #include "mccamera.hh"
 #include "mccollisiondetector.hh"
+#include "mccontactmanifold.hh"
 #include "mcforcegenerator.hh"
 #include "mcforceregistry.hh"
 #include "mcfrictiongenerator.hh"
@@ -39,14 +40,15 @@
 
 #include <cassert>
 
-MCWorld * MCWorld::m_instance              = nullptr;
-MCFloat   MCWorld::m_metersPerUnit        = 1.0;
-MCFloat   MCWorld::m_metersPerUnitSquared = 1.0;
+thread_local MCWorld * MCWorld::m_instance              = nullptr;
+thread_local MCFloat   MCWorld::m_metersPerUnit        = 1.0;
+thread_local MCFloat   MCWorld::m_metersPerUnitSquared = 1.0;
 
 MCWorld::MCWorld()
 : m_renderer(new MCWorldRenderer)
 , m_forceRegistry(new MCForceRegistry)
-, m_collisionDetector(new MCCollisionDetector)
+, m_contactManifold(new MCContactManifold)
+, m_collisionDetector(new MCCollisionDetector(*m_contactManifold))
 , m_impulseGenerator(new MCImpulseGenerator)
 , m_objectGrid(nullptr)
 , m_minX(0)
@@ -70,7 +72,7 @@ MCWorld::MCWorld()
     }
     else
     {
-        std::cerr << "ERROR!!: Only one MCWorld can exist!" << std::endl;
+        std::cerr << "ERROR!!: Only one MCWorld can exist per thread!" << std::endl;
         exit(EXIT_FAILURE);
     }
 
@@ -85,6 +87,7 @@ MCWorld::~MCWorld()
     delete m_renderer;
     delete m_forceRegistry;
     delete m_collisionDetector;
+    delete m_contactManifold;
     delete m_impulseGenerator;
     delete m_objectGrid;
     delete m_leftWallObject;
@@ -99,16 +102,15 @@ void MCWorld::integrate(MCFloat step)
 {
     // Integrate and update all registered objects
     m_forceRegistry->update();
-    const MCUint objectCount = static_cast<MCUint>(m_objs.size());
-    for (MCUint i = 0; i < objectCount; i++)
+    m_integrationObjs.assign(m_objs.begin(), m_objs.end());
+    for (MCObject * object : m_integrationObjs)
     {
-        MCObject & object(*m_objs[i]);
-        if (object.isPhysicsObject() && !object.physicsComponent().isStationary())
+        if (object->isPhysicsObject() && !object->physicsComponent().isStationary())
         {
-            object.stepTime(step);
+            object->stepTime(step);
         }
 
-        object.onStepTime(step);
+        object->onStepTime(step);
     }
 }
 
@@ -120,12 +122,14 @@ void MCWorld::detectCollisions()
 
 void MCWorld::generateImpulses()
 {
-    m_impulseGenerator->generateImpulsesFromDeepestContacts(m_objs);
+    m_impulseGenerator->generateImpulsesFromDeepestContacts(*m_contactManifold);
+    m_contactManifold->clear();
 }
 
 void MCWorld::resolvePositions(MCFloat accuracy)
 {
-    m_impulseGenerator->resolvePositions(m_objs, accuracy);
+    m_impulseGenerator->resolvePositions(*m_contactManifold, accuracy);
+    m_contactManifold->clear();
 }
 
 void MCWorld::prepareRendering(MCCamera * camera)
@@ -166,7 +170,6 @@ void MCWorld::clear()
     // cleared and all objects will be removed at once.
     for (MCObject * object : m_objs)
     {
-        object->deleteContacts();
         object->physicsComponent().reset();
         object->setIndex(-1);
 
@@ -177,6 +180,7 @@ void MCWorld::clear()
     }
 
     m_renderer->clear();
+    m_contactManifold->clear();
     m_objectGrid->removeAll();
     m_objs.clear();
     m_removeObjs.clear();
@@ -209,6 +213,8 @@ void MCWorld::setDimensions(
         m_maxX, m_maxY,
         leafWidth, leafHeight);
 
+    m_renderer->setDimensions(m_minX, m_maxX, m_minY, m_maxY);
+
     // Create "wall" objects
     const MCFloat w = m_maxX - m_minX;
     const MCFloat h = m_maxY - m_minY;
@@ -347,16 +353,7 @@ void MCWorld::removeObjectNow(MCObject & object)
     if (object.index() >= 0)
     {
         object.setRemoving(true);
-        for (MCObject * obj : m_objs)
-        {
-            if (obj != &object)
-            {
-                if (obj->isPhysicsObject())
-                {
-                    obj->deleteContacts(object);
-                }
-            }
-        }
+        m_contactManifold->removeContacts(object);
 
         doRemoveObject(object);
     }
@@ -427,15 +424,18 @@ void MCWorld::processCollisions()
 {
     detectCollisions();
 
-    if (m_numCollisions)
+    // Force generators may have added contacts, too.
+    if (m_numCollisions || !m_contactManifold->empty())
     {
         generateImpulses();
 
         // Process contacts and generate impulses
         m_collisionDetector->enableCollisionEvents(false);
-        for (MCUint i = 0; i < m_numResolverLoops; i++)
+        // Only the resolution moves objects from here on, so re-test just
+        // the ones that collided on the previous round.
+        for (MCUint i = 0; i < m_numResolverLoops && m_numCollisions; i++)
         {
-            detectCollisions();
+            m_numCollisions = m_collisionDetector->redetectCollisions(*m_objectGrid);
             resolvePositions(m_resolverStep);
         }
         m_collisionDetector->enableCollisionEvents(true);
@@ -448,6 +448,12 @@ MCForceRegistry & MCWorld::forceRegistry() const
     return *m_forceRegistry;
 }
 
+MCContactManifold & MCWorld::contactManifold() const
+{
+    assert(m_contactManifold);
+    return *m_contactManifold;
+}
+
 void MCWorld::stepTime(MCFloat step)
 {
     // Integrate physics
@@ -29,7 +29,7 @@
 
 class MCCamera;
 class MCCollisionDetector;
-class MCContact;
+class MCContactManifold;
 class MCForceRegistry;
 class MCImpulseGenerator;
 class MCObject;
@@ -47,6 +47,11 @@ class MCWorldRenderer;
  * move on the XY-plane. Direction of the gravity can be freely set.
  *
  * MCWorld uses MCWorldRenderer to render the scene.
+ *
+ * There can be one MCWorld per thread. MCWorld::instance() and the
+ * world-wide settings like metersPerUnit() refer to the world of the
+ * calling thread, so independent simulations can run in parallel
+ * threads as long as they don't share objects.
  */
 class MCWorld
 {
@@ -60,9 +65,10 @@ public:
     //! Destructor.
     virtual ~MCWorld();
 
-    //! Return the one-and-only MCWorld instance.
+    //! Return the MCWorld instance of the calling thread.
     static MCWorld & instance();
 
+    //! \return true if the calling thread has an MCWorld instance.
     static bool hasInstance();
 
     //! Remove all objects.
@@ -88,10 +94,10 @@ public:
 
     const MCVector3dF & gravity() const;
 
-    //! Set how many meters equal one unit in the scene.
+    //! Set how many meters equal one unit in the scene of the calling thread.
     static void setMetersPerUnit(MCFloat value);
 
-    //! Get how many meters equal one unit in the scene.
+    //! Get how many meters equal one unit in the scene of the calling thread.
     static MCFloat metersPerUnit();
 
     //! Convert scene units to meters.
@@ -128,6 +134,9 @@ public:
     //! \return Force registry. Use this to add force generators to objects.
     MCForceRegistry & forceRegistry() const;
 
+    //! \return Contacts of the current step. Force generators can add contacts here.
+    MCContactManifold & contactManifold() const;
+
     /*! \brief Step world time
      *  This causes the integration of physics and executes collision detections.
      *  \param step Time step to be updated */
@@ -189,19 +198,23 @@ private:
     void detectCollisions();
     void generateImpulses();
     void resolvePositions(MCFloat accuracy);
-    MCContact * getDeepestInterpenetration(const std::vector<MCContact *> & contacts);
 
-    static MCWorld      * m_instance;
+    static thread_local MCWorld * m_instance;
     MCWorldRenderer     * m_renderer;
     MCForceRegistry     * m_forceRegistry;
+    MCContactManifold   * m_contactManifold;
     MCCollisionDetector * m_collisionDetector;
     MCImpulseGenerator  * m_impulseGenerator;
     MCObjectGrid        * m_objectGrid;
-    static MCFloat        m_metersPerUnit;
-    static MCFloat        m_metersPerUnitSquared;
+    static thread_local MCFloat m_metersPerUnit;
+    static thread_local MCFloat m_metersPerUnitSquared;
     MCFloat               m_minX, m_maxX, m_minY, m_maxY, m_minZ, m_maxZ;
     MCWorld::ObjectVector m_objs;
     MCWorld::ObjectVector m_removeObjs;
+
+    //! Reused copy of m_objs, because objects that fall asleep during
+    //! integrate() are swap-removed from m_objs.
+    MCWorld::ObjectVector m_integrationObjs;
     MCObject            * m_leftWallObject;
     MCObject            * m_rightWallObject;
     MCObject            * m_topWallObject;
@@ -24,6 +24,10 @@
 #include <cassert>
 #include <exception>
 
+#ifdef __MC_QOPENGLFUNCTIONS__
+#include <QOpenGLContext>
+#endif
+
 GLuint MCGLObjectBase::m_boundVbo = 0;
 
 MCGLObjectBase::MCGLObjectBase()
@@ -39,7 +43,11 @@ MCGLObjectBase::MCGLObjectBase()
 , m_hasVao(true)
 {
 #ifdef __MC_QOPENGLFUNCTIONS__
-    initializeOpenGLFunctions();
+    // Geometry-only objects can be created without a context.
+    if (QOpenGLContext::currentContext())
+    {
+        initializeOpenGLFunctions();
+    }
 #endif
 }
 
@@ -71,6 +79,7 @@ void MCGLObjectBase::bindVAO()
     if (m_hasVao)
     {
         m_vao.bind();
+        MCGLScene::instance().stateCache().countVertexArrayBind();
     }
     else
     {
@@ -78,6 +87,7 @@ void MCGLObjectBase::bindVAO()
     }
 #else
     glBindVertexArray(m_vao);
+    MCGLScene::instance().stateCache().countVertexArrayBind();
 #endif
 }
 
@@ -87,6 +97,7 @@ void MCGLObjectBase::releaseVAO()
     if (m_hasVao)
     {
         m_vao.release();
+        MCGLScene::instance().stateCache().countVertexArrayBind();
     }
 #endif
 }
@@ -107,12 +118,14 @@ void MCGLObjectBase::bindVBO()
 {
     glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
     MCGLObjectBase::m_boundVbo = m_vbo;
+    MCGLScene::instance().stateCache().countBufferBind();
 }
 
 void MCGLObjectBase::releaseVBO()
 {
     MCGLObjectBase::m_boundVbo = 0;
     glBindBuffer(GL_ARRAY_BUFFER, 0);
+    MCGLScene::instance().stateCache().countBufferBind();
 }
 
 void MCGLObjectBase::createVBO()
@@ -197,6 +210,7 @@ void MCGLObjectBase::initBufferData(int totalDataSize, GLuint drawType)
     bindVBO();
 
     glBufferData(GL_ARRAY_BUFFER, totalDataSize, nullptr, drawType);
+    MCGLScene::instance().stateCache().countBufferUpload();
 
     m_bufferDataOffset = 0;
 }
@@ -213,6 +227,7 @@ void MCGLObjectBase::addBufferSubData(
     assert(dataSize <= offsetJump);
 
     glBufferSubData(GL_ARRAY_BUFFER, m_bufferDataOffset, dataSize, data);
+    MCGLScene::instance().stateCache().countBufferUpload();
 
     m_bufferDataOffset += offsetJump;
 
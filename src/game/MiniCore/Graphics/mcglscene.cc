@@ -29,7 +29,7 @@
 #include <cmath>
 #include <exception>
 
-MCGLScene * MCGLScene::m_instance = nullptr;
+thread_local MCGLScene * MCGLScene::m_instance = nullptr;
 
 MCGLScene::MCGLScene()
 : m_splitType(ShowFullScreen)
@@ -118,6 +118,8 @@ void MCGLScene::initialize()
     }
     MCLogger().info() << "Using GLEW " << glewGetString(GLEW_VERSION);
 #endif
+    m_stateCache.initialize();
+
     glShadeModel(GL_SMOOTH);
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
@@ -297,6 +299,11 @@ void MCGLScene::setSpecularLight(const MCGLDiffuseLight & light)
     }
 }
 
+MCGLStateCache & MCGLScene::stateCache()
+{
+    return m_stateCache;
+}
+
 MCFloat MCGLScene::viewAngle() const
 {
     return m_viewAngle;
@@ -309,6 +316,9 @@ MCFloat MCGLScene::eyeZ() const
 
 MCGLScene::~MCGLScene()
 {
-    MCGLScene::m_instance = nullptr;
+    if (MCGLScene::m_instance == this)
+    {
+        MCGLScene::m_instance = nullptr;
+    }
 }
 
@@ -22,6 +22,7 @@
 
 #include <MCGLM>
 #include "mcglshaderprogram.hh"
+#include "mcglstatecache.hh"
 #include "mctypes.hh"
 #include <vector>
 
@@ -94,6 +95,10 @@ public:
     //! \return default shader program for text shadow.
     MCGLShaderProgramPtr defaultTextShadowShaderProgram();
 
+    /*! \return the GL state cache. Blending, depth and program / texture
+     *  bindings should be changed thru it while rendering. */
+    MCGLStateCache & stateCache();
+
     //! \return current view angle
     MCFloat viewAngle() const;
 
@@ -158,7 +163,9 @@ private:
 
     MCGLShaderProgramPtr m_defaultTextShadowShader;
 
-    static MCGLScene * m_instance;
+    MCGLStateCache m_stateCache;
+
+    static thread_local MCGLScene * m_instance;
 
     friend class MCGLShaderProgram;
 };
@@ -31,9 +31,35 @@
 #include <MCLogger>
 #include <MCTrigonom>
 
+#include <algorithm>
 #include <cassert>
 #include <exception>
 
+namespace {
+// Uniform names used in the shaders in the order of the Uniform enum
+const char * const UNIFORM_NAMES[] =
+{
+    "ac",
+    "dd",
+    "dc",
+    "sd",
+    "sc",
+    "sCoeff",
+    "fade",
+    "tex0",
+    "tex1",
+    "tex2",
+    "vp",
+    "v",
+    "model",
+    "color",
+    "scale",
+    "camera",
+    "userData1",
+    "userData2"
+};
+}
+
 MCGLShaderProgram * MCGLShaderProgram::m_activeProgram = nullptr;
 
 std::vector<MCGLShaderProgram *> MCGLShaderProgram::m_programStack;
@@ -59,7 +85,7 @@ MCGLShaderProgram::MCGLShaderProgram()
 #ifdef __MC_QOPENGLFUNCTIONS__
     initializeOpenGLFunctions();
 #endif
-    initUniformNameMap();
+    std::fill(m_uniformLocations, m_uniformLocations + UniformCount, -1);
 
     m_program = glCreateProgram();
     m_fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
@@ -88,7 +114,7 @@ MCGLShaderProgram::MCGLShaderProgram(
 #ifdef __MC_QOPENGLFUNCTIONS__
     initializeOpenGLFunctions();
 #endif
-    initUniformNameMap();
+    std::fill(m_uniformLocations, m_uniformLocations + UniformCount, -1);
 
     m_program = glCreateProgram();
     m_fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
@@ -99,30 +125,6 @@ MCGLShaderProgram::MCGLShaderProgram(
     link();
 }
 
-void MCGLShaderProgram::initUniformNameMap()
-{
-    // Map uniform enums to uniform names used in the shaders
-    m_uniforms[AmbientLightColor]  = "ac";
-    m_uniforms[Camera]             = "camera";
-    m_uniforms[Color]              = "color";
-    m_uniforms[DiffuseLightDir]    = "dd";
-    m_uniforms[DiffuseLightColor]  = "dc";
-    m_uniforms[SpecularLightDir]   = "sd";
-    m_uniforms[SpecularLightColor] = "sc";
-    m_uniforms[SpecularCoeff]      = "sCoeff";
-    m_uniforms[Fade]               = "fade";
-    m_uniforms[Tex0]               = "tex0";
-    m_uniforms[Tex1]               = "tex1";
-    m_uniforms[Tex2]               = "tex2";
-    m_uniforms[UserData1]          = "userData1";
-    m_uniforms[UserData2]          = "userData2";
-    m_uniforms[ViewProjection]     = "vp";
-    m_uniforms[View]               = "v";
-    m_uniforms[Model]              = "model";
-    m_uniforms[Scale]              = "scale";
-    m_uniforms[Camera]             = "camera";
-}
-
 MCGLShaderProgram::~MCGLShaderProgram()
 {
     glDeleteProgram(m_program);
@@ -132,25 +134,45 @@ MCGLShaderProgram::~MCGLShaderProgram()
 
 int MCGLShaderProgram::getUniformLocation(Uniform uniform)
 {
-    return m_uniformLocationHash[uniform];
+    return m_uniformLocations[uniform];
 }
 
 void MCGLShaderProgram::initUniformLocationCache()
 {
     assert(isLinked());
+    static_assert(sizeof(UNIFORM_NAMES) / sizeof(UNIFORM_NAMES[0]) == UniformCount,
+        "Uniform names don't match the Uniform enum");
 
-    auto iter = m_uniforms.begin();
-    while (iter != m_uniforms.end())
+    for (int i = 0; i < UniformCount; i++)
     {
-        m_uniformLocationHash[iter->first] = glGetUniformLocation(m_program, iter->second.c_str());
-        iter++;
+        m_uniformLocations[i] = glGetUniformLocation(m_program, UNIFORM_NAMES[i]);
+        m_uniformValues[i].valid = false;
     }
 }
 
+bool MCGLShaderProgram::uniformChanged(Uniform uniform, const GLfloat * values, int count)
+{
+    assert(count <= 16);
+
+    UniformValue & cached = m_uniformValues[uniform];
+    if (m_uniformLocations[uniform] == -1 ||
+        (cached.valid && std::equal(values, values + count, cached.data)))
+    {
+        m_scene.stateCache().countSkippedCalls();
+        return false;
+    }
+
+    std::copy(values, values + count, cached.data);
+    cached.valid = true;
+
+    m_scene.stateCache().countCalls();
+    return true;
+}
+
 void MCGLShaderProgram::bind()
 {
     MCGLShaderProgram::m_activeProgram = this;
-    glUseProgram(m_program);
+    m_scene.stateCache().useProgram(m_program);
 
     setPendingAmbientLight();
     setPendingCamera();
@@ -337,7 +359,9 @@ void MCGLShaderProgram::setPendingViewProjectionMatrix()
 {
     if (m_viewProjectionMatrixPending) {
         m_viewProjectionMatrixPending = false;
-        glUniformMatrix4fv(getUniformLocation(ViewProjection), 1, GL_FALSE, &m_viewProjectionMatrix[0][0]);
+        if (uniformChanged(ViewProjection, &m_viewProjectionMatrix[0][0], 16)) {
+            glUniformMatrix4fv(getUniformLocation(ViewProjection), 1, GL_FALSE, &m_viewProjectionMatrix[0][0]);
+        }
     }
 }
 
@@ -355,7 +379,9 @@ void MCGLShaderProgram::setPendingViewMatrix()
 {
     if (m_viewMatrixPending) {
         m_viewMatrixPending = false;
-        glUniformMatrix4fv(getUniformLocation(View), 1, GL_FALSE, &m_viewMatrix[0][0]);
+        if (uniformChanged(View, &m_viewMatrix[0][0], 16)) {
+            glUniformMatrix4fv(getUniformLocation(View), 1, GL_FALSE, &m_viewMatrix[0][0]);
+        }
     }
 }
 
@@ -377,7 +403,9 @@ void MCGLShaderProgram::setPendingTransform()
         m_transformPending = false;
         glm::mat4 translate = glm::translate(glm::mat4(1.0f), glm::vec3(m_pos.i(), m_pos.j(), m_pos.k()));
         glm::mat4 rotation  = glm::rotate(translate, m_angle, glm::vec3(0.0f, 0.0f, 1.0f));
-        glUniformMatrix4fv(getUniformLocation(Model), 1, GL_FALSE, &rotation[0][0]);
+        if (uniformChanged(Model, &rotation[0][0], 16)) {
+            glUniformMatrix4fv(getUniformLocation(Model), 1, GL_FALSE, &rotation[0][0]);
+        }
     }
 }
 
@@ -395,7 +423,10 @@ void MCGLShaderProgram::setPendingUserData1()
 {
     if (m_userData1Pending) {
         m_userData1Pending = false;
-        glUniform2f(getUniformLocation(UserData1), m_userData1.i(), m_userData1.j());
+        const GLfloat values[] = {m_userData1.i(), m_userData1.j()};
+        if (uniformChanged(UserData1, values, 2)) {
+            glUniform2fv(getUniformLocation(UserData1), 1, values);
+        }
     }
 }
 
@@ -413,7 +444,10 @@ void MCGLShaderProgram::setPendingUserData2()
 {
     if (m_userData2Pending) {
         m_userData2Pending = false;
-        glUniform2f(getUniformLocation(UserData2), m_userData2.i(), m_userData2.j());
+        const GLfloat values[] = {m_userData2.i(), m_userData2.j()};
+        if (uniformChanged(UserData2, values, 2)) {
+            glUniform2fv(getUniformLocation(UserData2), 1, values);
+        }
     }
 }
 
@@ -431,7 +465,10 @@ void MCGLShaderProgram::setPendingCamera()
 {
     if (m_cameraPending) {
         m_cameraPending = false;
-        glUniform2f(getUniformLocation(Camera), m_camera.i(), m_camera.j());
+        const GLfloat values[] = {m_camera.i(), m_camera.j()};
+        if (uniformChanged(Camera, values, 2)) {
+            glUniform2fv(getUniformLocation(Camera), 1, values);
+        }
     }
 }
 
@@ -449,7 +486,10 @@ void MCGLShaderProgram::setPendingColor()
 {
     if (m_colorPending) {
         m_colorPending = false;
-        glUniform4f(getUniformLocation(Color), m_color.r(), m_color.g(), m_color.b(), m_color.a());
+        const GLfloat values[] = {m_color.r(), m_color.g(), m_color.b(), m_color.a()};
+        if (uniformChanged(Color, values, 4)) {
+            glUniform4fv(getUniformLocation(Color), 1, values);
+        }
     }
 }
 
@@ -467,7 +507,10 @@ void MCGLShaderProgram::setPendingScale()
 {
     if (m_scalePending) {
         m_scalePending = false;
-        glUniform4f(getUniformLocation(Scale), m_scale.i(), m_scale.j(), m_scale.k(), 1);
+        const GLfloat values[] = {m_scale.i(), m_scale.j(), m_scale.k(), 1};
+        if (uniformChanged(Scale, values, 4)) {
+            glUniform4fv(getUniformLocation(Scale), 1, values);
+        }
     }
 }
 
@@ -485,12 +528,16 @@ void MCGLShaderProgram::setPendingDiffuseLight()
 {
     if (m_diffuseLightPending) {
         m_diffuseLightPending = false;
-        glUniform4f(
-            getUniformLocation(DiffuseLightDir),
-                m_diffuseLight.direction().i(), m_diffuseLight.direction().j(), m_diffuseLight.direction().k(), 1);
-        glUniform4f(
-            getUniformLocation(DiffuseLightColor),
-                m_diffuseLight.r(), m_diffuseLight.g(), m_diffuseLight.b(), m_diffuseLight.i());
+        const GLfloat direction[] = {
+            m_diffuseLight.direction().i(), m_diffuseLight.direction().j(), m_diffuseLight.direction().k(), 1};
+        if (uniformChanged(DiffuseLightDir, direction, 4)) {
+            glUniform4fv(getUniformLocation(DiffuseLightDir), 1, direction);
+        }
+
+        const GLfloat color[] = {m_diffuseLight.r(), m_diffuseLight.g(), m_diffuseLight.b(), m_diffuseLight.i()};
+        if (uniformChanged(DiffuseLightColor, color, 4)) {
+            glUniform4fv(getUniformLocation(DiffuseLightColor), 1, color);
+        }
     }
 }
 
@@ -508,12 +555,16 @@ void MCGLShaderProgram::setPendingSpecularLight()
 {
     if (m_specularLightPending) {
         m_specularLightPending = false;
-        glUniform4f(
-            getUniformLocation(SpecularLightDir),
-                m_specularLight.direction().i(), m_specularLight.direction().j(), m_specularLight.direction().k(), 1);
-        glUniform4f(
-            getUniformLocation(SpecularLightColor),
-                m_specularLight.r(), m_specularLight.g(), m_specularLight.b(), m_specularLight.i());
+        const GLfloat direction[] = {
+            m_specularLight.direction().i(), m_specularLight.direction().j(), m_specularLight.direction().k(), 1};
+        if (uniformChanged(SpecularLightDir, direction, 4)) {
+            glUniform4fv(getUniformLocation(SpecularLightDir), 1, direction);
+        }
+
+        const GLfloat color[] = {m_specularLight.r(), m_specularLight.g(), m_specularLight.b(), m_specularLight.i()};
+        if (uniformChanged(SpecularLightColor, color, 4)) {
+            glUniform4fv(getUniformLocation(SpecularLightColor), 1, color);
+        }
     }
 }
 
@@ -531,9 +582,10 @@ void MCGLShaderProgram::setPendingAmbientLight()
 {
     if (m_ambientLightPending) {
         m_ambientLightPending = false;
-        glUniform4f(
-            getUniformLocation(AmbientLightColor),
-                m_ambientLight.r(), m_ambientLight.g(), m_ambientLight.b(), m_ambientLight.i());
+        const GLfloat color[] = {m_ambientLight.r(), m_ambientLight.g(), m_ambientLight.b(), m_ambientLight.i()};
+        if (uniformChanged(AmbientLightColor, color, 4)) {
+            glUniform4fv(getUniformLocation(AmbientLightColor), 1, color);
+        }
     }
 }
 
@@ -551,7 +603,10 @@ void MCGLShaderProgram::setPendingFadeValue()
 {
     if (m_fadeValuePending) {
         m_fadeValuePending = false;
-        glUniform1f(getUniformLocation(Fade), m_fadeValue);
+        const GLfloat values[] = {m_fadeValue};
+        if (uniformChanged(Fade, values, 1)) {
+            glUniform1fv(getUniformLocation(Fade), 1, values);
+        }
     }
 }
 
@@ -560,7 +615,8 @@ void MCGLShaderProgram::bindTextureUnit(GLuint index, Uniform uniform)
     const int location = getUniformLocation(uniform);
     if (location != -1)
     {
-        glUniform1i(getUniformLocation(uniform), index);
+        glUniform1i(location, index);
+        m_scene.stateCache().countCalls();
     }
 }
 
@@ -585,15 +641,16 @@ void MCGLShaderProgram::bindPendingMaterial()
         const GLuint texture2 = m_material->texture(1);
         const GLuint texture3 = m_material->texture(2);
 
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture1);
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, texture2);
-        glActiveTexture(GL_TEXTURE2);
-        glBindTexture(GL_TEXTURE_2D, texture3);
+        MCGLStateCache & stateCache = m_scene.stateCache();
+        stateCache.bindTexture(0, texture1);
+        stateCache.bindTexture(1, texture2);
+        stateCache.bindTexture(2, texture3);
 
-        glActiveTexture(GL_TEXTURE0);
+        stateCache.setActiveTextureUnit(0);
 
-        glUniform1f(getUniformLocation(SpecularCoeff), m_material->specularCoeff());
+        const GLfloat specularCoeff[] = {m_material->specularCoeff()};
+        if (uniformChanged(SpecularCoeff, specularCoeff, 1)) {
+            glUniform1fv(getUniformLocation(SpecularCoeff), 1, specularCoeff);
+        }
     }
 }
@@ -191,6 +191,14 @@ private:
         Camera,
         UserData1,
         UserData2,
+        UniformCount
+    };
+
+    //! Last values uploaded to a uniform
+    struct UniformValue
+    {
+        bool    valid;
+        GLfloat data[16];
     };
 
     void bindPendingMaterial();
@@ -201,10 +209,13 @@ private:
 
     int getUniformLocation(Uniform uniform);
 
-    void initUniformNameMap();
-
     void initUniformLocationCache();
 
+    /*! Store the given uniform values if they differ from the previously
+     *  uploaded ones.
+     *  \return true if the values need to be uploaded. */
+    bool uniformChanged(Uniform uniform, const GLfloat * values, int count);
+
     void setPendingAmbientLight();
 
     void setPendingCamera();
@@ -235,11 +246,9 @@ private:
 
     static std::vector<MCGLShaderProgram *> m_programStack;
 
-    typedef std::map<Uniform, int> UniformLocationHash;
-    UniformLocationHash m_uniformLocationHash;
+    GLint m_uniformLocations[UniformCount];
 
-    typedef std::map<Uniform, std::string> Uniforms;
-    Uniforms m_uniforms;
+    UniformValue m_uniformValues[UniformCount];
 
     MCGLScene & m_scene;
 
@@ -0,0 +1,203 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcglstatecache.hh"
+
+#include <cassert>
+
+MCGLStateCache::MCGLStateCache()
+{
+    invalidate();
+}
+
+void MCGLStateCache::initialize()
+{
+#ifdef __MC_QOPENGLFUNCTIONS__
+    initializeOpenGLFunctions();
+#endif
+    invalidate();
+}
+
+void MCGLStateCache::useProgram(GLuint program)
+{
+    if (m_program != static_cast<GLint>(program))
+    {
+        m_program = program;
+        glUseProgram(program);
+        m_stats.calls++;
+    }
+    else
+    {
+        m_stats.skippedCalls++;
+    }
+}
+
+void MCGLStateCache::setBlendEnabled(bool enable)
+{
+    if (m_blend != enable)
+    {
+        m_blend = enable;
+        enable ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+        m_stats.calls++;
+    }
+    else
+    {
+        m_stats.skippedCalls++;
+    }
+}
+
+void MCGLStateCache::setBlendFunc(GLenum src, GLenum dst)
+{
+    if (m_blendSrc != static_cast<GLint>(src) || m_blendDst != static_cast<GLint>(dst))
+    {
+        m_blendSrc = src;
+        m_blendDst = dst;
+        glBlendFunc(src, dst);
+        m_stats.calls++;
+    }
+    else
+    {
+        m_stats.skippedCalls++;
+    }
+}
+
+void MCGLStateCache::setDepthTestEnabled(bool enable)
+{
+    if (m_depthTest != enable)
+    {
+        m_depthTest = enable;
+        enable ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+        m_stats.calls++;
+    }
+    else
+    {
+        m_stats.skippedCalls++;
+    }
+}
+
+void MCGLStateCache::setDepthMaskEnabled(bool enable)
+{
+    if (m_depthMask != enable)
+    {
+        m_depthMask = enable;
+        glDepthMask(enable ? GL_TRUE : GL_FALSE);
+        m_stats.calls++;
+    }
+    else
+    {
+        m_stats.skippedCalls++;
+    }
+}
+
+void MCGLStateCache::setActiveTextureUnit(GLuint unit)
+{
+    assert(unit < MAX_TEXTURE_UNITS);
+
+    if (m_activeTextureUnit != static_cast<GLint>(unit))
+    {
+        m_activeTextureUnit = unit;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_stats.calls++;
+    }
+    else
+    {
+        m_stats.skippedCalls++;
+    }
+}
+
+void MCGLStateCache::bindTexture(GLuint unit, GLuint texture)
+{
+    assert(unit < MAX_TEXTURE_UNITS);
+
+    setActiveTextureUnit(unit);
+
+    if (m_textures[unit] != static_cast<GLint>(texture))
+    {
+        m_textures[unit] = texture;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        m_stats.calls++;
+    }
+    else
+    {
+        m_stats.skippedCalls++;
+    }
+}
+
+void MCGLStateCache::countCalls(unsigned int calls)
+{
+    m_stats.calls += calls;
+}
+
+void MCGLStateCache::countSkippedCalls(unsigned int calls)
+{
+    m_stats.skippedCalls += calls;
+}
+
+void MCGLStateCache::countDrawCall()
+{
+    m_stats.calls++;
+    m_stats.drawCalls++;
+}
+
+void MCGLStateCache::countBufferUpload()
+{
+    m_stats.calls++;
+    m_stats.bufferUploads++;
+}
+
+void MCGLStateCache::countVertexArrayBind()
+{
+    m_stats.calls++;
+    m_stats.vertexArrayBinds++;
+}
+
+void MCGLStateCache::countBufferBind()
+{
+    m_stats.calls++;
+    m_stats.bufferBinds++;
+}
+
+void MCGLStateCache::invalidate()
+{
+    m_program           = UNKNOWN;
+    m_blend             = UNKNOWN;
+    m_blendSrc          = UNKNOWN;
+    m_blendDst          = UNKNOWN;
+    m_depthTest         = UNKNOWN;
+    m_depthMask         = UNKNOWN;
+    m_activeTextureUnit = UNKNOWN;
+
+    for (GLint & texture : m_textures)
+    {
+        texture = UNKNOWN;
+    }
+}
+
+void MCGLStateCache::beginFrame()
+{
+    m_lastFrameStats = m_stats;
+    m_stats          = Stats();
+
+    invalidate();
+}
+
+const MCGLStateCache::Stats & MCGLStateCache::lastFrameStats() const
+{
+    return m_lastFrameStats;
+}
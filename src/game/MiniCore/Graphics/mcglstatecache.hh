@@ -0,0 +1,151 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCGLSTATECACHE_HH
+#define MCGLSTATECACHE_HH
+
+#include <MCGLEW>
+
+#include "mcmacros.hh"
+
+/*! Shadow copy of the GL state that MiniCore toggles frequently: the
+ *  bound program, blending, depth test, depth mask and texture bindings.
+ *  Calls that wouldn't change the state are filtered out. All code that
+ *  changes these states while rendering must go thru the cache, or call
+ *  invalidate() afterwards. The cache also counts the GL calls issued
+ *  per frame, including draw calls, buffer uploads and VAO / VBO binds
+ *  that are reported to it. The instance is owned by MCGLScene. */
+#ifdef __MC_QOPENGLFUNCTIONS__
+#include <QOpenGLFunctions>
+class MCGLStateCache : protected QOpenGLFunctions
+#else
+class MCGLStateCache
+#endif
+{
+public:
+
+    //! GL call statistics of a frame.
+    struct Stats
+    {
+        //! Number of GL calls issued.
+        unsigned int calls = 0;
+
+        //! Number of redundant GL calls filtered out.
+        unsigned int skippedCalls = 0;
+
+        //! Number of draw calls.
+        unsigned int drawCalls = 0;
+
+        //! Number of buffer data uploads.
+        unsigned int bufferUploads = 0;
+
+        //! Number of VAO binds.
+        unsigned int vertexArrayBinds = 0;
+
+        //! Number of VBO binds.
+        unsigned int bufferBinds = 0;
+    };
+
+    //! Maximum number of tracked texture units.
+    static const int MAX_TEXTURE_UNITS = 8;
+
+    //! Constructor.
+    MCGLStateCache();
+
+    //! Initialize GL functions. A GL context must be current.
+    void initialize();
+
+    //! Use the given shader program.
+    void useProgram(GLuint program);
+
+    //! Enable / disable GL_BLEND.
+    void setBlendEnabled(bool enable);
+
+    //! Set blend function.
+    void setBlendFunc(GLenum src, GLenum dst);
+
+    //! Enable / disable GL_DEPTH_TEST.
+    void setDepthTestEnabled(bool enable);
+
+    //! Enable / disable writing to the depth buffer.
+    void setDepthMaskEnabled(bool enable);
+
+    //! Bind a 2D texture to the given texture unit and leave that unit active.
+    void bindTexture(GLuint unit, GLuint texture);
+
+    //! Set the active texture unit.
+    void setActiveTextureUnit(GLuint unit);
+
+    //! Record GL calls issued outside the cache, e.g. uniform uploads.
+    void countCalls(unsigned int calls = 1);
+
+    //! Record redundant GL calls filtered out outside the cache.
+    void countSkippedCalls(unsigned int calls = 1);
+
+    //! Record a draw call, e.g. glDrawArrays().
+    void countDrawCall();
+
+    //! Record a buffer upload, e.g. glBufferData() or glBufferSubData().
+    void countBufferUpload();
+
+    //! Record a VAO bind or release.
+    void countVertexArrayBind();
+
+    //! Record a VBO bind or release.
+    void countBufferBind();
+
+    //! Forget the cached state e.g. after foreign code has changed it.
+    void invalidate();
+
+    /*! Start a new frame: the counters of the finished frame are stored
+     *  to lastFrameStats() and the cached state is invalidated. */
+    void beginFrame();
+
+    //! \return GL call statistics of the previous frame.
+    const Stats & lastFrameStats() const;
+
+private:
+
+    DISABLE_COPY(MCGLStateCache);
+    DISABLE_ASSI(MCGLStateCache);
+
+    static const GLint UNKNOWN = -1;
+
+    GLint m_program;
+
+    GLint m_blend;
+
+    GLint m_blendSrc;
+
+    GLint m_blendDst;
+
+    GLint m_depthTest;
+
+    GLint m_depthMask;
+
+    GLint m_activeTextureUnit;
+
+    GLint m_textures[MAX_TEXTURE_UNITS];
+
+    Stats m_stats;
+
+    Stats m_lastFrameStats;
+};
+
+#endif // MCGLSTATECACHE_HH
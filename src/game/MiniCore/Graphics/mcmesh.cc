@@ -21,6 +21,7 @@
 
 #include "mccamera.hh"
 #include "mcbbox.hh"
+#include "mcglscene.hh"
 #include "mcglshaderprogram.hh"
 #include "mcglvertex.hh"
 #include "mcgltexcoord.hh"
@@ -46,7 +47,20 @@ MCMesh::MCMesh(const FaceVector & faces, MCGLMaterialPtr material)
     setMaterial(material);
 }
 
-void MCMesh::init(const FaceVector & faces)
+MCMesh::MCMesh(const FaceVector & faces)
+: m_w(1.0)
+, m_h(1.0)
+, m_minZ(0)
+, m_maxZ(0)
+, m_color(1.0, 1.0, 1.0, 1.0)
+, m_sx(1.0)
+, m_sy(1.0)
+, m_sz(1.0)
+{
+    init(faces, true);
+}
+
+void MCMesh::init(const FaceVector & faces, bool geometryOnly)
 {
     const int NUM_FACES = static_cast<int>(faces.size());
     m_numVertices = NUM_FACES * 3; // Only triagles accepted
@@ -109,6 +123,14 @@ void MCMesh::init(const FaceVector & faces)
     m_minZ = minZ;
     m_maxZ = maxZ;
 
+    if (geometryOnly)
+    {
+        delete [] vertices;
+        delete [] normals;
+        delete [] texCoords;
+        return;
+    }
+
     GLfloat * colors = new GLfloat[m_numVertices * NUM_COLOR_COMPONENTS];
     for (int colorIndex = 0; colorIndex < m_numVertices * NUM_COLOR_COMPONENTS; colorIndex++)
     {
@@ -153,6 +175,7 @@ void MCMesh::initVBOs(
 void MCMesh::render()
 {
     glDrawArrays(GL_TRIANGLES, 0, m_numVertices);
+    MCGLScene::instance().stateCache().countDrawCall();
 }
 
 void MCMesh::setColor(const MCGLColor & color)
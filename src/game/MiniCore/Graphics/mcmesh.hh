@@ -63,6 +63,10 @@ public:
     //! Constructor.
     explicit MCMesh(const FaceVector & faces, MCGLMaterialPtr material);
 
+    /*! Constructor for a geometry-only mesh. Dimensions are calculated,
+     *  but no GL buffers are created, so the mesh can't be rendered. */
+    explicit MCMesh(const FaceVector & faces);
+
     //! Destructor.
     virtual ~MCMesh() {};
 
@@ -102,7 +106,7 @@ public:
 
 private:
 
-    void init(const FaceVector & faces);
+    void init(const FaceVector & faces, bool geometryOnly = false);
 
     void initVBOs(
         const MCGLVertex   * vertices,
@@ -29,6 +29,7 @@ MCParticle::MCParticle(const std::string & typeID)
 , m_animationStyle(MCParticle::None)
 , m_isActive(false)
 , m_dieWhenOffScreen(true)
+, m_isSurfaceParticle(false)
 , m_scale(1.0)
 , m_delta(0.0)
 , m_freeList(nullptr)
@@ -113,6 +114,16 @@ bool MCParticle::dieWhenOffScreen() const
     return m_dieWhenOffScreen;
 }
 
+void MCParticle::setIsSurfaceParticle(bool flag)
+{
+    m_isSurfaceParticle = flag;
+}
+
+bool MCParticle::isSurfaceParticle() const
+{
+    return m_isSurfaceParticle;
+}
+
 void MCParticle::onStepTime(MCFloat /* step */)
 {
     if (m_lifeTime > 0)
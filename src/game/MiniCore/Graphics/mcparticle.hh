@@ -87,6 +87,10 @@ public:
 
   bool dieWhenOffScreen() const;
 
+  /*! \return true if the particle is an MCSurfaceParticle. Lets the renderer
+   *  pick the particle renderer without a dynamic_cast. */
+  bool isSurfaceParticle() const;
+
   //! \reimp
   virtual void onStepTime(MCFloat step) override;
 
@@ -109,6 +113,9 @@ protected:
    */
   virtual void timeOut();
 
+  //! Set by MCSurfaceParticle.
+  void setIsSurfaceParticle(bool flag);
+
 private:
 
   static int m_numActiveParticles;
@@ -126,6 +133,8 @@ private:
 
   bool m_dieWhenOffScreen;
 
+  bool m_isSurfaceParticle;
+
   MCFloat m_scale;
 
   MCFloat m_delta;
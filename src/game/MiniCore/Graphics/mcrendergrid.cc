@@ -0,0 +1,202 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcrendergrid.hh"
+#include "mcobject.hh"
+#include "mcshape.hh"
+#include "mcshapeview.hh"
+
+#include <algorithm>
+#include <cmath>
+
+MCRenderGrid::MCRenderGrid()
+    : m_x1(0)
+    , m_y1(0)
+    , m_horSize(1)
+    , m_verSize(1)
+    , m_helpHor(0)
+    , m_helpVer(0)
+    , m_maxExtent(0)
+    , m_count(0)
+    , m_cells(1)
+{
+}
+
+void MCRenderGrid::setDimensions(
+    MCFloat x1, MCFloat y1, MCFloat x2, MCFloat y2, MCUint horSize, MCUint verSize)
+{
+    ObjectVector objects;
+    objects.reserve(m_count);
+    for (auto && cell : m_cells)
+    {
+        objects.insert(objects.end(), cell.begin(), cell.end());
+    }
+
+    removeAll();
+
+    m_x1 = x1;
+    m_y1 = y1;
+    m_horSize = std::max(horSize, 1u);
+    m_verSize = std::max(verSize, 1u);
+    m_helpHor = x2 > x1 ? m_horSize / (x2 - x1) : 0;
+    m_helpVer = y2 > y1 ? m_verSize / (y2 - y1) : 0;
+    m_cells.clear();
+    m_cells.resize(m_horSize * m_verSize);
+
+    for (MCObject * object : objects)
+    {
+        insert(*object);
+    }
+}
+
+MCUint MCRenderGrid::clampedHorIndex(MCFloat x) const
+{
+    const int i = static_cast<int>((x - m_x1) * m_helpHor);
+    return i < 0 ? 0 : std::min(static_cast<MCUint>(i), m_horSize - 1);
+}
+
+MCUint MCRenderGrid::clampedVerIndex(MCFloat y) const
+{
+    const int j = static_cast<int>((y - m_y1) * m_helpVer);
+    return j < 0 ? 0 : std::min(static_cast<MCUint>(j), m_verSize - 1);
+}
+
+MCUint MCRenderGrid::cellIndex(MCFloat x, MCFloat y) const
+{
+    return clampedVerIndex(y) * m_horSize + clampedHorIndex(x);
+}
+
+MCFloat MCRenderGrid::extent(MCObject & object)
+{
+    // Match the bboxes MCWorldRenderer tests: particles are tested with their
+    // shape and other objects with their view. Objects without either are not
+    // rendered, so e.g. the huge world walls don't widen all queries.
+    MCFloat result = 0;
+    if (MCShapePtr shape = object.shape())
+    {
+        if (object.isParticle())
+        {
+            result = shape->radius();
+        }
+        else if (shape->view())
+        {
+            const MCBBox3dF bbox(shape->view()->bbox());
+            result = std::max(result, std::fabs(bbox.x1()));
+            result = std::max(result, std::fabs(bbox.x2()));
+            result = std::max(result, std::fabs(bbox.y1()));
+            result = std::max(result, std::fabs(bbox.y2()));
+        }
+    }
+    return result;
+}
+
+void MCRenderGrid::insert(MCObject & object)
+{
+    if (object.m_renderGridIndex >= 0)
+    {
+        return;
+    }
+
+    const MCUint index = cellIndex(object.location().i(), object.location().j());
+    m_cells[index].push_back(&object);
+    object.m_renderGridIndex = static_cast<int>(index);
+    m_maxExtent = std::max(m_maxExtent, extent(object));
+    m_count++;
+}
+
+void MCRenderGrid::removeFromCell(MCObject & object)
+{
+    ObjectVector & cell = m_cells[object.m_renderGridIndex];
+    const auto iter(std::find(cell.begin(), cell.end(), &object));
+    if (iter != cell.end())
+    {
+        // Order doesn't matter: swap with the last one and pop.
+        *iter = cell.back();
+        cell.pop_back();
+    }
+}
+
+void MCRenderGrid::remove(MCObject & object)
+{
+    if (object.m_renderGridIndex >= 0)
+    {
+        removeFromCell(object);
+        object.m_renderGridIndex = -1;
+        m_count--;
+    }
+}
+
+void MCRenderGrid::update(MCObject & object)
+{
+    if (object.m_renderGridIndex >= 0)
+    {
+        const MCUint index = cellIndex(object.location().i(), object.location().j());
+        if (static_cast<int>(index) != object.m_renderGridIndex)
+        {
+            removeFromCell(object);
+            m_cells[index].push_back(&object);
+            object.m_renderGridIndex = static_cast<int>(index);
+        }
+
+        m_maxExtent = std::max(m_maxExtent, extent(object));
+    }
+}
+
+void MCRenderGrid::removeAll()
+{
+    for (auto && cell : m_cells)
+    {
+        for (MCObject * object : cell)
+        {
+            object->m_renderGridIndex = -1;
+        }
+        cell.clear();
+    }
+
+    m_maxExtent = 0;
+    m_count = 0;
+}
+
+void MCRenderGrid::getObjectsWithinBBox(const MCBBox<MCFloat> & bbox, ObjectVector & result) const
+{
+    result.clear();
+
+    // An object is found via its location, but its view can reach m_maxExtent
+    // further. MCCamera::isVisible() also widens the camera by half the size
+    // of the tested bbox, so the margin is doubled.
+    const MCFloat margin = 2 * m_maxExtent;
+    const MCUint i0 = clampedHorIndex(bbox.x1() - margin);
+    const MCUint i1 = clampedHorIndex(bbox.x2() + margin);
+    const MCUint j0 = clampedVerIndex(bbox.y1() - margin);
+    const MCUint j1 = clampedVerIndex(bbox.y2() + margin);
+
+    for (MCUint j = j0; j <= j1; j++)
+    {
+        for (MCUint i = i0; i <= i1; i++)
+        {
+            const ObjectVector & cell = m_cells[j * m_horSize + i];
+            result.insert(result.end(), cell.begin(), cell.end());
+        }
+    }
+}
+
+MCUint MCRenderGrid::count() const
+{
+    return m_count;
+}
@@ -0,0 +1,95 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCRENDERGRID_HH
+#define MCRENDERGRID_HH
+
+#include "mcbbox.hh"
+#include "mcmacros.hh"
+#include "mctypes.hh"
+
+#include <vector>
+
+class MCObject;
+
+/*! Render-side spatial index used by MCWorldRenderer to find the objects
+ *  near a camera without scanning all render layers. Unlike MCObjectGrid,
+ *  every renderable object is stored, each in exactly one cell that
+ *  contains its location. Queries are widened by the largest object extent
+ *  seen, so the result is a superset of the objects whose view or shape
+ *  overlaps the given bbox. Locations outside the grid are clamped to
+ *  the border cells. */
+class MCRenderGrid
+{
+public:
+
+    typedef std::vector<MCObject *> ObjectVector;
+
+    //! Constructor. The grid has a single cell until setDimensions().
+    MCRenderGrid();
+
+    /*! Set the covered area and re-index the current objects.
+     *  \param horSize,verSize are the number of cells. */
+    void setDimensions(
+        MCFloat x1, MCFloat y1, MCFloat x2, MCFloat y2, MCUint horSize, MCUint verSize);
+
+    //! Insert an object (O(1)).
+    void insert(MCObject & object);
+
+    //! Remove an object (O(cell size)).
+    void remove(MCObject & object);
+
+    //! Move the object to the cell of its current location.
+    void update(MCObject & object);
+
+    //! Remove all objects.
+    void removeAll();
+
+    /*! Get the objects that may overlap the given bbox. The result is
+     *  cleared first, so keep passing the same vector to avoid allocations. */
+    void getObjectsWithinBBox(const MCBBox<MCFloat> & bbox, ObjectVector & result) const;
+
+    //! \return number of indexed objects.
+    MCUint count() const;
+
+private:
+
+    DISABLE_COPY(MCRenderGrid);
+    DISABLE_ASSI(MCRenderGrid);
+
+    MCUint cellIndex(MCFloat x, MCFloat y) const;
+
+    MCUint clampedHorIndex(MCFloat x) const;
+
+    MCUint clampedVerIndex(MCFloat y) const;
+
+    //! \return distance from the location the object can reach.
+    static MCFloat extent(MCObject & object);
+
+    void removeFromCell(MCObject & object);
+
+    MCFloat m_x1, m_y1;
+    MCUint m_horSize, m_verSize;
+    MCFloat m_helpHor, m_helpVer;
+    MCFloat m_maxExtent;
+    MCUint m_count;
+    std::vector<ObjectVector> m_cells;
+};
+
+#endif // MCRENDERGRID_HH
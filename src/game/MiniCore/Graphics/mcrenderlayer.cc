@@ -21,6 +21,8 @@
 #include "mccamera.hh"
 #include "mcobject.hh"
 
+#include <algorithm>
+
 MCRenderLayer::MCRenderLayer()
     : m_depthTestEnabled(true)
     , m_depthMaskEnabled(true)
@@ -30,8 +32,8 @@ MCRenderLayer::MCRenderLayer()
 void MCRenderLayer::clear()
 {
     m_objectSet.clear();
-    m_objectBatches.clear();
-    m_particleBatches.clear();
+    m_cameras.clear();
+    m_cameraBatches.clear();
 }
 
 void MCRenderLayer::setDepthTestEnabled(bool enable)
@@ -59,12 +61,65 @@ MCRenderLayer::ObjectSet & MCRenderLayer::objectSet()
     return m_objectSet;
 }
 
-MCRenderLayer::CameraBatchMap & MCRenderLayer::objectBatches()
+MCRenderLayer::CameraBatches & MCRenderLayer::cameraBatches(MCCamera * camera)
+{
+    // There are only a few cameras, so a linear search is the fastest.
+    const auto iter(std::find(m_cameras.begin(), m_cameras.end(), camera));
+    if (iter != m_cameras.end())
+    {
+        return m_cameraBatches[iter - m_cameras.begin()];
+    }
+
+    m_cameras.push_back(camera);
+    m_cameraBatches.push_back(CameraBatches());
+    return m_cameraBatches.back();
+}
+
+MCRenderLayer::BatchArray & MCRenderLayer::objectBatches(MCCamera * camera)
+{
+    return cameraBatches(camera).objectBatches;
+}
+
+MCRenderLayer::BatchArray & MCRenderLayer::particleBatches(MCCamera * camera)
+{
+    return cameraBatches(camera).particleBatches;
+}
+
+void MCRenderLayer::BatchArray::add(MCObject & object)
+{
+    const ObjectTypeId typeId = static_cast<ObjectTypeId>(object.typeID());
+    if (typeId >= static_cast<ObjectTypeId>(m_batches.size()))
+    {
+        m_batches.resize(typeId + 1);
+    }
+
+    Batch & batch = m_batches[typeId];
+    if (batch.empty())
+    {
+        // Keep the ids sorted so that the batches are rendered in the same
+        // order every frame.
+        m_typeIds.insert(std::upper_bound(m_typeIds.begin(), m_typeIds.end(), typeId), typeId);
+    }
+
+    batch.push_back(&object);
+}
+
+void MCRenderLayer::BatchArray::clear()
+{
+    for (ObjectTypeId typeId : m_typeIds)
+    {
+        m_batches[typeId].clear();
+    }
+
+    m_typeIds.clear();
+}
+
+const std::vector<MCRenderLayer::ObjectTypeId> & MCRenderLayer::BatchArray::typeIds() const
 {
-    return m_objectBatches;
+    return m_typeIds;
 }
 
-MCRenderLayer::CameraBatchMap & MCRenderLayer::particleBatches()
+MCRenderLayer::BatchArray::Batch & MCRenderLayer::BatchArray::batch(ObjectTypeId typeId)
 {
-    return m_particleBatches;
+    return m_batches[typeId];
 }
@@ -20,7 +20,6 @@
 #ifndef MCRENDERLAYER_HH
 #define MCRENDERLAYER_HH
 
-#include <map>
 #include <unordered_set>
 #include <vector>
 
@@ -48,24 +47,60 @@ public:
     ObjectSet & objectSet();
 
     typedef int ObjectTypeId;
-    typedef std::map<ObjectTypeId, std::vector<MCObject *> > BatchMap;
-    typedef std::map<MCCamera *, BatchMap> CameraBatchMap;
 
-    CameraBatchMap & objectBatches();
+    /*! Objects grouped into batches by their type id. The batches are
+     *  addressed by the (dense) type id and kept between frames, so after
+     *  the first frames clear() and add() don't allocate. */
+    class BatchArray
+    {
+    public:
 
-    CameraBatchMap & particleBatches();
+        typedef std::vector<MCObject *> Batch;
+
+        //! Add object to the batch of its type.
+        void add(MCObject & object);
+
+        //! Empty all batches. The capacity is kept.
+        void clear();
+
+        //! \return ids of the non-empty batches in ascending order.
+        const std::vector<ObjectTypeId> & typeIds() const;
+
+        //! \return batch of the given type.
+        Batch & batch(ObjectTypeId typeId);
+
+    private:
+
+        std::vector<Batch> m_batches;
+
+        std::vector<ObjectTypeId> m_typeIds;
+    };
+
+    BatchArray & objectBatches(MCCamera * camera);
+
+    BatchArray & particleBatches(MCCamera * camera);
 
 private:
 
+    struct CameraBatches
+    {
+        BatchArray objectBatches;
+
+        BatchArray particleBatches;
+    };
+
+    //! \return batches of the given camera. Each camera gets a slot on first use.
+    CameraBatches & cameraBatches(MCCamera * camera);
+
     bool m_depthTestEnabled;
 
     bool m_depthMaskEnabled;
 
     ObjectSet m_objectSet;
 
-    CameraBatchMap m_objectBatches;
+    std::vector<MCCamera *> m_cameras;
 
-    CameraBatchMap m_particleBatches;
+    std::vector<CameraBatches> m_cameraBatches;
 };
 
 #endif // MCRENDERLAYER_HH
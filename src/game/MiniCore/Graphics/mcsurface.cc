@@ -21,6 +21,7 @@
 #include "mccamera.hh"
 #include "mcbbox.hh"
 #include "mcglmaterial.hh"
+#include "mcglscene.hh"
 #include "mcglshaderprogram.hh"
 #include "mcglvertex.hh"
 #include "mcgltexcoord.hh"
@@ -30,7 +31,7 @@
 #include <algorithm>
 #include <cassert>
 
-static const int NUM_VERTICES         = 6;
+static const int NUM_VERTICES         = MCSurface::NUM_VERTICES;
 static const int NUM_COLOR_COMPONENTS = 4;
 
 static const int VERTEX_DATA_SIZE     = sizeof(MCGLVertex)   * NUM_VERTICES;
@@ -162,6 +163,14 @@ MCSurface::MCSurface(
     initVBOs(vertices, normals, texCoordsAll, colors);
 }
 
+MCSurface::MCSurface(MCFloat width, MCFloat height, MCFloat z0, MCFloat z1, MCFloat z2, MCFloat z3)
+{
+    init(MCGLMaterialPtr(), width, height);
+
+    m_minZ = std::min(std::min(z0, z1), std::min(z2, z3));
+    m_maxZ = std::max(std::max(z0, z1), std::max(z2, z3));
+}
+
 void MCSurface::init(MCGLMaterialPtr material, MCFloat width, MCFloat height)
 {
     setMaterial(material);
@@ -189,6 +198,10 @@ void MCSurface::initVBOs(
     const MCGLTexCoord * texCoords,
     const MCGLColor    * colors)
 {
+    std::copy(vertices, vertices + NUM_VERTICES, m_vertices);
+    std::copy(normals, normals + NUM_VERTICES, m_normals);
+    std::copy(texCoords, texCoords + NUM_VERTICES, m_texCoords);
+
     initBufferData(TOTAL_DATA_SIZE, GL_STATIC_DRAW);
 
     addBufferSubData(
@@ -220,8 +233,9 @@ void MCSurface::doAlphaBlend()
 {
     if (m_useAlphaBlend)
     {
-        glEnable(GL_BLEND);
-        glBlendFunc(m_src, m_dst);
+        MCGLStateCache & stateCache = MCGLScene::instance().stateCache();
+        stateCache.setBlendEnabled(true);
+        stateCache.setBlendFunc(m_src, m_dst);
     }
 }
 
@@ -241,6 +255,9 @@ void MCSurface::setTexCoords(const MCGLTexCoord texCoords[4])
 
     glBufferSubData(
         GL_ARRAY_BUFFER, VERTEX_DATA_SIZE + NORMAL_DATA_SIZE, TEXCOORD_DATA_SIZE, texCoordsAll);
+    MCGLScene::instance().stateCache().countBufferUpload();
+
+    std::copy(texCoordsAll, texCoordsAll + NUM_VERTICES, m_texCoords);
 }
 
 void MCSurface::setColor(const MCGLColor & color)
@@ -279,7 +296,7 @@ void MCSurface::release()
 
     if (m_useAlphaBlend)
     {
-        glDisable(GL_BLEND);
+        MCGLScene::instance().stateCache().setBlendEnabled(false);
     }
 }
 
@@ -290,6 +307,7 @@ void MCSurface::releaseShadow()
 void MCSurface::render()
 {
     glDrawArrays(GL_TRIANGLES, 0, NUM_VERTICES);
+    MCGLScene::instance().stateCache().countDrawCall();
 }
 
 void MCSurface::render(MCCamera * camera, MCVector3dFR pos, MCFloat angle, bool autoBind)
@@ -389,3 +407,38 @@ MCVector2dF MCSurface::center() const
 {
     return m_center;
 }
+
+MCVector2dF MCSurface::centerTranslation() const
+{
+    if (m_centerSet)
+    {
+        return MCVector2dF(m_w2 - m_center.i(), m_h2 - m_center.j());
+    }
+
+    return MCVector2dF();
+}
+
+const MCGLColor & MCSurface::color() const
+{
+    return m_color;
+}
+
+bool MCSurface::useAlphaBlend() const
+{
+    return m_useAlphaBlend;
+}
+
+const MCGLVertex * MCSurface::vertices() const
+{
+    return m_vertices;
+}
+
+const MCGLVertex * MCSurface::normals() const
+{
+    return m_normals;
+}
+
+const MCGLTexCoord * MCSurface::texCoords() const
+{
+    return m_texCoords;
+}
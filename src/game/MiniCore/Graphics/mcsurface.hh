@@ -28,6 +28,8 @@
 #include "mcglcolor.hh"
 #include "mcglobjectbase.hh"
 #include "mcglmaterial.hh"
+#include "mcgltexcoord.hh"
+#include "mcglvertex.hh"
 #include "mcvector2d.hh"
 #include "mcvector3d.hh"
 
@@ -36,8 +38,6 @@
 
 class  MCCamera;
 class  MCGLShaderProgram;
-struct MCGLTexCoord;
-class  MCGLVertex;
 
 /*! MCSurface is a (2D) renderable object bound to an OpenGL texture handle.
  *  MCSurface can be rendered as a standalone object. Despite being a
@@ -47,6 +47,9 @@ class MCSurface : public MCGLObjectBase
 {
 public:
 
+    //! Number of vertices (two triangles) in the vertex buffer.
+    static const int NUM_VERTICES = 6;
+
     /*! Constructor.
      *  \param width  Desired width of the surface when rendered 1:1.
      *  \param height Desired height of the surface when rendered 1:1.
@@ -72,6 +75,17 @@ public:
         MCGLMaterialPtr material, MCFloat width, MCFloat height,
         const MCGLTexCoord texCoords[4]);
 
+    /*! Constructor for a geometry-only surface. No material is set and
+     *  no GL buffers are created, so the surface can't be rendered, but it
+     *  can be used to size shapes and objects without an OpenGL context.
+     *  \param width  Width of the surface.
+     *  \param height Height of the surface.
+     *  \param z0 Z-coordinate for vertex[0].
+     *  \param z1 Z-coordinate for vertex[1].
+     *  \param z2 Z-coordinate for vertex[2].
+     *  \param z3 Z-coordinate for vertex[3]. */
+    MCSurface(MCFloat width, MCFloat height, MCFloat z0, MCFloat z1, MCFloat z2, MCFloat z3);
+
     //! Destructor.
     virtual ~MCSurface() {};
 
@@ -133,6 +147,25 @@ public:
     //! Get center
     MCVector2dF center() const;
 
+    /*! Get the translation caused by a custom center.
+     *  \see setCenter(). */
+    MCVector2dF centerTranslation() const;
+
+    //! Get color.
+    const MCGLColor & color() const;
+
+    //! \return true if alpha blend is enabled.
+    bool useAlphaBlend() const;
+
+    //! Get the NUM_VERTICES vertices in the vertex buffer.
+    const MCGLVertex * vertices() const;
+
+    //! Get the NUM_VERTICES normals in the vertex buffer.
+    const MCGLVertex * normals() const;
+
+    //! Get the NUM_VERTICES texture coordinates in the vertex buffer.
+    const MCGLTexCoord * texCoords() const;
+
     //! \reimp
     virtual void bind() override;
 
@@ -171,6 +204,11 @@ private:
     GLenum      m_dst;
     MCGLColor   m_color;
     MCFloat     m_sx, m_sy, m_sz;
+
+    // Copies of the vertex buffer data for batch renderers
+    MCGLVertex   m_vertices[NUM_VERTICES];
+    MCGLVertex   m_normals[NUM_VERTICES];
+    MCGLTexCoord m_texCoords[NUM_VERTICES];
 };
 
 #endif // MCSURFACE_HH
@@ -0,0 +1,276 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "mcsurfaceobjectrenderer.hh"
+#include "mccamera.hh"
+#include "mcglscene.hh"
+#include "mcobject.hh"
+#include "mcshape.hh"
+#include "mcsurface.hh"
+#include "mcsurfaceview.hh"
+#include "mctrigonom.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <typeinfo>
+
+namespace {
+const int NUM_VERTICES_PER_OBJECT = MCSurface::NUM_VERTICES;
+}
+
+MCSurfaceObjectRenderer::MCSurfaceObjectRenderer(int maxBatchSize)
+    : m_maxBatchSize(maxBatchSize)
+    , m_batchSize(0)
+    , m_vertices(maxBatchSize * NUM_VERTICES_PER_OBJECT)
+    , m_normals(maxBatchSize * NUM_VERTICES_PER_OBJECT)
+    , m_texCoords(maxBatchSize * NUM_VERTICES_PER_OBJECT)
+    , m_colors(maxBatchSize * NUM_VERTICES_PER_OBJECT)
+{
+    const int NUM_VERTICES = maxBatchSize * NUM_VERTICES_PER_OBJECT;
+    const int VERTEX_DATA_SIZE = sizeof(MCGLVertex) * NUM_VERTICES;
+    const int NORMAL_DATA_SIZE = sizeof(MCGLVertex) * NUM_VERTICES;
+    const int TEXCOORD_DATA_SIZE = sizeof(MCGLTexCoord) * NUM_VERTICES;
+    const int COLOR_DATA_SIZE = sizeof(MCGLColor) * NUM_VERTICES;
+    const int TOTAL_DATA_SIZE = VERTEX_DATA_SIZE + NORMAL_DATA_SIZE + TEXCOORD_DATA_SIZE + COLOR_DATA_SIZE;
+
+    initBufferData(TOTAL_DATA_SIZE, GL_DYNAMIC_DRAW);
+
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Vertex, VERTEX_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_vertices.data()));
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Normal, NORMAL_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_normals.data()));
+    addBufferSubData(
+        MCGLShaderProgram::VAL_TexCoords, TEXCOORD_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_texCoords.data()));
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Color, COLOR_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_colors.data()));
+
+    finishBufferData();
+}
+
+bool MCSurfaceObjectRenderer::canRender(const ObjectVector & objects)
+{
+    if (!objects.size())
+    {
+        return false;
+    }
+
+    MCSurface * surface = nullptr;
+    MCGLShaderProgramPtr program;
+    for (MCObject * object : objects)
+    {
+        // Derived objects may re-implement render(), so accept only plain ones.
+        if (typeid(*object) != typeid(MCObject) || !object->shape())
+        {
+            return false;
+        }
+
+        MCShapeView * view = object->shape()->view().get();
+        if (!view || typeid(*view) != typeid(MCSurfaceView))
+        {
+            return false;
+        }
+
+        MCSurface * viewSurface = static_cast<MCSurfaceView *>(view)->surface();
+        if (!surface)
+        {
+            surface = viewSurface;
+            program = view->shaderProgram();
+
+            // The default shader gets the same result from pre-transformed
+            // vertices. Others may depend on the model matrix: e.g. the
+            // specular shader moves the normals with the model translation.
+            MCGLScene & scene = MCGLScene::instance();
+            if (!surface || !surface->material() ||
+                program != scene.defaultShaderProgram() ||
+                view->shadowShaderProgram() != scene.defaultShadowShaderProgram())
+            {
+                return false;
+            }
+        }
+        else if (viewSurface != surface || view->shaderProgram() != program)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void MCSurfaceObjectRenderer::setBatch(
+    const ObjectVector & objects, int begin, int end, MCCamera * camera, bool shadow)
+{
+    MCSurfaceView & view = static_cast<MCSurfaceView &>(*objects[begin]->shape()->view());
+    MCSurface & surface = *view.surface();
+
+    m_batchSize = end - begin;
+
+    const MCGLVertex * vertices = surface.vertices();
+    const MCGLVertex * normals = surface.normals();
+    const MCGLTexCoord * texCoords = surface.texCoords();
+    const MCVector2dF centerTranslation = surface.centerTranslation();
+
+    int vertexIndex = 0;
+    for (int i = begin; i < end; i++)
+    {
+        MCShape & shape = *objects[i]->shape();
+        const MCVector3dF location = shadow ? shape.location() + shape.shadowOffset() : shape.location();
+        const MCFloat angle = shape.angle();
+
+        MCFloat x = location.i();
+        MCFloat y = location.j();
+        const MCFloat z = location.k();
+
+        if (camera)
+        {
+            camera->mapToCamera(x, y);
+        }
+
+        x += centerTranslation.i();
+        y += centerTranslation.j();
+
+        const MCFloat cosAngle = MCTrigonom::cos(angle);
+        const MCFloat sinAngle = MCTrigonom::sin(angle);
+
+        for (int j = 0; j < NUM_VERTICES_PER_OBJECT; j++)
+        {
+            const MCGLVertex & vertex = vertices[j];
+            const MCGLVertex & normal = normals[j];
+
+            // The shadow shader flattens the vertices and takes Z from the transform.
+            m_vertices[vertexIndex] = MCGLVertex(
+                x + cosAngle * vertex.x() - sinAngle * vertex.y(),
+                y + sinAngle * vertex.x() + cosAngle * vertex.y(),
+                shadow ? 0 : z + vertex.z());
+
+            m_normals[vertexIndex] = MCGLVertex(
+                cosAngle * normal.x() - sinAngle * normal.y(),
+                sinAngle * normal.x() + cosAngle * normal.y(),
+                normal.z());
+
+            m_texCoords[vertexIndex] = texCoords[j];
+
+            m_colors[vertexIndex] = surface.color();
+
+            vertexIndex++;
+        }
+    }
+
+    const int NUM_VERTICES = m_batchSize * NUM_VERTICES_PER_OBJECT;
+    const int MAX_NUM_VERTICES = m_maxBatchSize * NUM_VERTICES_PER_OBJECT;
+
+    initUpdateBufferData();
+
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Vertex, sizeof(MCGLVertex) * NUM_VERTICES, sizeof(MCGLVertex) * MAX_NUM_VERTICES,
+        reinterpret_cast<const GLfloat *>(m_vertices.data()));
+
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Normal, sizeof(MCGLVertex) * NUM_VERTICES, sizeof(MCGLVertex) * MAX_NUM_VERTICES,
+        reinterpret_cast<const GLfloat *>(m_normals.data()));
+
+    addBufferSubData(
+        MCGLShaderProgram::VAL_TexCoords, sizeof(MCGLTexCoord) * NUM_VERTICES, sizeof(MCGLTexCoord) * MAX_NUM_VERTICES,
+        reinterpret_cast<const GLfloat *>(m_texCoords.data()));
+
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Color, sizeof(MCGLColor) * NUM_VERTICES,
+        reinterpret_cast<const GLfloat *>(m_colors.data()));
+}
+
+void MCSurfaceObjectRenderer::render(const ObjectVector & objects, MCCamera * camera)
+{
+    assert(canRender(objects));
+
+    MCSurfaceView & view = static_cast<MCSurfaceView &>(*objects[0]->shape()->view());
+    MCSurface & surface = *view.surface();
+
+    setShaderProgram(view.shaderProgram());
+    setMaterial(surface.material());
+
+    const int objectCount = static_cast<int>(objects.size());
+    for (int begin = 0; begin < objectCount; begin += m_maxBatchSize)
+    {
+        setBatch(objects, begin, std::min(begin + m_maxBatchSize, objectCount), camera, false);
+
+        shaderProgram()->bind();
+
+        surface.doAlphaBlend();
+
+        bindMaterial();
+
+        shaderProgram()->setTransform(0, MCVector3dF(0, 0, 0));
+        shaderProgram()->setScale(1.0f, 1.0f, 1.0f);
+        shaderProgram()->setColor(MCGLColor());
+
+        glDrawArrays(GL_TRIANGLES, 0, m_batchSize * NUM_VERTICES_PER_OBJECT);
+        MCGLScene::instance().stateCache().countDrawCall();
+
+        if (surface.useAlphaBlend())
+        {
+            MCGLScene::instance().stateCache().setBlendEnabled(false);
+        }
+
+        releaseVBO();
+        releaseVAO();
+    }
+}
+
+bool MCSurfaceObjectRenderer::renderShadows(const ObjectVector & objects, MCCamera * camera)
+{
+    assert(canRender(objects));
+
+    const MCFloat z = objects[0]->shape()->location().k() + objects[0]->shape()->shadowOffset().k();
+    for (MCObject * object : objects)
+    {
+        if (object->shape()->location().k() + object->shape()->shadowOffset().k() != z)
+        {
+            return false;
+        }
+    }
+
+    MCSurfaceView & view = static_cast<MCSurfaceView &>(*objects[0]->shape()->view());
+
+    setShadowShaderProgram(view.shadowShaderProgram());
+    setMaterial(view.surface()->material());
+
+    const int objectCount = static_cast<int>(objects.size());
+    for (int begin = 0; begin < objectCount; begin += m_maxBatchSize)
+    {
+        setBatch(objects, begin, std::min(begin + m_maxBatchSize, objectCount), camera, true);
+
+        shadowShaderProgram()->bind();
+
+        bindMaterial(true);
+
+        shadowShaderProgram()->setTransform(0, MCVector3dF(0, 0, z));
+        shadowShaderProgram()->setScale(1.0f, 1.0f, 1.0f);
+
+        glDrawArrays(GL_TRIANGLES, 0, m_batchSize * NUM_VERTICES_PER_OBJECT);
+        MCGLScene::instance().stateCache().countDrawCall();
+
+        releaseVBO();
+        releaseVAO();
+    }
+
+    return true;
+}
+
+MCSurfaceObjectRenderer::~MCSurfaceObjectRenderer()
+{
+}
@@ -0,0 +1,86 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#ifndef MCSURFACEOBJECTRENDERER_HH
+#define MCSURFACEOBJECTRENDERER_HH
+
+#include <MCGLEW>
+
+#include "mcglcolor.hh"
+#include "mcglobjectbase.hh"
+#include "mcgltexcoord.hh"
+#include "mcglvertex.hh"
+#include "mcmacros.hh"
+
+#include <vector>
+
+class MCCamera;
+class MCObject;
+class MCSurface;
+
+/*! Renders a batch of plain objects that share a single MCSurface with one
+ *  draw call. The vertices of all objects are transformed on the CPU into
+ *  a streaming vertex buffer, so the shaders only see an identity transform.
+ *  MCWorldRenderer uses this for object batches accepted by canRender()
+ *  and falls back to rendering object by object otherwise. */
+class MCSurfaceObjectRenderer : public MCGLObjectBase
+{
+public:
+
+    typedef std::vector<MCObject *> ObjectVector;
+
+    explicit MCSurfaceObjectRenderer(int maxBatchSize = 1024);
+
+    //! Destructor.
+    virtual ~MCSurfaceObjectRenderer();
+
+    /*! \return true if all objects are plain MCObjects rendered by an
+     *  MCSurfaceView of the same surface and with the default shaders. */
+    static bool canRender(const ObjectVector & objects);
+
+    //! Render the given batch. canRender() must have accepted it.
+    void render(const ObjectVector & objects, MCCamera * camera);
+
+    /*! Render shadows of the given batch. canRender() must have accepted it.
+     *  \return false if the shadows can't be batched, because their
+     *  Z-coordinates differ. Nothing is rendered in that case. */
+    bool renderShadows(const ObjectVector & objects, MCCamera * camera);
+
+private:
+
+    DISABLE_COPY(MCSurfaceObjectRenderer);
+    DISABLE_ASSI(MCSurfaceObjectRenderer);
+
+    //! Fill the vertex buffer with objects [begin, end).
+    void setBatch(const ObjectVector & objects, int begin, int end, MCCamera * camera, bool shadow);
+
+    int m_maxBatchSize;
+
+    int m_batchSize;
+
+    std::vector<MCGLVertex> m_vertices;
+
+    std::vector<MCGLVertex> m_normals;
+
+    std::vector<MCGLTexCoord> m_texCoords;
+
+    std::vector<MCGLColor> m_colors;
+};
+
+#endif // MCSURFACEOBJECTRENDERER_HH
@@ -28,6 +28,7 @@ MCSurfaceParticle::MCSurfaceParticle(const std::string & typeID, MCSurface & sur
 , m_src(0)
 , m_dst(0)
 {
+    setIsSurfaceParticle(true);
 }
 
 void MCSurfaceParticle::setColor(const MCGLColor & color)
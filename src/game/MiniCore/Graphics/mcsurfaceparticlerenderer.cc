@@ -18,10 +18,12 @@
 //
 
 #include "mcsurfaceparticlerenderer.hh"
+#include "mcglscene.hh"
 #include "mcsurfaceparticle.hh"
 #include "mctrigonom.hh"
 
 #include <algorithm>
+#include <cassert>
 
 namespace {
 #ifdef __MC_GLES__
@@ -31,12 +33,51 @@ const int NUM_VERTICES_PER_PARTICLE = 4;
 #endif
 }
 
+namespace {
+// Init vertice data for a quad
+
+const MCGLVertex QUAD_VERTICES[NUM_VERTICES_PER_PARTICLE] =
+{
+#ifdef __MC_GLES__
+    {-1, -1, 0},
+    { 1,  1, 0},
+#endif
+    {-1,  1, 0},
+    {-1, -1, 0},
+    { 1, -1, 0},
+    { 1,  1, 0}
+};
+
+const MCGLVertex QUAD_NORMALS[NUM_VERTICES_PER_PARTICLE] =
+{
+#ifdef __MC_GLES__
+    { 0, 0, 1},
+    { 0, 0, 1},
+#endif
+    { 0, 0, 1},
+    { 0, 0, 1},
+    { 0, 0, 1},
+    { 0, 0, 1}
+};
+
+const MCGLTexCoord QUAD_TEXCOORDS[NUM_VERTICES_PER_PARTICLE] =
+{
+#ifdef __MC_GLES__
+    {0, 0},
+    {1, 1},
+#endif
+    {0, 1},
+    {0, 0},
+    {1, 0},
+    {1, 1}
+};
+}
+
 MCSurfaceParticleRenderer::MCSurfaceParticleRenderer(int maxBatchSize)
     : MCParticleRendererBase(maxBatchSize)
     , m_vertices(new MCGLVertex[maxBatchSize * NUM_VERTICES_PER_PARTICLE])
-    , m_normals(new MCGLVertex[maxBatchSize * NUM_VERTICES_PER_PARTICLE])
-    , m_texCoords(new MCGLTexCoord[maxBatchSize * NUM_VERTICES_PER_PARTICLE])
     , m_colors(new MCGLColor[maxBatchSize * NUM_VERTICES_PER_PARTICLE])
+    , m_texCoordSurface(nullptr)
 {
     const int NUM_VERTICES = maxBatchSize * NUM_VERTICES_PER_PARTICLE;
     const int VERTEX_DATA_SIZE = sizeof(MCGLVertex) * NUM_VERTICES;
@@ -45,79 +86,113 @@ MCSurfaceParticleRenderer::MCSurfaceParticleRenderer(int maxBatchSize)
     const int COLOR_DATA_SIZE = sizeof(MCGLColor) * NUM_VERTICES;
     const int TOTAL_DATA_SIZE = VERTEX_DATA_SIZE + NORMAL_DATA_SIZE + TEXCOORD_DATA_SIZE + COLOR_DATA_SIZE;
 
+    // Normals are the same for every batch, so they are uploaded only once
+    // here. Texture coordinates change only with the surface, see setTexCoords().
+    std::vector<MCGLVertex> normals(NUM_VERTICES);
+    std::vector<MCGLTexCoord> texCoords(NUM_VERTICES);
+    for (int i = 0; i < NUM_VERTICES; i++)
+    {
+        normals[i] = QUAD_NORMALS[i % NUM_VERTICES_PER_PARTICLE];
+        texCoords[i] = QUAD_TEXCOORDS[i % NUM_VERTICES_PER_PARTICLE];
+    }
+
     initBufferData(TOTAL_DATA_SIZE, GL_DYNAMIC_DRAW);
 
     addBufferSubData(
         MCGLShaderProgram::VAL_Vertex, VERTEX_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_vertices));
     addBufferSubData(
-        MCGLShaderProgram::VAL_Normal, NORMAL_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_normals));
+        MCGLShaderProgram::VAL_Normal, NORMAL_DATA_SIZE, reinterpret_cast<const GLfloat *>(normals.data()));
     addBufferSubData(
-        MCGLShaderProgram::VAL_TexCoords, TEXCOORD_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_texCoords));
+        MCGLShaderProgram::VAL_TexCoords, TEXCOORD_DATA_SIZE, reinterpret_cast<const GLfloat *>(texCoords.data()));
     addBufferSubData(
         MCGLShaderProgram::VAL_Color, COLOR_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_colors));
 
     finishBufferData();
 }
 
-void MCSurfaceParticleRenderer::setBatch(MCParticleRendererBase::ParticleVector & particles, MCCamera * camera)
+void MCSurfaceParticleRenderer::sortBatch(MCParticleRendererBase::ParticleVector & particles)
 {
-    if (!particles.size()) {
+    // Batches of flat particles like skid marks are often sorted already.
+    const auto byZ = [] (const MCObject * l, const MCObject * r) {
+        return l->location().k() < r->location().k();
+    };
+
+    if (std::is_sorted(particles.begin(), particles.end(), byZ))
+    {
         return;
     }
 
-    setBatchSize(std::min(static_cast<int>(particles.size()), maxBatchSize()));
-    std::sort(particles.begin(), particles.end(), [] (const MCObject * l, const MCObject * r) {
-        return l->location().k() < r->location().k();
-    });
+    // Sort compact keys instead of dereferencing the particles in every comparison.
+    m_sortKeys.clear();
+    for (MCObject * particle : particles)
+    {
+        m_sortKeys.push_back(std::make_pair(particle->location().k(), particle));
+    }
 
-    const int NUM_VERTICES = batchSize() * NUM_VERTICES_PER_PARTICLE;
-    const int VERTEX_DATA_SIZE = sizeof(MCGLVertex) * NUM_VERTICES;
-    const int NORMAL_DATA_SIZE = sizeof(MCGLVertex) * NUM_VERTICES;
-    const int TEXCOORD_DATA_SIZE = sizeof(MCGLTexCoord) * NUM_VERTICES;
-    const int COLOR_DATA_SIZE  = sizeof(MCGLColor) * NUM_VERTICES;
+    std::sort(m_sortKeys.begin(), m_sortKeys.end(),
+        [] (const std::pair<MCFloat, MCObject *> & l, const std::pair<MCFloat, MCObject *> & r) {
+        return l.first < r.first;
+    });
 
-    // Init vertice data for a quad
+    for (unsigned int i = 0; i < m_sortKeys.size(); i++)
+    {
+        particles[i] = m_sortKeys[i].second;
+    }
+}
 
-    static const MCGLVertex vertices[NUM_VERTICES_PER_PARTICLE] =
+void MCSurfaceParticleRenderer::setTexCoords(MCSurface & surface)
+{
+    if (&surface == m_texCoordSurface)
     {
-    #ifdef __MC_GLES__
-        {-1, -1, 0},
-        { 1,  1, 0},
-    #endif
-        {-1,  1, 0},
-        {-1, -1, 0},
-        { 1, -1, 0},
-        { 1,  1, 0}
-    };
+        return;
+    }
 
-    static const MCGLVertex normals[NUM_VERTICES_PER_PARTICLE] =
+    m_texCoordSurface = &surface;
+
+    MCFloat u0 = 1, v0 = 1, u1 = 0, v1 = 0;
+    for (int i = 0; i < MCSurface::NUM_VERTICES; i++)
     {
-    #ifdef __MC_GLES__
-        { 0, 0, 1},
-        { 0, 0, 1},
-    #endif
-        { 0, 0, 1},
-        { 0, 0, 1},
-        { 0, 0, 1},
-        { 0, 0, 1}
-    };
+        u0 = std::min(u0, surface.texCoords()[i].u);
+        v0 = std::min(v0, surface.texCoords()[i].v);
+        u1 = std::max(u1, surface.texCoords()[i].u);
+        v1 = std::max(v1, surface.texCoords()[i].v);
+    }
 
-    const MCGLTexCoord texCoords[NUM_VERTICES_PER_PARTICLE] =
+    const int NUM_VERTICES = maxBatchSize() * NUM_VERTICES_PER_PARTICLE;
+    std::vector<MCGLTexCoord> texCoords(NUM_VERTICES);
+    for (int i = 0; i < NUM_VERTICES; i++)
     {
-    #ifdef __MC_GLES__
-        {0, 0},
-        {1, 1},
-    #endif
-        {0, 1},
-        {0, 0},
-        {1, 0},
-        {1, 1}
-    };
+        const MCGLTexCoord & quadTexCoord = QUAD_TEXCOORDS[i % NUM_VERTICES_PER_PARTICLE];
+        texCoords[i].u = u0 + quadTexCoord.u * (u1 - u0);
+        texCoords[i].v = v0 + quadTexCoord.v * (v1 - v0);
+    }
+
+    const int TEXCOORD_DATA_OFFSET = (sizeof(MCGLVertex) + sizeof(MCGLVertex)) * NUM_VERTICES;
+
+    initUpdateBufferData();
+
+    glBufferSubData(GL_ARRAY_BUFFER, TEXCOORD_DATA_OFFSET, sizeof(MCGLTexCoord) * NUM_VERTICES, texCoords.data());
+    MCGLScene::instance().stateCache().countBufferUpload();
+}
+
+void MCSurfaceParticleRenderer::setBatch(MCParticleRendererBase::ParticleVector & particles, MCCamera * camera)
+{
+    if (!particles.size()) {
+        return;
+    }
+
+    setBatchSize(std::min(static_cast<int>(particles.size()), maxBatchSize()));
+    sortBatch(particles);
+
+    const int NUM_VERTICES = batchSize() * NUM_VERTICES_PER_PARTICLE;
+    const int VERTEX_DATA_SIZE = sizeof(MCGLVertex) * NUM_VERTICES;
+    const int COLOR_DATA_SIZE  = sizeof(MCGLColor) * NUM_VERTICES;
 
     // Take common properties from the first particle in the batch
-    MCSurfaceParticle * particle = dynamic_cast<MCSurfaceParticle *>(particles.at(0));
-    assert(particle);
+    assert(static_cast<MCParticle *>(particles.at(0))->isSurfaceParticle());
+    MCSurfaceParticle * particle = static_cast<MCSurfaceParticle *>(particles.at(0));
     setMaterial(particle->surface().material());
+    setTexCoords(particle->surface());
     setHasShadow(particle->hasShadow());
     setAlphaBlend(particle->useAlphaBlend(), particle->alphaSrc(), particle->alphaDst());
 
@@ -138,8 +213,8 @@ void MCSurfaceParticleRenderer::setBatch(MCParticleRendererBase::ParticleVector
 
         for (int j = 0; j < NUM_VERTICES_PER_PARTICLE; j++)
         {
-            MCFloat vertexX = vertices[j].x() * particle->radius();
-            MCFloat vertexY = vertices[j].y() * particle->radius();
+            MCFloat vertexX = QUAD_VERTICES[j].x() * particle->radius();
+            MCFloat vertexY = QUAD_VERTICES[j].y() * particle->radius();
 
             m_colors[vertexIndex] = particle->color();
             if (particle->animationStyle() == MCParticle::FadeOut)
@@ -164,33 +239,23 @@ void MCSurfaceParticleRenderer::setBatch(MCParticleRendererBase::ParticleVector
                     y + MCTrigonom::rotatedY(vertexX, vertexY, particle->angle()),
                     z);
 
-            m_normals[vertexIndex] = normals[j];
-
-            m_texCoords[vertexIndex] = texCoords[j];
-
             vertexIndex++;
         }
     }
 
-    initUpdateBufferData();
+    // Only vertices and colors change. The attribute offsets stay as
+    // set in the constructor.
+    const int MAX_NUM_VERTICES = maxBatchSize() * NUM_VERTICES_PER_PARTICLE;
+    const int COLOR_DATA_OFFSET =
+        (sizeof(MCGLVertex) + sizeof(MCGLVertex) + sizeof(MCGLTexCoord)) * MAX_NUM_VERTICES;
 
-    const int MAX_VERTEX_DATA_SIZE = sizeof(MCGLVertex) * maxBatchSize() * NUM_VERTICES_PER_PARTICLE;
-    addBufferSubData(
-        MCGLShaderProgram::VAL_Vertex, VERTEX_DATA_SIZE, MAX_VERTEX_DATA_SIZE,
-                reinterpret_cast<const GLfloat *>(m_vertices));
-
-    const int MAX_NORMAL_DATA_SIZE = sizeof(MCGLVertex) * maxBatchSize() * NUM_VERTICES_PER_PARTICLE;
-    addBufferSubData(
-        MCGLShaderProgram::VAL_Normal, NORMAL_DATA_SIZE, MAX_NORMAL_DATA_SIZE,
-                reinterpret_cast<const GLfloat *>(m_normals));
-
-    const int MAX_TEXCOORD_DATA_SIZE = sizeof(MCGLTexCoord) * maxBatchSize() * NUM_VERTICES_PER_PARTICLE;
-    addBufferSubData(
-        MCGLShaderProgram::VAL_TexCoords, TEXCOORD_DATA_SIZE, MAX_TEXCOORD_DATA_SIZE,
-                reinterpret_cast<const GLfloat *>(m_texCoords));
+    initUpdateBufferData();
 
-    addBufferSubData(
-        MCGLShaderProgram::VAL_Color, COLOR_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_colors));
+    MCGLStateCache & stateCache = MCGLScene::instance().stateCache();
+    glBufferSubData(GL_ARRAY_BUFFER, 0, VERTEX_DATA_SIZE, m_vertices);
+    stateCache.countBufferUpload();
+    glBufferSubData(GL_ARRAY_BUFFER, COLOR_DATA_OFFSET, COLOR_DATA_SIZE, m_colors);
+    stateCache.countBufferUpload();
 }
 
 void MCSurfaceParticleRenderer::render()
@@ -198,10 +263,14 @@ void MCSurfaceParticleRenderer::render()
     assert(shaderProgram());
     shaderProgram()->bind();
 
+    bindVAO();
+    bindVBO();
+
+    MCGLStateCache & stateCache = MCGLScene::instance().stateCache();
     if (useAlphaBlend())
     {
-        glEnable(GL_BLEND);
-        glBlendFunc(alphaSrc(), alphaDst());
+        stateCache.setBlendEnabled(true);
+        stateCache.setBlendFunc(alphaSrc(), alphaDst());
     }
 
     bindMaterial();
@@ -215,7 +284,8 @@ void MCSurfaceParticleRenderer::render()
 #else
     glDrawArrays(GL_QUADS, 0, batchSize() * NUM_VERTICES_PER_PARTICLE);
 #endif
-    glDisable(GL_BLEND);
+    stateCache.countDrawCall();
+    stateCache.setBlendEnabled(false);
 
     releaseVBO();
     releaseVAO();
@@ -226,6 +296,9 @@ void MCSurfaceParticleRenderer::renderShadows()
     assert(shadowShaderProgram());
     shadowShaderProgram()->bind();
 
+    bindVAO();
+    bindVBO();
+
     bindMaterial(true);
 
     shadowShaderProgram()->setTransform(0, MCVector3dF(0, 0, 0));
@@ -236,7 +309,9 @@ void MCSurfaceParticleRenderer::renderShadows()
 #else
     glDrawArrays(GL_QUADS, 0, batchSize() * NUM_VERTICES_PER_PARTICLE);
 #endif
-    glDisable(GL_BLEND);
+    MCGLStateCache & stateCache = MCGLScene::instance().stateCache();
+    stateCache.countDrawCall();
+    stateCache.setBlendEnabled(false);
 
     releaseVBO();
     releaseVAO();
@@ -245,8 +320,6 @@ void MCSurfaceParticleRenderer::renderShadows()
 MCSurfaceParticleRenderer::~MCSurfaceParticleRenderer()
 {
     delete [] m_vertices;
-    delete [] m_normals;
-    delete [] m_texCoords;
     delete [] m_colors;
 }
 
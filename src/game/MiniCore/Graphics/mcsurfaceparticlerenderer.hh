@@ -26,8 +26,10 @@
 #include "mcparticlerendererbase.hh"
 #include "mcworldrenderer.hh"
 
+#include <utility>
 #include <vector>
 
+class MCSurface;
 class MCSurfaceParticle;
 class MCCamera;
 class MCObject;
@@ -60,14 +62,22 @@ private:
     //! Render the current particle batch as shadows.
     void renderShadows() override;
 
-    MCGLVertex * m_vertices;
+    //! Sort the particles by Z.
+    void sortBatch(ParticleVector & particles);
 
-    MCGLVertex * m_normals;
+    /*! Map the quad texture coordinates to the area the surface uses.
+     *  Surfaces packed into an atlas use only a part of their texture. */
+    void setTexCoords(MCSurface & surface);
 
-    MCGLTexCoord * m_texCoords;
+    MCGLVertex * m_vertices;
 
     MCGLColor * m_colors;
 
+    //! Surface whose texture coordinates are uploaded.
+    MCSurface * m_texCoordSurface;
+
+    std::vector<std::pair<MCFloat, MCObject *> > m_sortKeys;
+
     friend class MCWorldRenderer;
 };
 
@@ -28,10 +28,19 @@ MCSurfaceView::MCSurfaceView(
 : MCShapeView(viewId)
 , m_surface(surface)
 {
+    // Surfaces are shared between all views (and worlds), so only write
+    // to them if something actually changes.
     if (surface)
     {
-        m_surface->setShaderProgram(shaderProgram());
-        m_surface->setShadowShaderProgram(shadowShaderProgram());
+        if (m_surface->shaderProgram() != shaderProgram())
+        {
+            m_surface->setShaderProgram(shaderProgram());
+        }
+
+        if (m_surface->shadowShaderProgram() != shadowShaderProgram())
+        {
+            m_surface->setShadowShaderProgram(shadowShaderProgram());
+        }
     }
 }
 
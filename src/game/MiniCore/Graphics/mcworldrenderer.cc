@@ -20,7 +20,9 @@
 #include "mcworldrenderer.hh"
 
 #include "mccamera.hh"
+#include "mcglscene.hh"
 #include "mclogger.hh"
+#include "mcsurfaceobjectrenderer.hh"
 #include "mcsurfaceparticle.hh"
 #include "mcsurfaceparticlerenderer.hh"
 #include "mcobject.hh"
@@ -33,7 +35,8 @@
 #include <MCGLEW>
 
 MCWorldRenderer::MCWorldRenderer()
-    : m_surfaceParticleRenderer(nullptr)
+    : m_visibilityCulling(VisibilityCulling::LayerScan)
+    , m_surfaceObjectRenderer(nullptr)
 {
 }
 
@@ -50,8 +53,9 @@ void MCWorldRenderer::render(MCCamera * camera, const std::vector<int> & layers)
 void MCWorldRenderer::buildBatches(MCCamera * camera)
 {
     // In the case of Dust Racing 2D, it was faster to just loop through
-    // all objects on all layers and perform visibility tests instead of
-    // just fetching all "visible" objects from MCObjectGrid.
+    // all objects on all layers and perform visibility tests. On large worlds
+    // VisibilityCulling::Grid fetches only the objects near the camera from
+    // the render grid instead.
 
     // This code tests the visibility and sorts the objects with respect
     // to their view id's into "batches". MCWorld::render()
@@ -61,75 +65,100 @@ void MCWorldRenderer::buildBatches(MCCamera * camera)
     // Grouping the objects like this reduces texture switches etc and increases
     // overall performance.
 
-    auto layerIter = m_layers.begin();
-    while (layerIter != m_layers.end())
+    // The particle batches of the camera are rebuilt, so they
+    // have to be uploaded again.
+    for (auto && batch : m_surfaceParticleBatches)
+    {
+        if (std::get<0>(batch.first) == camera)
+        {
+            batch.second.isUpToDate = false;
+        }
+    }
+
+    for (auto && layer : m_layers)
     {
-        MCRenderLayer & layer = layerIter->second;
+        layer.second.objectBatches(camera).clear();
+        layer.second.particleBatches(camera).clear();
+    }
+
+    if (camera && m_visibilityCulling == VisibilityCulling::Grid)
+    {
+        m_renderGrid.getObjectsWithinBBox(camera->bbox(), m_visibleCandidates);
 
-        layer.objectBatches()[camera].clear();
-        layer.particleBatches()[camera].clear();
+        for (MCObject * object : m_visibleCandidates)
+        {
+            MCRenderLayer & layer = m_layers[object->renderLayer()];
+            addToBatches(camera, layer, *object);
+        }
+    }
+    else
+    {
+        for (auto && layer : m_layers)
+        {
+            for (MCObject * object : layer.second.objectSet())
+            {
+                addToBatches(camera, layer.second, *object);
+            }
+        }
+    }
+}
 
-        for (auto objectIter = layer.objectSet().begin(); objectIter != layer.objectSet().end(); objectIter++)
+void MCWorldRenderer::addToBatches(MCCamera * camera, MCRenderLayer & layer, MCObject & object)
+{
+    if (object.isRenderable())
+    {
+        // Check if view is set and is visible
+        if (object.shape())
         {
-            MCObject & object = **objectIter;
-            if (object.isRenderable())
+            if (!object.isParticle())
             {
-                // Check if view is set and is visible
-                if (object.shape())
+                if (object.shape()->view())
                 {
-                    if (!object.isParticle())
+                    MCBBox<MCFloat> bbox(object.shape()->view()->bbox().toBBox());
+                    bbox.translate(MCVector2dF(object.location()));
+                    if (!camera || camera->isVisible(bbox))
                     {
-                        if (object.shape()->view())
-                        {
-                            MCBBox<MCFloat> bbox(object.shape()->view()->bbox().toBBox());
-                            bbox.translate(MCVector2dF(object.location()));
-                            if (!camera || camera->isVisible(bbox))
-                            {
-                                layer.objectBatches()[camera][object.typeID()].push_back(&object);
-                            }
-                        }
+                        layer.objectBatches(camera).add(object);
+                    }
+                }
+            }
+            else
+            {
+                if (camera)
+                {
+                    if (camera->isVisible(object.bbox()))
+                    {
+                        layer.particleBatches(camera).add(object);
                     }
                     else
                     {
-                        if (camera)
+                        // Optimization that kills non-visible particles.
+                        MCParticle & particle = static_cast<MCParticle &>(object);
+                        if (particle.dieWhenOffScreen())
                         {
-                            if (camera->isVisible(object.bbox()))
-                            {
-                                layer.particleBatches()[camera][object.typeID()].push_back(&object);
-                            }
-                            else
+                            bool isVisibleInAnyCamera = false;
+                            for (MCCamera * visibilityCamera : m_visibilityCameras)
                             {
-                                // Optimization that kills non-visible particles.
-                                MCParticle & particle = static_cast<MCParticle &>(object);
-                                if (particle.dieWhenOffScreen())
+                                if (visibilityCamera != camera && visibilityCamera->isVisible(particle.bbox()))
                                 {
-                                    bool isVisibleInAnyCamera = false;
-                                    for (MCCamera * visibilityCamera : m_visibilityCameras)
-                                    {
-                                        if (visibilityCamera != camera && visibilityCamera->isVisible(particle.bbox()))
-                                        {
-                                            isVisibleInAnyCamera = true;
-                                            break;
-                                        }
-                                    }
-
-                                    if (!isVisibleInAnyCamera)
-                                    {
-                                        particle.die();
-                                    }
+                                    isVisibleInAnyCamera = true;
+                                    break;
                                 }
                             }
-                        }
-                        else
-                        {
-                            layer.particleBatches()[camera][object.typeID()].push_back(&object);
+
+                            if (!isVisibleInAnyCamera)
+                            {
+                                particle.die();
+                            }
                         }
                     }
                 }
+                else
+                {
+                    layer.particleBatches(camera).add(object);
+                }
             }
         }
-
-        layerIter++;
     }
 }
 
@@ -138,6 +167,8 @@ void MCWorldRenderer::renderBatches(MCCamera * camera, const std::vector<int> &
     // Render in the order of the layers. Depth test is
     // layer-specific.
 
+    MCGLStateCache & stateCache = MCGLScene::instance().stateCache();
+
     auto layerIter = m_layers.begin();
     while (layerIter != m_layers.end())
     {
@@ -148,21 +179,13 @@ void MCWorldRenderer::renderBatches(MCCamera * camera, const std::vector<int> &
 
             // The depth test is enabled/disabled separately on
             // each object layer.
-            if (layer.depthTestEnabled())
-            {
-                glEnable(GL_DEPTH_TEST);
-            }
-            else
-            {
-                glDisable(GL_DEPTH_TEST);
-            }
-
-            glDepthMask(layer.depthMaskEnabled());
+            stateCache.setDepthTestEnabled(layer.depthTestEnabled());
+            stateCache.setDepthMaskEnabled(layer.depthMaskEnabled());
 
             renderObjectBatches(camera, layer);
             renderParticleBatches(camera, layer);
 
-            glDepthMask(GL_TRUE);
+            stateCache.setDepthMaskEnabled(true);
         }
 
         layerIter++;
@@ -171,61 +194,84 @@ void MCWorldRenderer::renderBatches(MCCamera * camera, const std::vector<int> &
 
 void MCWorldRenderer::renderObjectBatches(MCCamera * camera, MCRenderLayer & layer)
 {
-    auto iter = layer.objectBatches()[camera].begin();
-    const auto end = layer.objectBatches()[camera].end();
-    while (iter != end)
+    MCRenderLayer::BatchArray & batches = layer.objectBatches(camera);
+    for (MCRenderLayer::ObjectTypeId typeId : batches.typeIds())
     {
-        const int itemCountInBatch = static_cast<const int>(iter->second.size());
-        if (itemCountInBatch > 0)
+        MCRenderLayer::BatchArray::Batch & batch = batches.batch(typeId);
+        const int itemCountInBatch = static_cast<const int>(batch.size());
+        if (itemCountInBatch > 1 && MCSurfaceObjectRenderer::canRender(batch))
         {
-            MCObject * object = iter->second[0];
+            surfaceObjectRenderer().render(batch, camera);
+        }
+        else if (itemCountInBatch > 0)
+        {
+            MCObject * object = batch[0];
             std::shared_ptr<MCShapeView> view = object->shape()->view();
             view->beginBatch();
             object->render(camera);
 
             for (int i = 1; i < itemCountInBatch - 1; i++)
             {
-                iter->second[i]->render(camera);
+                batch[i]->render(camera);
             }
 
-            object = iter->second[itemCountInBatch - 1];
+            object = batch[itemCountInBatch - 1];
             object->render(camera);
 
             view = object->shape()->view();
             view->endBatch();
         }
+    }
+}
 
-        iter++;
+MCSurfaceObjectRenderer & MCWorldRenderer::surfaceObjectRenderer()
+{
+    if (!m_surfaceObjectRenderer)
+    {
+        m_surfaceObjectRenderer = new MCSurfaceObjectRenderer;
+    }
+
+    return *m_surfaceObjectRenderer;
+}
+
+MCSurfaceParticleRenderer & MCWorldRenderer::surfaceParticleRenderer(
+    MCCamera * camera, MCRenderLayer & layer, int typeId,
+    MCParticleRendererBase::ParticleVector & particles)
+{
+    // Shadows and particles are rendered from the same upload, because
+    // every camera, layer and type has its own renderer.
+    SurfaceParticleBatch & batch = m_surfaceParticleBatches[std::make_tuple(camera, &layer, typeId)];
+    if (!batch.renderer)
+    {
+        batch.renderer.reset(new MCSurfaceParticleRenderer);
+    }
+
+    if (!batch.isUpToDate)
+    {
+        batch.renderer->setBatch(particles, camera);
+        batch.isUpToDate = true;
     }
+
+    return *batch.renderer;
 }
 
 void MCWorldRenderer::renderParticleBatches(MCCamera * camera, MCRenderLayer & layer)
 {
-    auto batchIter = layer.particleBatches()[camera].begin();
-    const auto end = layer.particleBatches()[camera].end();
-    while (batchIter != end)
+    MCRenderLayer::BatchArray & batches = layer.particleBatches(camera);
+    for (MCRenderLayer::ObjectTypeId typeId : batches.typeIds())
     {
-        if (batchIter->second.size())
+        MCRenderLayer::BatchArray::Batch & batch = batches.batch(typeId);
+        if (static_cast<MCParticle *>(batch[0])->isSurfaceParticle())
         {
-            if (dynamic_cast<MCSurfaceParticle *>(batchIter->second[0]))
-            {
-                if (!m_surfaceParticleRenderer)
-                {
-                    m_surfaceParticleRenderer = new MCSurfaceParticleRenderer;
-                }
-
-                m_surfaceParticleRenderer->setBatch(batchIter->second, camera);
-                m_surfaceParticleRenderer->render();
-            }
+            surfaceParticleRenderer(camera, layer, typeId, batch).render();
         }
-
-        batchIter++;
     }
 }
 
 void MCWorldRenderer::renderShadows(MCCamera * camera, const std::vector<int> & layers)
 {
-    glEnable(GL_DEPTH_TEST);
+    MCGLStateCache & stateCache = MCGLScene::instance().stateCache();
+    stateCache.setDepthTestEnabled(true);
 
     auto layerIter = m_layers.begin();
     while (layerIter != m_layers.end())
@@ -241,68 +287,58 @@ void MCWorldRenderer::renderShadows(MCCamera * camera, const std::vector<int> &
         layerIter++;
     }
 
-    glDisable(GL_DEPTH_TEST);
+    stateCache.setDepthTestEnabled(false);
 }
 
 void MCWorldRenderer::renderObjectShadowBatches(MCCamera * camera, MCRenderLayer & layer)
 {
     // Render batches
-    auto batchIter = layer.objectBatches()[camera].begin();
-    const auto end = layer.objectBatches()[camera].end();
-    while (batchIter != end)
+    MCRenderLayer::BatchArray & batches = layer.objectBatches(camera);
+    for (MCRenderLayer::ObjectTypeId typeId : batches.typeIds())
     {
-        const int itemCountInBatch = static_cast<const int>(batchIter->second.size());
+        MCRenderLayer::BatchArray::Batch & batch = batches.batch(typeId);
+        const int itemCountInBatch = static_cast<const int>(batch.size());
         if (itemCountInBatch > 0)
         {
-            MCObject * object = batchIter->second[0];
+            MCObject * object = batch[0];
             std::shared_ptr<MCShapeView> view = object->shape()->view();
-            if (view && view->hasShadow())
+            if (view && view->hasShadow() &&
+                !(itemCountInBatch > 1 && MCSurfaceObjectRenderer::canRender(batch) &&
+                  surfaceObjectRenderer().renderShadows(batch, camera)))
             {
                 view->beginShadowBatch();
                 object->renderShadow(camera);
 
                 for (int i = 1; i < itemCountInBatch - 1; i++)
                 {
-                    batchIter->second[i]->renderShadow(camera);
+                    batch[i]->renderShadow(camera);
                 }
 
-                object = batchIter->second[itemCountInBatch - 1];
+                object = batch[itemCountInBatch - 1];
                 object->renderShadow(camera);
 
                 view = object->shape()->view();
                 view->endShadowBatch();
             }
         }
-
-        batchIter++;
     }
 }
 
 void MCWorldRenderer::renderParticleShadowBatches(MCCamera * camera, MCRenderLayer & layer)
 {
-    auto batchIter = layer.particleBatches()[camera].begin();
-    const auto end = layer.particleBatches()[camera].end();
-    while (batchIter != end)
+    MCRenderLayer::BatchArray & batches = layer.particleBatches(camera);
+    for (MCRenderLayer::ObjectTypeId typeId : batches.typeIds())
     {
-        if (batchIter->second.size())
+        MCRenderLayer::BatchArray::Batch & batch = batches.batch(typeId);
+
+        // Currently support shadows only for surface particles.
+        if (static_cast<MCParticle *>(batch[0])->isSurfaceParticle())
         {
-            // Currently support shadows only for surface particles.
-            if (MCSurfaceParticle * particle = dynamic_cast<MCSurfaceParticle *>(batchIter->second[0]))
+            if (static_cast<MCSurfaceParticle *>(batch[0])->hasShadow())
             {
-                if (particle->hasShadow())
-                {
-                    if (!m_surfaceParticleRenderer)
-                    {
-                        m_surfaceParticleRenderer = new MCSurfaceParticleRenderer;
-                    }
-
-                    m_surfaceParticleRenderer->setBatch(batchIter->second, camera);
-                    m_surfaceParticleRenderer->renderShadows();
-                }
+                surfaceParticleRenderer(camera, layer, typeId, batch).renderShadows();
             }
         }
-
-        batchIter++;
     }
 }
 
@@ -319,11 +355,64 @@ void MCWorldRenderer::enableDepthMaskOnLayer(int layer, bool enable)
 void MCWorldRenderer::addToLayerMap(MCObject & object)
 {
     m_layers[object.renderLayer()].objectSet().insert(&object);
+
+    if (m_visibilityCulling == VisibilityCulling::Grid)
+    {
+        m_renderGrid.insert(object);
+    }
 }
 
 void MCWorldRenderer::removeFromLayerMap(MCObject & object)
 {
     m_layers[object.renderLayer()].objectSet().erase(&object);
+
+    m_renderGrid.remove(object);
+}
+
+MCRenderGrid & MCWorldRenderer::renderGrid()
+{
+    return m_renderGrid;
+}
+
+void MCWorldRenderer::setDimensions(MCFloat minX, MCFloat maxX, MCFloat minY, MCFloat maxY)
+{
+    // A few cells per camera view, e.g. one track tile in Dust Racing 2D.
+    const MCFloat cellSize = 256;
+    m_renderGrid.setDimensions(
+        minX, minY, maxX, maxY,
+        static_cast<MCUint>((maxX - minX) / cellSize) + 1,
+        static_cast<MCUint>((maxY - minY) / cellSize) + 1);
+}
+
+void MCWorldRenderer::setVisibilityCulling(VisibilityCulling culling)
+{
+    if (culling != m_visibilityCulling)
+    {
+        m_visibilityCulling = culling;
+
+        // The grid is maintained only when used, as moving objects update it.
+        m_renderGrid.removeAll();
+        if (culling == VisibilityCulling::Grid)
+        {
+            for (auto && layer : m_layers)
+            {
+                for (MCObject * object : layer.second.objectSet())
+                {
+                    m_renderGrid.insert(*object);
+                }
+            }
+        }
+    }
+}
+
+MCWorldRenderer::VisibilityCulling MCWorldRenderer::visibilityCulling() const
+{
+    return m_visibilityCulling;
+}
+
+MCRenderLayer::BatchArray & MCWorldRenderer::objectBatches(MCCamera * camera, int layer)
+{
+    return m_layers[layer].objectBatches(camera);
 }
 
 void MCWorldRenderer::addParticleVisibilityCamera(MCCamera & camera)
@@ -338,6 +427,8 @@ void MCWorldRenderer::removeParticleVisibilityCameras()
 
 void MCWorldRenderer::clear()
 {
+    m_renderGrid.removeAll();
+
     auto layerIter = m_layers.begin();
     while (layerIter != m_layers.end())
     {
@@ -348,5 +439,5 @@ void MCWorldRenderer::clear()
 
 MCWorldRenderer::~MCWorldRenderer()
 {
-    delete m_surfaceParticleRenderer;
+    delete m_surfaceObjectRenderer;
 }
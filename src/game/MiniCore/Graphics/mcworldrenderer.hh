@@ -21,18 +21,22 @@
 #define MCWORLDRENDERER_HH
 
 #include "mcglscene.hh"
+#include "mcparticlerendererbase.hh"
+#include "mcrendergrid.hh"
 #include "mcrenderlayer.hh"
 #include "mctypes.hh"
 #include "mcworld.hh"
 
 #include <map>
 #include <memory>
+#include <tuple>
 #include <unordered_set>
 #include <vector>
 
 class MCCamera;
 class MCObject;
 
+class MCSurfaceObjectRenderer;
 class MCSurfaceParticleRenderer;
 
 //! Helper class used by MCWorld. Renders all objects in the scene.
@@ -40,6 +44,19 @@ class MCWorldRenderer
 {
 public:
 
+    //! How buildBatches() finds the objects visible to a camera.
+    enum class VisibilityCulling
+    {
+        //! Test every object on every layer. Fastest on small worlds.
+        LayerScan,
+
+        /*! Test only the objects near the camera, found via MCRenderGrid.
+         *  The cost scales with the number of objects on screen instead of
+         *  the world size, but moving objects have to update the grid.
+         *  Particles outside all cameras are not killed early. */
+        Grid
+    };
+
     MCWorldRenderer();
 
     ~MCWorldRenderer();
@@ -63,10 +80,23 @@ public:
     /*! Remove all particle visibility cameras. */
     void removeParticleVisibilityCameras();
 
+    /*! Select the visibility culling of this world's renderer.
+     *  Default is VisibilityCulling::LayerScan. */
+    void setVisibilityCulling(VisibilityCulling culling);
+
+    VisibilityCulling visibilityCulling() const;
+
+    /*! \return the object batches of the given camera and layer, as built by
+     *  the last MCWorld::prepareRendering(). */
+    MCRenderLayer::BatchArray & objectBatches(MCCamera * camera, int layer);
+
 private:
 
     void addToLayerMap(MCObject & object);
 
+    //! Add object to the batches of the camera, if visible.
+    void addToBatches(MCCamera * camera, MCRenderLayer & layer, MCObject & object);
+
     /*! Must be called before calls to render() or renderShadows() */
     void buildBatches(MCCamera * camera);
 
@@ -74,6 +104,11 @@ private:
 
     void removeFromLayerMap(MCObject & object);
 
+    MCRenderGrid & renderGrid();
+
+    //! Set the area covered by the render grid. Called by MCWorld.
+    void setDimensions(MCFloat minX, MCFloat maxX, MCFloat minY, MCFloat maxY);
+
     void render(MCCamera * camera, const std::vector<int> & layers);
 
     void renderBatches(MCCamera * camera = nullptr, const std::vector<int> & layers = std::vector<int>());
@@ -88,12 +123,38 @@ private:
 
     void renderParticleShadowBatches(MCCamera * camera, MCRenderLayer & layer);
 
+    MCSurfaceObjectRenderer & surfaceObjectRenderer();
+
+    /*! \return the renderer of the given camera, layer and particle type. The
+     *  given batch is uploaded only once after each call to buildBatches(). */
+    MCSurfaceParticleRenderer & surfaceParticleRenderer(
+        MCCamera * camera, MCRenderLayer & layer, int typeId,
+        MCParticleRendererBase::ParticleVector & particles);
+
     typedef int LayerId;
     std::map<LayerId, MCRenderLayer> m_layers;
 
     std::vector<MCCamera *> m_visibilityCameras;
 
-    MCSurfaceParticleRenderer * m_surfaceParticleRenderer;
+    VisibilityCulling m_visibilityCulling;
+
+    MCRenderGrid m_renderGrid;
+
+    //! Reused result of the render grid queries.
+    MCRenderGrid::ObjectVector m_visibleCandidates;
+
+    MCSurfaceObjectRenderer * m_surfaceObjectRenderer;
+
+    struct SurfaceParticleBatch
+    {
+        std::unique_ptr<MCSurfaceParticleRenderer> renderer;
+
+        bool isUpToDate = false;
+    };
+
+    //! The same particle type can be on several layers, e.g. smoke.
+    typedef std::tuple<MCCamera *, MCRenderLayer *, int> SurfaceParticleBatchKey;
+    std::map<SurfaceParticleBatchKey, SurfaceParticleBatch> m_surfaceParticleBatches;
 
     MCGLScene m_glScene;
 
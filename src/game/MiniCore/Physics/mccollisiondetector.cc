@@ -18,18 +18,21 @@
 //
 
 #include "mccollisiondetector.hh"
-#include "mccontact.hh"
+#include "mccontactmanifold.hh"
 #include "mcobject.hh"
 #include "mcsegment.hh"
 #include "mcshape.hh"
 #include "mccircleshape.hh"
 #include "mcrectshape.hh"
 #include "mccollisionevent.hh"
+#include "mcphysicscomponent.hh"
 
+#include <algorithm>
 #include <cassert>
 
-MCCollisionDetector::MCCollisionDetector()
-: m_enableCollisionEvents(true)
+MCCollisionDetector::MCCollisionDetector(MCContactManifold & contactManifold)
+: m_contactManifold(contactManifold)
+, m_enableCollisionEvents(true)
 {}
 
 void MCCollisionDetector::enableCollisionEvents(bool enable)
@@ -72,9 +75,7 @@ bool MCCollisionDetector::testRectAgainstRect(MCRectShape & rect1, MCRectShape &
             {
                 if (!m_enableCollisionEvents || ev1.accepted())
                 {
-                    MCContact & contact = MCContact::create();
-                    contact.init(rect2.parent(), vertex, contactNormal, depth);
-                    rect1.parent().addContact(contact);
+                    m_contactManifold.addContact(rect1.parent(), rect2.parent(), vertex, contactNormal, depth);
                     collided = true;
                 }
             }
@@ -90,9 +91,7 @@ bool MCCollisionDetector::testRectAgainstRect(MCRectShape & rect1, MCRectShape &
             {
                 if (!m_enableCollisionEvents || ev2.accepted())
                 {
-                    MCContact & contact = MCContact::create();
-                    contact.init(rect1.parent(), vertex, -contactNormal, depth);
-                    rect2.parent().addContact(contact);
+                    m_contactManifold.addContact(rect2.parent(), rect1.parent(), vertex, -contactNormal, depth);
                 }
             }
 
@@ -151,9 +150,7 @@ bool MCCollisionDetector::testRectAgainstCircle(MCRectShape & rect, MCCircleShap
             {
                 if (!m_enableCollisionEvents || ev1.accepted())
                 {
-                    MCContact & contact = MCContact::create();
-                    contact.init(rect.parent(), circleVertex, contactNormal, depth);
-                    circle.parent().addContact(contact);
+                    m_contactManifold.addContact(circle.parent(), rect.parent(), circleVertex, contactNormal, depth);
                     collided = true;
                 }
             }
@@ -169,9 +166,7 @@ bool MCCollisionDetector::testRectAgainstCircle(MCRectShape & rect, MCCircleShap
             {
                 if (!m_enableCollisionEvents || ev2.accepted())
                 {
-                    MCContact & contact = MCContact::create();
-                    contact.init(circle.parent(), circleVertex, -contactNormal, depth);
-                    rect.parent().addContact(contact);
+                    m_contactManifold.addContact(rect.parent(), circle.parent(), circleVertex, -contactNormal, depth);
                 }
             }
 
@@ -214,9 +209,7 @@ bool MCCollisionDetector::testCircleAgainstCircle(MCCircleShape & circle1, MCCir
         {
             if (!m_enableCollisionEvents || ev1.accepted())
             {
-                MCContact & contact = MCContact::create();
-                contact.init(circle1.parent(), circleVertex, -contactNormal, depth);
-                circle2.parent().addContact(contact);
+                m_contactManifold.addContact(circle2.parent(), circle1.parent(), circleVertex, -contactNormal, depth);
                 collided = true;
             }
         }
@@ -232,9 +225,7 @@ bool MCCollisionDetector::testCircleAgainstCircle(MCCircleShape & circle1, MCCir
         {
             if (!m_enableCollisionEvents || ev2.accepted())
             {
-                MCContact & contact = MCContact::create();
-                contact.init(circle1.parent(), circleVertex, contactNormal, depth);
-                circle1.parent().addContact(contact);
+                m_contactManifold.addContact(circle1.parent(), circle1.parent(), circleVertex, contactNormal, depth);
                 collided = true;
             }
         }
@@ -299,33 +290,78 @@ bool MCCollisionDetector::processPossibleCollision(MCObject & object1, MCObject
 
 MCUint MCCollisionDetector::detectCollisions(MCObjectGrid & objectGrid)
 {
-    static MCObjectGrid::CollisionVector possibleCollisions;
-    objectGrid.getBBoxCollisions(possibleCollisions);
+    objectGrid.getBBoxCollisions(m_possibleCollisions);
+
+    return processPossibleCollisions();
+}
+
+MCUint MCCollisionDetector::redetectCollisions(MCObjectGrid & objectGrid)
+{
+    // Only objects that collided can have been displaced since the last
+    // detection. Children move with their parents.
+    m_movedObjects.clear();
+    for (MCObject * object : m_collidedObjects)
+    {
+        if (!object->physicsComponent().isStationary())
+        {
+            m_movedObjects.push_back(object);
+        }
+    }
+
+    for (MCUint i = 0; i < m_movedObjects.size(); i++)
+    {
+        for (const MCObjectPtr & child : m_movedObjects[i]->children())
+        {
+            m_movedObjects.push_back(child.get());
+        }
+    }
+
+    objectGrid.getBBoxCollisions(m_movedObjects, m_possibleCollisions);
+
+    return processPossibleCollisions();
+}
+
+MCUint MCCollisionDetector::processPossibleCollisions()
+{
+    m_collidedObjects.clear();
 
     // Check collisions for all registered objects
     MCUint numCollisions = 0;
-    auto iter = possibleCollisions.begin();
-    const auto end = possibleCollisions.end();
-    for (;iter != end; iter++)
+    for (const MCObjectGrid::PossibleCollision & possibleCollision : m_possibleCollisions)
     {
-        MCObject * obj1(iter->first);
-        auto iter2 = iter->second.begin();
-        const auto end2 = iter->second.end();
-        for (;iter2 != end2; iter2++)
+        MCObject & obj1 = *possibleCollision.object1;
+        MCObject & obj2 = *possibleCollision.object2;
+
+        if ((obj1.isPhysicsObject() || obj1.isTriggerObject()) && !obj1.bypassCollisions() &&
+            (obj2.isPhysicsObject() || obj2.isTriggerObject()) && !obj2.bypassCollisions())
         {
-            MCObject * obj2(*iter2);
+            // The narrow phase is not symmetric, so test each way the
+            // broad phase asks for.
+            bool collided = false;
+            if (possibleCollision.test12 && processPossibleCollision(obj1, obj2))
+            {
+                numCollisions++;
+                collided = true;
+            }
 
-            if ((obj1->isPhysicsObject() || obj1->isTriggerObject()) && !obj1->bypassCollisions() &&
-                (obj2->isPhysicsObject() || obj2->isTriggerObject()) && !obj2->bypassCollisions())
+            if (possibleCollision.test21 && processPossibleCollision(obj2, obj1))
             {
-                if (processPossibleCollision(*obj1, *obj2))
-                {
-                    numCollisions++;
-                }
+                numCollisions++;
+                collided = true;
+            }
+
+            if (collided)
+            {
+                m_collidedObjects.push_back(&obj1);
+                m_collidedObjects.push_back(&obj2);
             }
         }
     }
 
+    // An object may have collided with several others.
+    std::sort(m_collidedObjects.begin(), m_collidedObjects.end());
+    m_collidedObjects.erase(
+        std::unique(m_collidedObjects.begin(), m_collidedObjects.end()), m_collidedObjects.end());
+
     return numCollisions;
 }
-
@@ -22,10 +22,12 @@
 
 #include "mcmacros.hh"
 #include "mctypes.hh"
+#include "mcobjectgrid.hh"
 
 #include <vector>
 
 class MCCircleShape;
+class MCContactManifold;
 class MCObject;
 class MCObjectGrid;
 class MCRectShape;
@@ -34,21 +36,30 @@ class MCRectShape;
 class MCCollisionDetector
 {
 public:
-    //! Constructor.
-    MCCollisionDetector();
+    /*! Constructor.
+     *  \param contactManifold Generated contacts are added here. */
+    explicit MCCollisionDetector(MCContactManifold & contactManifold);
 
     //! Destructor.
     virtual ~MCCollisionDetector() {};
 
-    //! Detect collisions and generate contacts. Contacts are stored to MCObject.
+    //! Detect collisions and generate contacts to the contact manifold.
     MCUint detectCollisions(MCObjectGrid & objectGrid);
 
+    /*! Detect collisions again after the last detection, re-testing only
+     *  the objects that collided then (and their children). This gives the
+     *  same result as detectCollisions() as long as nothing but the
+     *  collision resolution has moved objects in between. */
+    MCUint redetectCollisions(MCObjectGrid & objectGrid);
+
     /*! Turn collision events on/off. This is used by MCWorld when iterating
      *  the collision resolution. */
     void enableCollisionEvents(bool enable);
 
 private:
 
+    MCUint processPossibleCollisions();
+
     bool processPossibleCollision(MCObject & object1, MCObject & object2);
 
     bool testRectAgainstRect(MCRectShape & object1, MCRectShape & object2);
@@ -57,8 +68,17 @@ private:
 
     bool testCircleAgainstCircle(MCCircleShape & object1, MCCircleShape & object2);
 
+    MCContactManifold & m_contactManifold;
+
     bool m_enableCollisionEvents;
 
+    MCObjectGrid::CollisionVector m_possibleCollisions;
+
+    //! Objects that collided in the last detection.
+    std::vector<MCObject *> m_collidedObjects;
+
+    std::vector<MCObject *> m_movedObjects;
+
     DISABLE_COPY(MCCollisionDetector);
     DISABLE_ASSI(MCCollisionDetector);
 };
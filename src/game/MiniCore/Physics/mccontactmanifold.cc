@@ -0,0 +1,197 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2010 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+#include "mccontactmanifold.hh"
+
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+static const MCUint INITIAL_SLOT_COUNT = 64;
+
+static MCUint hashPair(const MCObject * object1, const MCObject * object2)
+{
+    const std::uintptr_t a = reinterpret_cast<std::uintptr_t>(object1);
+    const std::uintptr_t b = reinterpret_cast<std::uintptr_t>(object2);
+    return static_cast<MCUint>((a >> 3) * 31 + (b >> 3));
+}
+
+MCContactManifold::MCContactManifold()
+: m_generation(1)
+{
+    rehash(INITIAL_SLOT_COUNT);
+}
+
+void MCContactManifold::addContact(MCObject & object, MCObject & otherObject,
+    const MCVector2dF & contactPoint,
+    const MCVector2dF & contactNormal,
+    MCFloat interpenetrationDepth)
+{
+    const MCUint pair = findOrAddPair(object, otherObject);
+    const MCUint contact = static_cast<MCUint>(m_pair.size());
+
+    m_pair.push_back(pair);
+    m_contactPoint.push_back(contactPoint);
+    m_contactNormal.push_back(contactNormal);
+    m_interpenetrationDepth.push_back(interpenetrationDepth);
+
+    updateDeepest(m_object1[pair] == &object ? m_deepest1[pair] : m_deepest2[pair], contact);
+}
+
+void MCContactManifold::updateDeepest(int & deepest, MCUint contact)
+{
+    const MCFloat maxDepth = deepest >= 0 ? m_interpenetrationDepth[deepest] : 0;
+    if (m_interpenetrationDepth[contact] > maxDepth)
+    {
+        deepest = static_cast<int>(contact);
+    }
+}
+
+MCUint MCContactManifold::findOrAddPair(MCObject & object1, MCObject & object2)
+{
+    // Pairs are unordered.
+    MCObject * first = &object1;
+    MCObject * second = &object2;
+    if (std::less<MCObject *>()(second, first))
+    {
+        std::swap(first, second);
+    }
+
+    const MCUint mask = static_cast<MCUint>(m_slots.size()) - 1;
+    MCUint index = hashPair(first, second) & mask;
+    while (m_slots[index].generation == m_generation)
+    {
+        const PairSlot & slot = m_slots[index];
+        if (slot.object1 == first && slot.object2 == second)
+        {
+            return slot.pair;
+        }
+
+        index = (index + 1) & mask;
+    }
+
+    const MCUint pair = static_cast<MCUint>(m_object1.size());
+    m_slots[index] = {first, second, pair, m_generation};
+
+    m_object1.push_back(first);
+    m_object2.push_back(second);
+    m_deepest1.push_back(-1);
+    m_deepest2.push_back(-1);
+
+    // Keep the load factor under 0.5.
+    if (m_object1.size() * 2 > m_slots.size())
+    {
+        rehash(static_cast<MCUint>(m_slots.size()) * 2);
+    }
+
+    return pair;
+}
+
+void MCContactManifold::rehash(MCUint size)
+{
+    m_slots.assign(size, PairSlot{nullptr, nullptr, 0, 0});
+
+    const MCUint mask = size - 1;
+    for (MCUint pair = 0; pair < m_object1.size(); pair++)
+    {
+        MCUint index = hashPair(m_object1[pair], m_object2[pair]) & mask;
+        while (m_slots[index].generation == m_generation)
+        {
+            index = (index + 1) & mask;
+        }
+
+        m_slots[index] = {m_object1[pair], m_object2[pair], pair, m_generation};
+    }
+}
+
+void MCContactManifold::removeContacts(MCObject & object)
+{
+    // The pairs stay, but without contacts they are skipped.
+    for (MCUint pair = 0; pair < m_object1.size(); pair++)
+    {
+        if (m_object1[pair] == &object || m_object2[pair] == &object)
+        {
+            m_deepest1[pair] = -1;
+            m_deepest2[pair] = -1;
+        }
+    }
+}
+
+void MCContactManifold::clear()
+{
+    m_object1.clear();
+    m_object2.clear();
+    m_deepest1.clear();
+    m_deepest2.clear();
+
+    m_pair.clear();
+    m_contactPoint.clear();
+    m_contactNormal.clear();
+    m_interpenetrationDepth.clear();
+
+    // Invalidate all slots at once.
+    if (++m_generation == 0)
+    {
+        m_generation = 1;
+        rehash(static_cast<MCUint>(m_slots.size()));
+    }
+}
+
+bool MCContactManifold::empty() const
+{
+    return m_object1.empty();
+}
+
+MCUint MCContactManifold::pairCount() const
+{
+    return static_cast<MCUint>(m_object1.size());
+}
+
+MCObject & MCContactManifold::object1(MCUint pair) const
+{
+    assert(pair < m_object1.size());
+    return *m_object1[pair];
+}
+
+MCObject & MCContactManifold::object2(MCUint pair) const
+{
+    assert(pair < m_object2.size());
+    return *m_object2[pair];
+}
+
+int MCContactManifold::deepestContact(MCUint pair, const MCObject & object) const
+{
+    assert(pair < m_object1.size());
+    return m_object1[pair] == &object ? m_deepest1[pair] : m_deepest2[pair];
+}
+
+const MCVector2dF & MCContactManifold::contactPoint(MCUint contact) const
+{
+    return m_contactPoint[contact];
+}
+
+const MCVector2dF & MCContactManifold::contactNormal(MCUint contact) const
+{
+    return m_contactNormal[contact];
+}
+
+MCFloat MCContactManifold::interpenetrationDepth(MCUint contact) const
+{
+    return m_interpenetrationDepth[contact];
+}
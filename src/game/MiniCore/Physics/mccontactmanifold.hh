@@ -0,0 +1,131 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2010 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+#ifndef MCCONTACTMANIFOLD_HH
+#define MCCONTACTMANIFOLD_HH
+
+#include "mcmacros.hh"
+#include "mctypes.hh"
+#include "mcvector2d.hh"
+
+#include <vector>
+
+class MCObject;
+
+/*! \class MCContactManifold
+ *  \brief Collision contacts of the current world step.
+ *
+ * Contacts are stored in flat arrays and bucketed by object pair. For both
+ * objects of a pair the deepest contact against the other one is tracked
+ * as contacts are added, because that's what MCImpulseGenerator uses.
+ * Pairs can be iterated by index.
+ *
+ * MCWorld owns the manifold and clears it whenever the contacts have been
+ * processed. Clearing only resets the arrays, so the memory is reused on
+ * the next step.
+ */
+class MCContactManifold
+{
+public:
+
+    //! Constructor.
+    MCContactManifold();
+
+    /*! \brief Add a contact.
+     *  \param object The object the contact is added to.
+     *  \param otherObject The contacting object.
+     *  \param contactPoint The point of contact.
+     *  \param contactNormal The contact normal pointing away from otherObject.
+     *  \param interpenetrationDepth The depth of interpenetration.
+     */
+    void addContact(MCObject & object, MCObject & otherObject,
+        const MCVector2dF & contactPoint,
+        const MCVector2dF & contactNormal,
+        MCFloat interpenetrationDepth);
+
+    //! Drop the contacts of the given object, e.g. when it's removed from the world.
+    void removeContacts(MCObject & object);
+
+    //! Remove all contacts (O(1)).
+    void clear();
+
+    //! \return true if there are no contacts.
+    bool empty() const;
+
+    //! \return Number of object pairs in contact.
+    MCUint pairCount() const;
+
+    //! \return The first object of the given pair.
+    MCObject & object1(MCUint pair) const;
+
+    //! \return The second object of the given pair.
+    MCObject & object2(MCUint pair) const;
+
+    /*! \return Index of the deepest contact of the given object against the
+     *  other object of the pair, or -1 if there are none with positive depth.
+     *  \param object Either object of the pair. */
+    int deepestContact(MCUint pair, const MCObject & object) const;
+
+    //! \return The contact point of the given contact.
+    const MCVector2dF & contactPoint(MCUint contact) const;
+
+    //! \return The contact normal of the given contact.
+    const MCVector2dF & contactNormal(MCUint contact) const;
+
+    //! \return The interpenetration depth of the given contact.
+    MCFloat interpenetrationDepth(MCUint contact) const;
+
+private:
+
+    DISABLE_COPY(MCContactManifold);
+    DISABLE_ASSI(MCContactManifold);
+
+    //! Open addressing hash slot mapping an object pair to its index.
+    struct PairSlot
+    {
+        MCObject * object1;
+        MCObject * object2;
+        MCUint pair;
+
+        //! The slot is free if this isn't the current generation.
+        MCUint generation;
+    };
+
+    MCUint findOrAddPair(MCObject & object1, MCObject & object2);
+
+    void rehash(MCUint size);
+
+    void updateDeepest(int & deepest, MCUint contact);
+
+    // Pairs
+    std::vector<MCObject *> m_object1;
+    std::vector<MCObject *> m_object2;
+    std::vector<int> m_deepest1;
+    std::vector<int> m_deepest2;
+
+    // Contacts
+    std::vector<MCUint> m_pair;
+    std::vector<MCVector2dF> m_contactPoint;
+    std::vector<MCVector2dF> m_contactNormal;
+    std::vector<MCFloat> m_interpenetrationDepth;
+
+    std::vector<PairSlot> m_slots;
+    MCUint m_generation;
+};
+
+#endif // MCCONTACTMANIFOLD_HH
@@ -27,15 +27,30 @@ MCDragForceGenerator::MCDragForceGenerator(MCFloat coeff1, MCFloat coeff2)
 {}
 
 void MCDragForceGenerator::updateForce(MCObject & object)
+{
+  applyDrag(object, m_coeff1, m_coeff2);
+}
+
+void MCDragForceGenerator::applyDrag(MCObject & object, MCFloat coeff1, MCFloat coeff2)
 {
   MCVector3d<MCFloat> force(object.physicsComponent().velocity());
   MCFloat v = force.length();
-  v = m_coeff1 * v + m_coeff2 * v * v;
+  v = coeff1 * v + coeff2 * v * v;
   force.normalize();
   force *= -v;
   object.physicsComponent().addForce(force);
 }
 
+MCFloat MCDragForceGenerator::coeff1() const
+{
+  return m_coeff1;
+}
+
+MCFloat MCDragForceGenerator::coeff2() const
+{
+  return m_coeff2;
+}
+
 MCDragForceGenerator::~MCDragForceGenerator()
 {
 }
@@ -40,6 +40,16 @@ public:
     //! \reimp
     virtual void updateForce(MCObject & object);
 
+    /*! Apply drag with the given coefficients to the object.
+     *  Used by MCForceRegistry to update all drag generators in one loop. */
+    static void applyDrag(MCObject & object, MCFloat coeff1, MCFloat coeff2);
+
+    //! Return linear coefficient.
+    MCFloat coeff1() const;
+
+    //! Return quadratic coefficient.
+    MCFloat coeff2() const;
+
 private:
 
     DISABLE_COPY(MCDragForceGenerator);
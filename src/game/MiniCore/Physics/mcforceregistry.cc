@@ -19,6 +19,28 @@
 
 #include "mcobject.hh"
 #include "mcforceregistry.hh"
+#include "mcdragforcegenerator.hh"
+#include "mcfrictiongenerator.hh"
+
+#include <algorithm>
+
+namespace {
+
+template<typename Entry>
+void removeEntries(std::vector<Entry> & entries, const MCForceGenerator * generator, MCObject & object)
+{
+    for (MCUint i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].object == &object && (!generator || entries[i].generator == generator))
+        {
+            entries[i] = entries.back();
+            entries.pop_back();
+            i--;
+        }
+    }
+}
+
+}
 
 MCForceRegistry::MCForceRegistry()
 : m_registryHash()
@@ -26,23 +48,53 @@ MCForceRegistry::MCForceRegistry()
 
 void MCForceRegistry::update()
 {
-    auto iter = m_registryHash.begin();
-    while (iter != m_registryHash.end())
+    for (const FrictionEntry & entry : m_frictions)
     {
-        Registry & registry = iter->second;
-        for (MCUint i = 0; i < registry.size(); i++)
+        if (entry.object->index() != -1 && entry.generator->enabled())
         {
-            if (iter->first->index() != -1)
-            {
-                if (registry[i]->enabled())
-                {
-                    registry[i]->updateForce(*iter->first);
-                }
-            }
+            MCFrictionGenerator::applyFriction(*entry.object, entry.coeffLinTot, entry.coeffRotTot);
+        }
+    }
+
+    for (const DragEntry & entry : m_drags)
+    {
+        if (entry.object->index() != -1 && entry.generator->enabled())
+        {
+            MCDragForceGenerator::applyDrag(*entry.object, entry.coeff1, entry.coeff2);
         }
+    }
+
+    for (const GenericEntry & entry : m_generics)
+    {
+        if (entry.object->index() != -1 && entry.generator->enabled())
+        {
+            entry.generator->updateForce(*entry.object);
+        }
+    }
+}
 
-        iter++;
+void MCForceRegistry::addEntry(MCForceGenerator & generator, MCObject & object)
+{
+    // The concrete type is resolved only once here, not on every update.
+    if (auto friction = dynamic_cast<MCFrictionGenerator *>(&generator))
+    {
+        m_frictions.push_back({&object, friction, friction->coeffLinTot(), friction->coeffRotTot()});
     }
+    else if (auto drag = dynamic_cast<MCDragForceGenerator *>(&generator))
+    {
+        m_drags.push_back({&object, drag, drag->coeff1(), drag->coeff2()});
+    }
+    else
+    {
+        m_generics.push_back({&object, &generator});
+    }
+}
+
+void MCForceRegistry::removeEntry(const MCForceGenerator & generator, MCObject & object)
+{
+    removeEntries(m_frictions, &generator, object);
+    removeEntries(m_drags, &generator, object);
+    removeEntries(m_generics, &generator, object);
 }
 
 void MCForceRegistry::addForceGenerator(MCForceGeneratorPtr generator, MCObject & object)
@@ -51,6 +103,7 @@ void MCForceRegistry::addForceGenerator(MCForceGeneratorPtr generator, MCObject
     if (find(registry.begin(), registry.end(), generator) == registry.end())
     {
         registry.push_back(generator);
+        addEntry(*generator, object);
     }
 }
 
@@ -64,6 +117,7 @@ void MCForceRegistry::removeForceGenerator(MCForceGeneratorPtr generator, MCObje
         {
             if (registry[i] == generator && iter->first == &object)
             {
+                removeEntry(*generator, object);
                 registry[i] = registry.back();
                 registry.pop_back();
                 break;
@@ -82,11 +136,17 @@ void MCForceRegistry::removeForceGenerators(MCObject & object)
     auto iter = m_registryHash.find(&object);
     if (iter != m_registryHash.end())
     {
+        removeEntries(m_frictions, nullptr, object);
+        removeEntries(m_drags, nullptr, object);
+        removeEntries(m_generics, nullptr, object);
         m_registryHash.erase(iter);
     }
 }
 
 void MCForceRegistry::clear()
 {
+    m_frictions.clear();
+    m_drags.clear();
+    m_generics.clear();
     m_registryHash.clear();
 }
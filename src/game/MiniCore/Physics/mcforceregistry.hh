@@ -25,13 +25,17 @@
 
 #include <map>
 #include <memory>
-#include <set>
 #include <vector>
 
 class MCObject;
 
 /*! \class MCForceRegistry
  *  \brief MCForceRegistry stores object-force -pairs
+ *
+ * The generators are grouped by their concrete type. Friction and drag
+ * generators, which every car and many other objects have, are stored
+ * with their parameters in flat arrays and updated in tight loops without
+ * virtual calls. Other generators are called through updateForce().
  */
 class MCForceRegistry
 {
@@ -65,7 +69,39 @@ private:
   DISABLE_COPY(MCForceRegistry);
   DISABLE_ASSI(MCForceRegistry);
 
-  // Prefer map and set here for iteration performance.
+  struct FrictionEntry
+  {
+      MCObject * object;
+      const MCForceGenerator * generator;
+      MCFloat coeffLinTot;
+      MCFloat coeffRotTot;
+  };
+
+  struct DragEntry
+  {
+      MCObject * object;
+      const MCForceGenerator * generator;
+      MCFloat coeff1;
+      MCFloat coeff2;
+  };
+
+  struct GenericEntry
+  {
+      MCObject * object;
+      MCForceGenerator * generator;
+  };
+
+  void addEntry(MCForceGenerator & generator, MCObject & object);
+
+  void removeEntry(const MCForceGenerator & generator, MCObject & object);
+
+  // The typed groups. Raw pointers are fine, because
+  // m_registryHash owns the generators.
+  std::vector<FrictionEntry> m_frictions;
+  std::vector<DragEntry>     m_drags;
+  std::vector<GenericEntry>  m_generics;
+
+  // Owning front end for add and remove. Not touched in update().
   typedef std::vector<MCForceGeneratorPtr> Registry;
   typedef std::map<MCObject *, Registry> RegistryHash;
   RegistryHash m_registryHash;
@@ -33,6 +33,11 @@ MCFrictionGenerator::MCFrictionGenerator(MCFloat coeffLin, MCFloat coeffRot)
 {}
 
 void MCFrictionGenerator::updateForce(MCObject & object)
+{
+    applyFriction(object, m_coeffLinTot, m_coeffRotTot);
+}
+
+void MCFrictionGenerator::applyFriction(MCObject & object, MCFloat coeffLinTot, MCFloat coeffRotTot)
 {
     // Simulated friction caused by linear motion.
     MCPhysicsComponent & physicsComponent = object.physicsComponent();
@@ -40,21 +45,31 @@ void MCFrictionGenerator::updateForce(MCObject & object)
     const MCVector2d<MCFloat> v(physicsComponent.velocity().normalizedFast());
     if (length >= 1.0)
     {
-        physicsComponent.addForce(-v * m_coeffLinTot * physicsComponent.mass());
+        physicsComponent.addForce(-v * coeffLinTot * physicsComponent.mass());
     }
     else
     {
-        physicsComponent.addForce(-v * length * m_coeffLinTot * physicsComponent.mass());
+        physicsComponent.addForce(-v * length * coeffLinTot * physicsComponent.mass());
     }
 
     // Simulated friction caused by angular torque.
     if (object.shape())
     {
         const MCFloat a = physicsComponent.angularVelocity();
-        physicsComponent.addAngularImpulse(-a * m_coeffRotTot);
+        physicsComponent.addAngularImpulse(-a * coeffRotTot);
     }
 }
 
+MCFloat MCFrictionGenerator::coeffLinTot() const
+{
+    return m_coeffLinTot;
+}
+
+MCFloat MCFrictionGenerator::coeffRotTot() const
+{
+    return m_coeffRotTot;
+}
+
 MCFrictionGenerator::~MCFrictionGenerator()
 {
 }
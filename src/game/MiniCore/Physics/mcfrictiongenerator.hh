@@ -49,6 +49,16 @@ public:
     //! \reimp
     virtual void updateForce(MCObject & object);
 
+    /*! Apply friction with the given total coefficients to the object.
+     *  Used by MCForceRegistry to update all friction generators in one loop. */
+    static void applyFriction(MCObject & object, MCFloat coeffLinTot, MCFloat coeffRotTot);
+
+    //! Return linear friction coefficient scaled by gravity.
+    MCFloat coeffLinTot() const;
+
+    //! Return rotational friction coefficient scaled by gravity.
+    MCFloat coeffRotTot() const;
+
 private:
 
     DISABLE_COPY(MCFrictionGenerator);
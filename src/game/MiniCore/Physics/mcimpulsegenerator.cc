@@ -18,29 +18,40 @@
 //
 
 #include "mcimpulsegenerator.hh"
-#include "mccontact.hh"
+#include "mccontactmanifold.hh"
 #include "mcobject.hh"
 #include "mcphysicscomponent.hh"
 #include "mcmathutil.hh"
 #include "mcshape.hh"
 
+#include <algorithm>
+#include <utility>
+
 MCImpulseGenerator::MCImpulseGenerator()
 {}
 
-MCContact * MCImpulseGenerator::getDeepestInterpenetration(
-    const std::vector<MCContact *> & contacts)
+int MCImpulseGenerator::deepestContact(
+    const MCContactManifold & manifold, MCUint pair, MCObject *& pa, MCObject *& pb)
 {
-    MCFloat maxDepth = 0;
-    MCContact * bestContact = nullptr;
-    for (MCContact * contact : contacts)
+    // Handle the pair from the object that comes first in the world,
+    // or from the other one if the first one has no contacts. Sleeping
+    // objects are not in the world's object vector (index -1), so they
+    // come last and never handle a pair themselves.
+    pa = &manifold.object1(pair);
+    pb = &manifold.object2(pair);
+    if (static_cast<unsigned int>(pb->index()) < static_cast<unsigned int>(pa->index()))
     {
-        if (contact->interpenetrationDepth() > maxDepth)
-        {
-            maxDepth = contact->interpenetrationDepth();
-            bestContact = contact;
-        }
+        std::swap(pa, pb);
+    }
+
+    int contact = manifold.deepestContact(pair, *pa);
+    if (contact < 0 && pb->index() >= 0)
+    {
+        std::swap(pa, pb);
+        contact = manifold.deepestContact(pair, *pa);
     }
-    return bestContact;
+
+    return pa->index() >= 0 ? contact : -1;
 }
 
 void MCImpulseGenerator::displace(
@@ -57,7 +68,7 @@ void MCImpulseGenerator::displace(
 }
 
 void MCImpulseGenerator::generateImpulsesFromContact(
-    MCObject & pa, MCObject & pb, const MCContact & contact,
+    MCObject & pa, MCObject & pb, const MCVector3dF & contactPoint,
     const MCVector3dF & linearImpulse,
     MCFloat restitution)
 {
@@ -66,8 +77,6 @@ void MCImpulseGenerator::generateImpulsesFromContact(
         const MCFloat invMassA = pa.physicsComponent().invMass();
         const MCFloat invMassB = pb.physicsComponent().invMass();
 
-        const MCVector3dF & contactPoint(contact.contactPoint());
-
         // Linear component
         const MCFloat massScaling = invMassA / (invMassA + invMassB);
         const MCFloat effRestitution = 1.0 + restitution;
@@ -81,70 +90,91 @@ void MCImpulseGenerator::generateImpulsesFromContact(
     }
 }
 
-void MCImpulseGenerator::resolvePositions(std::vector<MCObject *> & objs, MCFloat accuracy)
+void MCImpulseGenerator::resolvePositions(const MCContactManifold & manifold, MCFloat accuracy)
 {
-    for (MCObject * object : objs)
+    const MCUint pairCount = manifold.pairCount();
+    for (MCUint pair = 0; pair < pairCount; pair++)
     {
-        auto iter(object->contacts().begin());
-        for (; iter != object->contacts().end(); iter++)
+        MCObject * pa = nullptr;
+        MCObject * pb = nullptr;
+        const int contact = deepestContact(manifold, pair, pa, pb);
+        if (contact >= 0)
         {
-            const MCContact * contact = getDeepestInterpenetration(iter->second);
-            if (contact)
-            {
-                MCObject & pa(*object);
-                MCObject & pb(contact->object());
-
-                const MCVector3dF displacement(
-                    contact->contactNormal() * contact->interpenetrationDepth() * accuracy);
+            const MCVector3dF displacement(
+                manifold.contactNormal(contact) * manifold.interpenetrationDepth(contact) * accuracy);
 
-                displace(pa, pb, displacement);
-                displace(pb, pa, -displacement);
-
-                pb.deleteContacts(pa);
-                pa.deleteContacts(pb);
-            }
+            displace(*pa, *pb, displacement);
+            displace(*pb, *pa, -displacement);
         }
-
-        object->deleteContacts();
     }
 }
 
-void MCImpulseGenerator::generateImpulsesFromDeepestContacts(std::vector<MCObject *> & objs)
+void MCImpulseGenerator::generateImpulsesFromDeepestContacts(const MCContactManifold & manifold)
 {
-    for (MCObject * object : objs)
+    // Walk the contacts per object in world order: each object handles
+    // only the first pair it has contacts in, which also consumes the
+    // contacts of the other object of that pair. Sleeping objects (index -1)
+    // don't walk their contacts.
+    const MCUint pairCount = manifold.pairCount();
+    m_walk.clear();
+    m_consumed.assign(pairCount * 2, 0);
+    for (MCUint pair = 0; pair < pairCount; pair++)
     {
-        auto iter(object->contacts().begin());
-        for (; iter != object->contacts().end(); iter++)
+        for (MCUint side = 0; side < 2; side++)
         {
-            const MCContact * contact = getDeepestInterpenetration(iter->second);
-            if (contact)
+            const MCObject & object(side ? manifold.object2(pair) : manifold.object1(pair));
+            if (object.index() >= 0 && manifold.deepestContact(pair, object) >= 0)
             {
-                MCObject & pa(*object);
-                MCObject & pb(contact->object());
-
-                const MCFloat restitution(
-                    std::min(pa.physicsComponent().restitution(), pb.physicsComponent().restitution()));
+                m_walk.push_back(std::make_pair(object.index(), pair * 2 + side));
+            }
+        }
+    }
 
-                const MCVector2dF velocityDelta(pb.physicsComponent().velocity() - pa.physicsComponent().velocity());
-                const MCFloat projection = contact->contactNormal().dot(velocityDelta);
+    std::sort(m_walk.begin(), m_walk.end());
 
-                if (projection > 0)
-                {
-                    const MCVector3dF linearImpulse(
-                        contact->contactNormal() *
-                        contact->contactNormal().dot(velocityDelta));
+    int object = -1;
+    bool handled = false;
+    for (const auto & step : m_walk)
+    {
+        if (step.first != object)
+        {
+            object  = step.first;
+            handled = false;
+        }
 
-                    generateImpulsesFromContact(pa, pb, *contact, linearImpulse, restitution);
-                    generateImpulsesFromContact(pb, pa, *contact, -linearImpulse, restitution);
-                }
+        const MCUint side = step.second;
+        if (handled || m_consumed[side])
+        {
+            continue;
+        }
 
-                // Remove contact with pa from pb, because it was already handled here.
-                pb.deleteContacts(pa);
+        handled = true;
+        m_consumed[side ^ 1] = 1;
 
-                break;
-            }
+        const MCUint pair = side / 2;
+        MCObject * pa = &manifold.object1(pair);
+        MCObject * pb = &manifold.object2(pair);
+        if (side & 1)
+        {
+            std::swap(pa, pb);
         }
 
-        object->deleteContacts();
+        const int contact = manifold.deepestContact(pair, *pa);
+
+        const MCFloat restitution(
+            std::min(pa->physicsComponent().restitution(), pb->physicsComponent().restitution()));
+
+        const MCVector2dF & contactNormal(manifold.contactNormal(contact));
+        const MCVector2dF velocityDelta(pb->physicsComponent().velocity() - pa->physicsComponent().velocity());
+        const MCFloat projection = contactNormal.dot(velocityDelta);
+
+        if (projection > 0)
+        {
+            const MCVector3dF linearImpulse(contactNormal * projection);
+            const MCVector3dF contactPoint(manifold.contactPoint(contact));
+
+            generateImpulsesFromContact(*pa, *pb, contactPoint, linearImpulse, restitution);
+            generateImpulsesFromContact(*pb, *pa, contactPoint, -linearImpulse, restitution);
+        }
     }
 }
@@ -22,10 +22,11 @@
 
 #include "mctypes.hh"
 #include "mcvector3d.hh"
+#include <utility>
 #include <vector>
 
 class MCObject;
-class MCContact;
+class MCContactManifold;
 
 //! Generates impulses due to detected collisions.
 class MCImpulseGenerator
@@ -38,24 +39,33 @@ public:
     //! Destructor.
     ~MCImpulseGenerator() {};
 
-    //! Generate impulses to the given objects according to current contacts.
-    //! Delete contacts.
-    void generateImpulsesFromDeepestContacts(std::vector<MCObject *> & objs);
+    //! Generate impulses according to the deepest contact of the first
+    //! contacting pair of each object that is not sleeping.
+    void generateImpulsesFromDeepestContacts(const MCContactManifold & manifold);
 
-    //! Resolve positions of the given objects according to current contacts.
-    //! Delete contacts.
-    void resolvePositions(std::vector<MCObject *> & objs, MCFloat accuracy);
+    //! Resolve positions according to the deepest contact of each
+    //! contacting object pair.
+    void resolvePositions(const MCContactManifold & manifold, MCFloat accuracy);
 
 private:
 
     void generateImpulsesFromContact(
-        MCObject & pa, MCObject & pb, const MCContact & contact,
+        MCObject & pa, MCObject & pb, const MCVector3dF & contactPoint,
         const MCVector3dF & linearImpulse,
         MCFloat restitution);
 
     void displace(MCObject & pa, MCObject & pb, const MCVector3dF & displacement);
 
-    MCContact * getDeepestInterpenetration(const std::vector<MCContact *> & contacts);
+    /*! Get the deepest contact of the given pair and the objects in the
+     *  order it applies: contact of pa against pb.
+     *  \return Index of the contact or -1 if none. */
+    int deepestContact(const MCContactManifold & manifold, MCUint pair, MCObject *& pa, MCObject *& pb);
+
+    //! Object index and pair side of the contacts to walk, reused between steps.
+    std::vector<std::pair<int, MCUint> > m_walk;
+
+    //! Pair sides whose contacts have already been handled.
+    std::vector<unsigned char> m_consumed;
 };
 
 #endif // MCIMPULSEGENERATOR_HH
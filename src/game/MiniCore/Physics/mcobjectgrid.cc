@@ -21,6 +21,9 @@
 #include "mcphysicscomponent.hh"
 
 #include <algorithm>
+#include <functional>
+
+static const MCUint DIRTY_WORD_BITS = 32;
 
 MCObjectGrid::MCObjectGrid(
     MCFloat x1, MCFloat y1, MCFloat x2, MCFloat y2,
@@ -64,6 +67,16 @@ void MCObjectGrid::setIndexRange(const MCBBox<MCFloat> & bbox)
     m_j1 = static_cast<MCUint>(temp);
 }
 
+void MCObjectGrid::setDirty(MCUint index)
+{
+    m_dirtyCellCache[index / DIRTY_WORD_BITS] |= 1u << (index % DIRTY_WORD_BITS);
+}
+
+void MCObjectGrid::clearDirty(MCUint index)
+{
+    m_dirtyCellCache[index / DIRTY_WORD_BITS] &= ~(1u << (index % DIRTY_WORD_BITS));
+}
+
 void MCObjectGrid::insert(MCObject & object)
 {
     setIndexRange(object.bbox());
@@ -75,8 +88,11 @@ void MCObjectGrid::insert(MCObject & object)
         {
             const int index = j * m_horSize + i;
             GridCell & cell = m_matrix[index];
-            cell.m_objects.insert(&object);
-            m_dirtyCellCache.insert(&cell);
+            if (std::find(cell.m_objects.begin(), cell.m_objects.end(), &object) == cell.m_objects.end())
+            {
+                cell.m_objects.push_back(&object);
+            }
+            setDirty(index);
         }
     }
 }
@@ -92,16 +108,17 @@ bool MCObjectGrid::remove(MCObject & object)
         {
             const int index = j * m_horSize + i;
             GridCell & cell = m_matrix[index];
-            const auto iter(cell.m_objects.find(&object));
-            const auto end(cell.m_objects.end());
-            if (iter != end)
+            const auto iter(std::find(cell.m_objects.begin(), cell.m_objects.end(), &object));
+            if (iter != cell.m_objects.end())
             {
-                cell.m_objects.erase(iter);
+                // Order doesn't matter: swap with the last one and pop.
+                *iter = cell.m_objects.back();
+                cell.m_objects.pop_back();
                 removed = true;
 
                 if (!cell.m_objects.size())
                 {
-                    m_dirtyCellCache.erase(&cell);
+                    clearDirty(index);
                 }
             }
         }
@@ -120,19 +137,13 @@ void MCObjectGrid::removeAll()
         }
     }
 
-    m_dirtyCellCache.clear();
+    std::fill(m_dirtyCellCache.begin(), m_dirtyCellCache.end(), 0);
 }
 
 void MCObjectGrid::build()
 {
     m_matrix = new MCObjectGrid::GridCell[m_horSize * m_verSize];
-    for (MCUint j = 0; j < m_verSize; j++)
-    {
-        for (MCUint i = 0; i < m_horSize; i++)
-        {
-            m_matrix[j * m_horSize + i].m_objects = MCObjectGrid::ObjectSet();
-        }
-    }
+    m_dirtyCellCache.assign((m_horSize * m_verSize + DIRTY_WORD_BITS - 1) / DIRTY_WORD_BITS, 0);
 }
 
 void MCObjectGrid::getBBoxCollisions(MCObjectGrid::CollisionVector & result)
@@ -142,47 +153,120 @@ void MCObjectGrid::getBBoxCollisions(MCObjectGrid::CollisionVector & result)
     // Optimization: ignore collisions between sleeping objects.
     // Note that stationary objects are also sleeping objects.
 
-    auto cellIter = m_dirtyCellCache.begin();
-    while (cellIter != m_dirtyCellCache.end())
+    for (MCUint word = 0; word < m_dirtyCellCache.size(); word++)
     {
-        bool hadCollisions = false;
-        const MCObjectGrid::ObjectSet & objects = (*cellIter)->m_objects;
-
-        auto outer(objects.begin());
-        const auto end(objects.end());
-        while (outer != end)
+        MCUint bits = m_dirtyCellCache[word];
+        for (MCUint bit = 0; bits; bit++, bits >>= 1)
         {
-            MCObject * obj1 = *outer;
-            auto inner = objects.begin();
-            while (inner != end)
+            if (!(bits & 1))
             {
-                MCObject * obj2 = *inner;
-                if (obj1 != obj2 &&
-                    &obj1->parent() != obj2 &&
-                    &obj2->parent() != obj1 &&
-                    (!obj1->physicsComponent().isSleeping() || !obj2->physicsComponent().isSleeping()) &&
-                    (obj1->collisionLayer() == obj2->collisionLayer() || obj1->collisionLayer() == -1) &&
-                    (obj1->bbox().intersects(obj2->bbox())))
+                continue;
+            }
+
+            const MCUint index = word * DIRTY_WORD_BITS + bit;
+            const std::vector<MCObject *> & objects = m_matrix[index].m_objects;
+            const MCUint count = static_cast<MCUint>(objects.size());
+
+            bool hadCollisions = false;
+            for (MCUint outer = 0; outer < count; outer++)
+            {
+                MCObject * obj1 = objects[outer];
+                for (MCUint inner = outer + 1; inner < count; inner++)
                 {
-                    result[obj1].insert(obj2);
-                    hadCollisions = true;
+                    if (addPossibleCollision(*obj1, *objects[inner], result))
+                    {
+                        hadCollisions = true;
+                    }
                 }
-
-                inner++;
             }
 
-            outer++;
+            if (!hadCollisions)
+            {
+                clearDirty(index);
+            }
         }
+    }
+
+    removeDuplicates(result);
+}
+
+void MCObjectGrid::getBBoxCollisions(
+    const std::vector<MCObject *> & objects, MCObjectGrid::CollisionVector & result)
+{
+    result.clear();
+
+    for (MCObject * obj1 : objects)
+    {
+        obj1->restoreIndexRange(&m_i0, &m_i1, &m_j0, &m_j1);
 
-        if (!hadCollisions)
+        for (MCUint j = m_j0; j <= m_j1; j++)
         {
-            cellIter = m_dirtyCellCache.erase(cellIter);
+            for (MCUint i = m_i0; i <= m_i1; i++)
+            {
+                const std::vector<MCObject *> & cellObjects = m_matrix[j * m_horSize + i].m_objects;
+
+                // Skip objects that are not in the grid at all.
+                if (std::find(cellObjects.begin(), cellObjects.end(), obj1) == cellObjects.end())
+                {
+                    continue;
+                }
+
+                for (MCObject * obj2 : cellObjects)
+                {
+                    if (obj1 != obj2)
+                    {
+                        addPossibleCollision(*obj1, *obj2, result);
+                    }
+                }
+            }
         }
-        else
+    }
+
+    removeDuplicates(result);
+}
+
+bool MCObjectGrid::addPossibleCollision(MCObject & obj1, MCObject & obj2, CollisionVector & result)
+{
+    if (&obj1.parent() != &obj2 &&
+        &obj2.parent() != &obj1 &&
+        (!obj1.physicsComponent().isSleeping() || !obj2.physicsComponent().isSleeping()) &&
+        (obj1.bbox().intersects(obj2.bbox())))
+    {
+        // Layer -1 collides with all layers, but only that way around.
+        const bool sameLayer = obj1.collisionLayer() == obj2.collisionLayer();
+        const bool test12 = sameLayer || obj1.collisionLayer() == -1;
+        const bool test21 = sameLayer || obj2.collisionLayer() == -1;
+        if (test12 || test21)
         {
-            cellIter++;
+            if (std::less<MCObject *>()(&obj1, &obj2))
+            {
+                result.push_back({&obj1, &obj2, test12, test21});
+            }
+            else
+            {
+                result.push_back({&obj2, &obj1, test21, test12});
+            }
+
+            return true;
         }
     }
+
+    return false;
+}
+
+void MCObjectGrid::removeDuplicates(CollisionVector & result)
+{
+    // Objects sharing several cells were found once per shared cell.
+    std::sort(result.begin(), result.end(),
+        [] (const PossibleCollision & a, const PossibleCollision & b) {
+            return std::less<MCObject *>()(a.object1, b.object1) ||
+                (a.object1 == b.object1 && std::less<MCObject *>()(a.object2, b.object2));
+        });
+
+    result.erase(std::unique(result.begin(), result.end(),
+        [] (const PossibleCollision & a, const PossibleCollision & b) {
+            return a.object1 == b.object1 && a.object2 == b.object2;
+        }), result.end());
 }
 
 void MCObjectGrid::getObjectsWithinDistance(
@@ -195,19 +279,14 @@ void MCObjectGrid::getObjectsWithinDistance(
     d *= d;
 
     resultObjs.clear();
-    MCObjectGrid::ObjectSet::iterator iter;
-    MCObject * p = nullptr;
 
     for (MCUint j = m_j0; j <= m_j1; j++)
     {
         for (MCUint i = m_i0; i <= m_i1; i++)
         {
             const int index = j * m_horSize + i;
-            const auto end(m_matrix[index].m_objects.end());
-            iter = m_matrix[index].m_objects.begin();
-            while (iter != end)
+            for (MCObject * p : m_matrix[index].m_objects)
             {
-                p = *iter;
                 const MCFloat x2 = x - p->location().i();
                 const MCFloat y2 = y - p->location().j();
 
@@ -215,8 +294,6 @@ void MCObjectGrid::getObjectsWithinDistance(
                 {
                     resultObjs.insert(p);
                 }
-
-                iter++;
             }
         }
     }
@@ -229,24 +306,18 @@ void MCObjectGrid::getObjectsWithinBBox(
     setIndexRange(bbox);
 
     resultObjs.clear();
-    MCObjectGrid::ObjectSet::iterator iter;
-    MCObject * p = nullptr;
 
     for (MCUint j = m_j0; j <= m_j1; j++)
     {
         for (MCUint i = m_i0; i <= m_i1; i++)
         {
             const int index = j * m_horSize + i;
-            iter = m_matrix[index].m_objects.begin();
-            while (iter != m_matrix[index].m_objects.end())
+            for (MCObject * p : m_matrix[index].m_objects)
             {
-                p = *iter;
                 if (bbox.intersects(p->bbox()))
                 {
                     resultObjs.insert(p);
                 }
-
-                iter++;
             }
         }
     }
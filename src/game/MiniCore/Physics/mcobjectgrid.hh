@@ -25,10 +25,10 @@
 #include "mcobject.hh"
 
 #include <unordered_set>
-#include <map>
-#include <set>
 #include <vector>
 
+class MCObject;
+
 /*! A grid used for fast collision detection.
  *  The tree stores objects inherited from MCObject -class.
  *  A (2d) collision test for a given object can be requested against all
@@ -38,12 +38,28 @@ class MCObjectGrid
 public:
 
     typedef std::unordered_set<MCObject *> ObjectSet;
-    typedef std::map<MCObject *, std::set<MCObject *> > CollisionVector;
 
-    //! Container for objects.
+    /*! A possible collision between two objects. Every pair is reported only
+     *  once, object1 being the one with the lower address. */
+    struct PossibleCollision
+    {
+        MCObject * object1;
+        MCObject * object2;
+
+        //! Test object1 against object2.
+        bool test12;
+
+        //! Test object2 against object1.
+        bool test21;
+    };
+
+    typedef std::vector<PossibleCollision> CollisionVector;
+
+    /*! Container for objects. A plain array, as cells hold only a few objects
+     *  and its capacity is kept when objects move from cell to cell. */
     struct GridCell
     {
-        ObjectSet m_objects;
+        std::vector<MCObject *> m_objects;
     };
 
     /*! Constructor.
@@ -76,9 +92,17 @@ public:
 
     /*! Get bbox collisions. Collisions between sleeping objects are ignored,
      *  because that gives a huge performance  boost.
-     *  \param result Store the possible collisions here. */
+     *  \param result Store the possible collisions here. Each pair of objects
+     *  is stored once even if they share several cells. The vector is reused,
+     *  so keep passing the same one to avoid allocations. */
     void getBBoxCollisions(CollisionVector & result);
 
+    /*! Get bbox collisions of the given objects only, whether their cells
+     *  are dirty or not. Used to re-test objects that have just moved.
+     *  \param objects The objects to test against their neighbours.
+     *  \param result Store the possible collisions here, as above. */
+    void getBBoxCollisions(const std::vector<MCObject *> & objects, CollisionVector & result);
+
     //! Get bounding box
     const MCBBox<MCFloat> & bbox() const;
 
@@ -90,6 +114,15 @@ private:
     void setIndexRange(const MCBBox<MCFloat> & bbox);
     void build();
 
+    /*! Add obj1 and obj2 to result if their bboxes collide.
+     *  \return true if added. */
+    static bool addPossibleCollision(MCObject & obj1, MCObject & obj2, CollisionVector & result);
+
+    static void removeDuplicates(CollisionVector & result);
+
+    void setDirty(MCUint index);
+    void clearDirty(MCUint index);
+
     MCBBox<MCFloat> m_bbox;
     MCFloat m_leafMaxW, m_leafMaxH;
     MCUint m_horSize, m_verSize;
@@ -98,7 +131,8 @@ private:
     MCFloat m_helpVer;
     MCObjectGrid::GridCell * m_matrix;
 
-    typedef std::set<GridCell *> DirtyCellCache;
+    //! Bitmap of cells that may have collisions, one bit per cell.
+    typedef std::vector<MCUint> DirtyCellCache;
     DirtyCellCache m_dirtyCellCache;
 };
 
@@ -0,0 +1,297 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+#include "mcphysicsbodystore.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace {
+static const MCFloat DAMPING = 0.999f;
+static const MCFloat SLEEP_LIMIT = 0.01f;
+}
+
+MCPhysicsBodyStore & MCPhysicsBodyStore::instance()
+{
+    static thread_local MCPhysicsBodyStore store;
+    return store;
+}
+
+MCPhysicsBodyStore::MCPhysicsBodyStore()
+{
+}
+
+MCVector3dF MCPhysicsBodyStore::Vector3Array::get(MCUint index) const
+{
+    return MCVector3dF(i[index], j[index], k[index]);
+}
+
+void MCPhysicsBodyStore::Vector3Array::set(MCUint index, const MCVector3dF & v)
+{
+    i[index] = v.i();
+    j[index] = v.j();
+    k[index] = v.k();
+}
+
+void MCPhysicsBodyStore::Vector3Array::resize(MCUint size)
+{
+    i.resize(size, 0);
+    j.resize(size, 0);
+    k.resize(size, 0);
+}
+
+void MCPhysicsBodyStore::resize(MCUint size)
+{
+    m_velocity.resize(size);
+    m_acceleration.resize(size);
+    m_force.resize(size);
+    m_linearImpulse.resize(size);
+
+    m_angularVelocity.resize(size, 0);
+    m_angularAcceleration.resize(size, 0);
+    m_angularImpulse.resize(size, 0);
+    m_torque.resize(size, 0);
+    m_invMass.resize(size, 0);
+    m_invMomentOfInertia.resize(size, 0);
+    m_damping.resize(size, 0);
+    m_linearSleepLimit.resize(size, 0);
+    m_angularSleepLimit.resize(size, 0);
+
+    m_linearMark.resize(size, 0);
+    m_angularMark.resize(size, 0);
+    m_belowSleepLimits.resize(size, 0);
+}
+
+MCUint MCPhysicsBodyStore::allocate()
+{
+    MCUint body;
+    if (!m_freeBodies.empty())
+    {
+        body = m_freeBodies.back();
+        m_freeBodies.pop_back();
+    }
+    else
+    {
+        body = static_cast<MCUint>(m_invMass.size());
+        resize(body + 1);
+    }
+
+    m_velocity.set(body, MCVector3dF());
+    m_acceleration.set(body, MCVector3dF());
+    m_force.set(body, MCVector3dF());
+    m_linearImpulse.set(body, MCVector3dF());
+
+    m_angularVelocity[body]     = 0;
+    m_angularAcceleration[body] = 0;
+    m_angularImpulse[body]      = 0;
+    m_torque[body]              = 0;
+    m_invMass[body]             = std::numeric_limits<MCFloat>::max();
+    m_invMomentOfInertia[body]  = std::numeric_limits<MCFloat>::max();
+    m_damping[body]             = DAMPING;
+    m_linearSleepLimit[body]    = SLEEP_LIMIT;
+    m_angularSleepLimit[body]   = SLEEP_LIMIT;
+
+    m_linearMark[body]       = 0;
+    m_angularMark[body]      = 0;
+    m_belowSleepLimits[body] = 0;
+
+    return body;
+}
+
+void MCPhysicsBodyStore::release(MCUint body)
+{
+    assert(body < m_invMass.size());
+    unmark(body);
+    m_freeBodies.push_back(body);
+}
+
+MCVector3dF MCPhysicsBodyStore::velocity(MCUint body) const
+{
+    return m_velocity.get(body);
+}
+
+void MCPhysicsBodyStore::setVelocity(MCUint body, const MCVector3dF & velocity)
+{
+    m_velocity.set(body, velocity);
+}
+
+MCVector3dF MCPhysicsBodyStore::acceleration(MCUint body) const
+{
+    return m_acceleration.get(body);
+}
+
+void MCPhysicsBodyStore::setAcceleration(MCUint body, const MCVector3dF & acceleration)
+{
+    m_acceleration.set(body, acceleration);
+}
+
+MCVector3dF MCPhysicsBodyStore::force(MCUint body) const
+{
+    return m_force.get(body);
+}
+
+void MCPhysicsBodyStore::setForce(MCUint body, const MCVector3dF & force)
+{
+    m_force.set(body, force);
+}
+
+MCVector3dF MCPhysicsBodyStore::linearImpulse(MCUint body) const
+{
+    return m_linearImpulse.get(body);
+}
+
+void MCPhysicsBodyStore::setLinearImpulse(MCUint body, const MCVector3dF & impulse)
+{
+    m_linearImpulse.set(body, impulse);
+}
+
+MCFloat & MCPhysicsBodyStore::angularVelocity(MCUint body)
+{
+    return m_angularVelocity[body];
+}
+
+MCFloat & MCPhysicsBodyStore::angularAcceleration(MCUint body)
+{
+    return m_angularAcceleration[body];
+}
+
+MCFloat & MCPhysicsBodyStore::angularImpulse(MCUint body)
+{
+    return m_angularImpulse[body];
+}
+
+MCFloat & MCPhysicsBodyStore::torque(MCUint body)
+{
+    return m_torque[body];
+}
+
+MCFloat & MCPhysicsBodyStore::invMass(MCUint body)
+{
+    return m_invMass[body];
+}
+
+MCFloat & MCPhysicsBodyStore::invMomentOfInertia(MCUint body)
+{
+    return m_invMomentOfInertia[body];
+}
+
+MCFloat & MCPhysicsBodyStore::damping(MCUint body)
+{
+    return m_damping[body];
+}
+
+MCFloat & MCPhysicsBodyStore::linearSleepLimit(MCUint body)
+{
+    return m_linearSleepLimit[body];
+}
+
+MCFloat & MCPhysicsBodyStore::angularSleepLimit(MCUint body)
+{
+    return m_angularSleepLimit[body];
+}
+
+void MCPhysicsBodyStore::mark(MCUint body, bool angular)
+{
+    m_linearMark[body]  = 1;
+    m_angularMark[body] = angular;
+}
+
+void MCPhysicsBodyStore::unmark(MCUint body)
+{
+    m_linearMark[body]  = 0;
+    m_angularMark[body] = 0;
+}
+
+bool MCPhysicsBodyStore::isMarked(MCUint body) const
+{
+    return m_linearMark[body];
+}
+
+bool MCPhysicsBodyStore::isAngularMarked(MCUint body) const
+{
+    return m_angularMark[body];
+}
+
+bool MCPhysicsBodyStore::isBelowSleepLimits(MCUint body) const
+{
+    return m_belowSleepLimits[body];
+}
+
+void MCPhysicsBodyStore::integrate(MCUint body, MCFloat step)
+{
+    integrate(body, body + 1, step);
+}
+
+void MCPhysicsBodyStore::integrate(MCUint begin, MCUint end, MCFloat step)
+{
+    // The loops are branchless: unmarked bodies compute, too, but keep
+    // their old values.
+
+    // Linear motion
+    for (MCUint n = begin; n < end; n++)
+    {
+        const bool marked = m_linearMark[n];
+        const MCFloat invMass = m_invMass[n];
+        const MCFloat damping = m_damping[n];
+
+        const MCFloat vi = (m_velocity.i[n] + ((m_acceleration.i[n] + m_force.i[n] * invMass) * step + m_linearImpulse.i[n])) * damping;
+        const MCFloat vj = (m_velocity.j[n] + ((m_acceleration.j[n] + m_force.j[n] * invMass) * step + m_linearImpulse.j[n])) * damping;
+        const MCFloat vk = (m_velocity.k[n] + ((m_acceleration.k[n] + m_force.k[n] * invMass) * step + m_linearImpulse.k[n])) * damping;
+
+        m_velocity.i[n] = marked ? vi : m_velocity.i[n];
+        m_velocity.j[n] = marked ? vj : m_velocity.j[n];
+        m_velocity.k[n] = marked ? vk : m_velocity.k[n];
+
+        m_force.i[n] = marked ? 0 : m_force.i[n];
+        m_force.j[n] = marked ? 0 : m_force.j[n];
+        m_force.k[n] = marked ? 0 : m_force.k[n];
+
+        m_linearImpulse.i[n] = marked ? 0 : m_linearImpulse.i[n];
+        m_linearImpulse.j[n] = marked ? 0 : m_linearImpulse.j[n];
+        m_linearImpulse.k[n] = marked ? 0 : m_linearImpulse.k[n];
+    }
+
+    // Angular motion
+    for (MCUint n = begin; n < end; n++)
+    {
+        const bool marked = m_linearMark[n];
+        const bool angularMarked = m_angularMark[n];
+
+        const MCFloat w = (m_angularVelocity[n] +
+            ((m_angularAcceleration[n] + m_torque[n] * m_invMomentOfInertia[n]) * step + m_angularImpulse[n])) * m_damping[n];
+
+        m_angularVelocity[n] = angularMarked ? w : m_angularVelocity[n];
+        m_torque[n]          = marked ? 0 : m_torque[n];
+        m_angularImpulse[n]  = marked ? 0 : m_angularImpulse[n];
+    }
+
+    // Sleep checks. Speed is MCVector3d::lengthFast() written out.
+    for (MCUint n = begin; n < end; n++)
+    {
+        const MCFloat a = std::abs(m_velocity.i[n]);
+        const MCFloat b = std::abs(m_velocity.j[n]);
+        const MCFloat ij = std::max(a, b) + std::min(a, b) / 2;
+        const MCFloat c = std::abs(m_velocity.k[n]);
+        const MCFloat speed = std::max(ij, c) + std::min(ij, c) / 2;
+
+        m_belowSleepLimits[n] = (m_linearMark[n] != 0) &
+            (speed < m_linearSleepLimit[n]) & (m_angularVelocity[n] < m_angularSleepLimit[n]);
+    }
+}
@@ -0,0 +1,141 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+#ifndef MCPHYSICSBODYSTORE_HH
+#define MCPHYSICSBODYSTORE_HH
+
+#include "mcmacros.hh"
+#include "mctypes.hh"
+#include "mcvector3d.hh"
+
+#include <vector>
+
+/*! \class MCPhysicsBodyStore
+ *  \brief Packed motion state of physics bodies.
+ *
+ * The integrated state of every MCPhysicsComponent lives here as a
+ * structure of arrays, and the component only holds the index of its body.
+ * This keeps the motion state of all bodies packed together in memory.
+ * Bodies are still integrated one at a time in MCWorld's object order, so
+ * that forces applied in MCObject::onStepTime() land in the same step.
+ *
+ * There's one store per thread, like there's one MCWorld per thread.
+ * A component must be destroyed in the thread that created it.
+ */
+class MCPhysicsBodyStore
+{
+public:
+
+    //! \return The store of the calling thread.
+    static MCPhysicsBodyStore & instance();
+
+    //! \return Index of a new body at rest.
+    MCUint allocate();
+
+    //! Release the given body for reuse.
+    void release(MCUint body);
+
+    MCVector3dF velocity(MCUint body) const;
+    void setVelocity(MCUint body, const MCVector3dF & velocity);
+
+    MCVector3dF acceleration(MCUint body) const;
+    void setAcceleration(MCUint body, const MCVector3dF & acceleration);
+
+    MCVector3dF force(MCUint body) const;
+    void setForce(MCUint body, const MCVector3dF & force);
+
+    MCVector3dF linearImpulse(MCUint body) const;
+    void setLinearImpulse(MCUint body, const MCVector3dF & impulse);
+
+    MCFloat & angularVelocity(MCUint body);
+    MCFloat & angularAcceleration(MCUint body);
+    MCFloat & angularImpulse(MCUint body);
+    MCFloat & torque(MCUint body);
+    MCFloat & invMass(MCUint body);
+    MCFloat & invMomentOfInertia(MCUint body);
+    MCFloat & damping(MCUint body);
+    MCFloat & linearSleepLimit(MCUint body);
+    MCFloat & angularSleepLimit(MCUint body);
+
+    /*! Mark the body to be integrated by the next call to integrate().
+     *  \param angular Integrate also the angular motion. */
+    void mark(MCUint body, bool angular);
+
+    //! Unmark the given body.
+    void unmark(MCUint body);
+
+    //! \return true if the body is marked.
+    bool isMarked(MCUint body) const;
+
+    //! \return true if the angular motion of the body is marked.
+    bool isAngularMarked(MCUint body) const;
+
+    /*! Integrate the velocity of the given body, if marked, and clear its
+     *  forces and impulses. Moving the object is left to the component. */
+    void integrate(MCUint body, MCFloat step);
+
+    /*! \return true if the body slowed down under its sleep limits
+     *  in the last integration. */
+    bool isBelowSleepLimits(MCUint body) const;
+
+private:
+
+    MCPhysicsBodyStore();
+
+    DISABLE_COPY(MCPhysicsBodyStore);
+    DISABLE_ASSI(MCPhysicsBodyStore);
+
+    void integrate(MCUint begin, MCUint end, MCFloat step);
+
+    struct Vector3Array
+    {
+        std::vector<MCFloat> i, j, k;
+
+        MCVector3dF get(MCUint index) const;
+
+        void set(MCUint index, const MCVector3dF & v);
+
+        void resize(MCUint size);
+    };
+
+    void resize(MCUint size);
+
+    Vector3Array m_velocity;
+    Vector3Array m_acceleration;
+    Vector3Array m_force;
+    Vector3Array m_linearImpulse;
+
+    std::vector<MCFloat> m_angularVelocity;
+    std::vector<MCFloat> m_angularAcceleration;
+    std::vector<MCFloat> m_angularImpulse;
+    std::vector<MCFloat> m_torque;
+    std::vector<MCFloat> m_invMass;
+    std::vector<MCFloat> m_invMomentOfInertia;
+    std::vector<MCFloat> m_damping;
+    std::vector<MCFloat> m_linearSleepLimit;
+    std::vector<MCFloat> m_angularSleepLimit;
+
+    // Flags are bytes rather than bools to keep the loops vectorizable.
+    std::vector<unsigned char> m_linearMark;
+    std::vector<unsigned char> m_angularMark;
+    std::vector<unsigned char> m_belowSleepLimits;
+
+    std::vector<MCUint> m_freeBodies;
+};
+
+#endif // MCPHYSICSBODYSTORE_HH
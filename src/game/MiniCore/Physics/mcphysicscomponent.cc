@@ -16,23 +16,16 @@
 // Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
 // MA  02110-1301, USA.
 //
-
 #include "mcphysicscomponent.hh"
+#include "mcphysicsbodystore.hh"
 #include "mctrigonom.hh"
 
-namespace {
-static const MCFloat DAMPING = 0.999f;
-}
+#include <limits>
 
 MCPhysicsComponent::MCPhysicsComponent()
-    : m_damping(DAMPING)
-    , m_angularAcceleration(0)
-    , m_angularVelocity(0)
-    , m_angularImpulse(0)
-    , m_torque(0)
-    , m_invMass(std::numeric_limits<MCFloat>::max())
+    : m_bodies(MCPhysicsBodyStore::instance())
+    , m_body(m_bodies.allocate())
     , m_mass(0)
-    , m_invMomentOfInertia(std::numeric_limits<MCFloat>::max())
     , m_momentOfInertia(0)
     , m_restitution(0.5f)
     , m_xyFriction(0.0f)
@@ -40,21 +33,19 @@ MCPhysicsComponent::MCPhysicsComponent()
     , m_isSleepingPrevented(false)
     , m_isStationary(false)
     , m_isIntegrating(false)
-    , m_linearSleepLimit(0.01f)
-    , m_angularSleepLimit(0.01f)
 {
 }
 
 void MCPhysicsComponent::addImpulse(const MCVector3dF & impulse, bool)
 {
-    m_linearImpulse += impulse;
+    m_bodies.setLinearImpulse(m_body, m_bodies.linearImpulse(m_body) + impulse);
 
     toggleSleep(false);
 }
 
 void MCPhysicsComponent::addImpulse(const MCVector3dF & impulse, const MCVector3dF & pos, bool isCollision)
 {
-    m_linearImpulse += impulse;
+    m_bodies.setLinearImpulse(m_body, m_bodies.linearImpulse(m_body) + impulse);
     const MCFloat r = (pos - object().location()).lengthFast();
     if (r > 0) {
         addAngularImpulse((-(impulse % (pos - object().location())).k()) / r, isCollision);
@@ -64,21 +55,21 @@ void MCPhysicsComponent::addImpulse(const MCVector3dF & impulse, const MCVector3
 
 void MCPhysicsComponent::addAngularImpulse(MCFloat impulse, bool)
 {
-    m_angularImpulse += impulse;
+    m_bodies.angularImpulse(m_body) += impulse;
 
     toggleSleep(false);
 }
 
 void MCPhysicsComponent::setVelocity(const MCVector3dF & newVelocity)
 {
-    m_velocity = newVelocity;
+    m_bodies.setVelocity(m_body, newVelocity);
 
     toggleSleep(false);
 }
 
-const MCVector3dF & MCPhysicsComponent::velocity() const
+MCVector3dF MCPhysicsComponent::velocity() const
 {
-    return m_velocity;
+    return m_bodies.velocity(m_body);
 }
 
 MCFloat MCPhysicsComponent::speed() const
@@ -88,31 +79,31 @@ MCFloat MCPhysicsComponent::speed() const
 
 void MCPhysicsComponent::setAngularVelocity(MCFloat newVelocity)
 {
-    m_angularVelocity = newVelocity;
+    m_bodies.angularVelocity(m_body) = newVelocity;
 
     toggleSleep(false);
 }
 
 MCFloat MCPhysicsComponent::angularVelocity() const
 {
-    return m_angularVelocity;
+    return m_bodies.angularVelocity(m_body);
 }
 
 void MCPhysicsComponent::setAcceleration(const MCVector3dF & newAcceleration)
 {
-    m_acceleration = newAcceleration;
+    m_bodies.setAcceleration(m_body, newAcceleration);
 
     toggleSleep(false);
 }
 
-const MCVector3dF & MCPhysicsComponent::acceleration() const
+MCVector3dF MCPhysicsComponent::acceleration() const
 {
-    return m_acceleration;
+    return m_bodies.acceleration(m_body);
 }
 
 void MCPhysicsComponent::addForce(const MCVector3dF & force)
 {
-    m_forces += force;
+    m_bodies.setForce(m_body, m_bodies.force(m_body) + force);
 
     toggleSleep(false);
 }
@@ -120,14 +111,14 @@ void MCPhysicsComponent::addForce(const MCVector3dF & force)
 void MCPhysicsComponent::addForce(const MCVector3dF & force, const MCVector3dF & pos)
 {
     addTorque(-(force % (pos - object().location())).k());
-    m_forces += force;
+    m_bodies.setForce(m_body, m_bodies.force(m_body) + force);
 
     toggleSleep(false);
 }
 
 void MCPhysicsComponent::addTorque(MCFloat torque)
 {
-    m_torque += torque;
+    m_bodies.torque(m_body) += torque;
 
     toggleSleep(false);
 }
@@ -140,11 +131,11 @@ void MCPhysicsComponent::setMass(MCFloat newMass, bool stationary)
     {
         if (newMass > 0)
         {
-            m_invMass = 1.0f / newMass;
+            m_bodies.invMass(m_body) = 1.0f / newMass;
         }
         else
         {
-            m_invMass = std::numeric_limits<MCFloat>::max();
+            m_bodies.invMass(m_body) = std::numeric_limits<MCFloat>::max();
         }
 
         m_mass = newMass;
@@ -154,8 +145,8 @@ void MCPhysicsComponent::setMass(MCFloat newMass, bool stationary)
     }
     else
     {
-        m_invMass  = 0;
-        m_mass     = std::numeric_limits<MCFloat>::max();
+        m_bodies.invMass(m_body) = 0;
+        m_mass = std::numeric_limits<MCFloat>::max();
 
         m_isSleeping = true;
 
@@ -165,7 +156,7 @@ void MCPhysicsComponent::setMass(MCFloat newMass, bool stationary)
 
 MCFloat MCPhysicsComponent::invMass() const
 {
-    return m_invMass;
+    return m_bodies.invMass(m_body);
 }
 
 MCFloat MCPhysicsComponent::mass() const
@@ -177,11 +168,11 @@ void MCPhysicsComponent::setMomentOfInertia(MCFloat newMomentOfInertia)
 {
     if (newMomentOfInertia > 0)
     {
-        m_invMomentOfInertia = 1.0f / newMomentOfInertia;
+        m_bodies.invMomentOfInertia(m_body) = 1.0f / newMomentOfInertia;
     }
     else
     {
-        m_invMomentOfInertia = std::numeric_limits<MCFloat>::max();
+        m_bodies.invMomentOfInertia(m_body) = std::numeric_limits<MCFloat>::max();
     }
 
     m_momentOfInertia = newMomentOfInertia;
@@ -194,7 +185,7 @@ MCFloat MCPhysicsComponent::momentOfInertia() const
 
 MCFloat MCPhysicsComponent::invMomentOfInertia() const
 {
-    return m_invMomentOfInertia;
+    return m_bodies.invMomentOfInertia(m_body);
 }
 
 void MCPhysicsComponent::setRestitution(MCFloat newRestitution)
@@ -231,14 +222,19 @@ bool MCPhysicsComponent::isIntegrating() const
 
 void MCPhysicsComponent::resetZ()
 {
-    m_velocity.setK(0);
-    m_forces.setK(0);
+    MCVector3dF velocity(m_bodies.velocity(m_body));
+    velocity.setK(0);
+    m_bodies.setVelocity(m_body, velocity);
+
+    MCVector3dF force(m_bodies.force(m_body));
+    force.setK(0);
+    m_bodies.setForce(m_body, force);
 }
 
 void MCPhysicsComponent::setSleepLimits(MCFloat linearSleepLimit, MCFloat angularSleepLimit)
 {
-    m_linearSleepLimit  = linearSleepLimit;
-    m_angularSleepLimit = angularSleepLimit;
+    m_bodies.linearSleepLimit(m_body)  = linearSleepLimit;
+    m_bodies.angularSleepLimit(m_body) = angularSleepLimit;
 }
 
 void MCPhysicsComponent::toggleSleep(bool state)
@@ -274,77 +270,72 @@ bool MCPhysicsComponent::isStationary() const
     return m_isStationary;
 }
 
-void MCPhysicsComponent::integrate(MCFloat step)
+bool MCPhysicsComponent::markForIntegration()
 {
     // Integrate, if the object is not sleeping and it doesn't
     // have a parent object.
-    if (!object().physicsComponent().isSleeping() && (&object().parent() == &object()))
+    if (!m_isSleeping && (&object().parent() == &object()))
     {
-        m_isIntegrating = true;
-
-        integrateLinear(step);
-        integrateAngular(step);
-        object().checkBoundaries();
-
-        if (m_velocity.lengthFast() < m_linearSleepLimit &&
-            m_angularVelocity       < m_angularSleepLimit)
-        {
-            toggleSleep(true);
-            reset();
-        }
-
-        m_forces.setZero();
-        m_linearImpulse.setZero();
-        m_angularImpulse = 0.0f;
-
-        object().translate(object().location() + m_velocity);
-
-        m_isIntegrating = false;
+        m_bodies.mark(m_body, object().shape() && m_momentOfInertia > 0.0f);
+        return true;
     }
-}
 
-void MCPhysicsComponent::integrateLinear(MCFloat step)
-{
-    MCVector3dF totAcceleration(m_acceleration);
-    totAcceleration += m_forces * m_invMass;
-    m_velocity      += totAcceleration * step + m_linearImpulse;
-    m_velocity      *= m_damping;
+    return false;
 }
 
-void MCPhysicsComponent::integrateAngular(MCFloat step)
+void MCPhysicsComponent::finishIntegration(MCFloat step)
 {
-    if (object().shape() && m_momentOfInertia > 0.0f)
+    if (!m_bodies.isMarked(m_body))
     {
-        MCFloat totAngularAcceleration(m_angularAcceleration);
-        totAngularAcceleration += m_torque * m_invMomentOfInertia;
-        m_angularVelocity      += totAngularAcceleration * step + m_angularImpulse;
-        m_angularVelocity      *= m_damping;
+        return;
+    }
+
+    m_isIntegrating = true;
 
-        const MCFloat newAngle = object().angle() + MCTrigonom::radToDeg(m_angularVelocity * step);
+    if (m_bodies.isAngularMarked(m_body))
+    {
+        const MCFloat newAngle = object().angle() + MCTrigonom::radToDeg(m_bodies.angularVelocity(m_body) * step);
         object().rotate(newAngle, false);
     }
 
-    m_torque = 0.0f;
+    const bool belowSleepLimits = m_bodies.isBelowSleepLimits(m_body);
+    m_bodies.unmark(m_body);
+
+    object().checkBoundaries();
+
+    if (belowSleepLimits)
+    {
+        toggleSleep(true);
+        reset();
+    }
+
+    object().translate(object().location() + m_bodies.velocity(m_body));
+
+    m_isIntegrating = false;
 }
 
 void MCPhysicsComponent::stepTime(MCFloat step)
 {
-    integrate(step);
+    if (markForIntegration())
+    {
+        m_bodies.integrate(m_body, step);
+        finishIntegration(step);
+    }
 }
 
 void MCPhysicsComponent::reset()
 {
     // Reset linear motion
-    m_forces.setZero();
-    m_velocity.setZero();
-    m_acceleration.setZero();
-    m_linearImpulse.setZero();
+    m_bodies.setForce(m_body, MCVector3dF());
+    m_bodies.setVelocity(m_body, MCVector3dF());
+    m_bodies.setAcceleration(m_body, MCVector3dF());
+    m_bodies.setLinearImpulse(m_body, MCVector3dF());
 
     // Reset angular motion
-    m_torque              = 0.0f;
-    m_angularAcceleration = 0.0f;
-    m_angularVelocity     = 0.0f;
-    m_angularImpulse      = 0.0f;
+    m_bodies.torque(m_body)              = 0.0f;
+    m_bodies.angularAcceleration(m_body) = 0.0f;
+    m_bodies.angularVelocity(m_body)     = 0.0f;
+    m_bodies.angularImpulse(m_body)      = 0.0f;
 
     for (auto child: object().children())
     {
@@ -354,4 +345,5 @@ void MCPhysicsComponent::reset()
 
 MCPhysicsComponent::~MCPhysicsComponent()
 {
+    m_bodies.release(m_body);
 }
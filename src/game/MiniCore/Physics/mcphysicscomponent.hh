@@ -23,9 +23,12 @@
 #include "mcobjectcomponent.hh"
 #include "mcvector3d.hh"
 
+class MCPhysicsBodyStore;
+
 /** Implements physics integrations of an MCObject.
  *  The physics component is attached to an object and it operates
- *  through the public interface. */
+ *  through the public interface. The motion state is kept in
+ *  MCPhysicsBodyStore, which MCWorld integrates in one go. */
 class MCPhysicsComponent : public MCObjectComponent
 {
 public:
@@ -54,7 +57,7 @@ public:
     void setVelocity(const MCVector3dF & newVelocity);
 
     //! Return current velocity.
-    const MCVector3dF & velocity() const;
+    MCVector3dF velocity() const;
 
     //! Return current speed.
     MCFloat speed() const;
@@ -74,7 +77,7 @@ public:
     void setAcceleration(const MCVector3dF & newAcceleration);
 
     //! Return constant acceleration.
-    const MCVector3dF & acceleration() const;
+    MCVector3dF acceleration() const;
 
     /*! Add a force (N) vector to the object for a single frame.
      *  \param force Force vector to be added. */
@@ -161,36 +164,23 @@ public:
 
 private:
 
-    void integrate(MCFloat step);
-
-    void integrateLinear(MCFloat step);
-
-    void integrateAngular(MCFloat step);
-
-    MCFloat m_damping;
-
-    MCVector3dF m_acceleration;
-
-    MCVector3dF m_velocity;
-
-    MCVector3dF m_linearImpulse;
+    /*! Mark the body for MCPhysicsBodyStore::integrate(), if the object
+     *  is not sleeping and it doesn't have a parent object.
+     *  \return true if marked. */
+    bool markForIntegration();
 
-    MCVector3dF m_forces;
+    /*! Apply the integrated velocities of a marked body: rotate and
+     *  move the object, check boundaries and sleep. */
+    void finishIntegration(MCFloat step);
 
-    MCFloat m_angularAcceleration; // Radians / s^2
+    //! The store holding the motion state of this component.
+    MCPhysicsBodyStore & m_bodies;
 
-    MCFloat m_angularVelocity; // Radians / s
-
-    MCFloat m_angularImpulse;
-
-    MCFloat m_torque;
-
-    MCFloat m_invMass;
+    //! Index of the body in m_bodies.
+    MCUint m_body;
 
     MCFloat m_mass;
 
-    MCFloat m_invMomentOfInertia;
-
     MCFloat m_momentOfInertia;
 
     MCFloat m_restitution;
@@ -204,10 +194,6 @@ private:
     bool m_isStationary;
 
     bool m_isIntegrating;
-
-    MCFloat m_linearSleepLimit;
-
-    MCFloat m_angularSleepLimit;
 };
 
 #endif // MCPHYSICSCOMPONENT_HH
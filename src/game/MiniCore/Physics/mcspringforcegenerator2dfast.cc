@@ -18,9 +18,10 @@
 //
 
 #include "mcspringforcegenerator2dfast.hh"
-#include "mccontact.hh"
+#include "mccontactmanifold.hh"
 #include "mcobject.hh"
 #include "mcphysicscomponent.hh"
+#include "mcworld.hh"
 
 MCSpringForceGenerator2dFast::MCSpringForceGenerator2dFast(
     MCObject & object2, MCFloat coeff, MCFloat length, MCFloat min, MCFloat max)
@@ -51,20 +52,16 @@ void MCSpringForceGenerator2dFast::updateForce(MCObject & object1)
     {
         const MCFloat m1 = object1.physicsComponent().invMass();
         const MCFloat m2 = m_p2->physicsComponent().invMass();
-        MCContact & contact1 = MCContact::create();
-        contact1.init(*m_p2, object1.location(),
-            -diff, (length - m_max) * m2 / (m1 + m2));
-        object1.addContact(contact1);
+        MCWorld::instance().contactManifold().addContact(
+            object1, *m_p2, object1.location(), -diff, (length - m_max) * m2 / (m1 + m2));
 
     }
     else if (length < m_min)
     {
         const MCFloat m1 = object1.physicsComponent().invMass();
         const MCFloat m2 = m_p2->physicsComponent().invMass();
-        MCContact & contact1 = MCContact::create();
-        contact1.init(*m_p2, object1.location(),
-            diff, (m_min - length) * m2 / (m1 + m2));
-        object1.addContact(contact1);
+        MCWorld::instance().contactManifold().addContact(
+            object1, *m_p2, object1.location(), diff, (m_min - length) * m2 / (m1 + m2));
     }
 
     // Update force
@@ -21,14 +21,205 @@
 #include "mctexturefont.hh"
 #include "mctextureglyph.hh"
 #include "mccamera.hh"
+#include "mcglobjectbase.hh"
+#include "mcglscene.hh"
 #include "mcsurface.hh"
 #include "mcgltexcoord.hh"
+#include "mcglvertex.hh"
 
 #include <MCGLEW>
 
-#include <map>
 #include <vector>
 
+namespace {
+const int NUM_VERTICES_PER_GLYPH = MCSurface::NUM_VERTICES;
+}
+
+/*! Vertex buffer holding the glyph quads of one string. The quads are
+ *  built in glyph cell units, so the glyph size is applied as a scale
+ *  when rendering and changing it doesn't invalidate the buffer. */
+class MCTextureTextMesh : public MCGLObjectBase
+{
+public:
+
+    MCTextureTextMesh();
+
+    //! Rebuild the quads for the given text by using the given font.
+    void build(const std::wstring & text, MCTextureFont & font);
+
+    //! Render the vertex buffer only. bind() must be called separately.
+    void render();
+
+    //! \return number of vertices in the current text.
+    int numVertices() const;
+
+private:
+
+    void reserve(int numGlyphs);
+
+    std::vector<MCGLVertex>   m_vertices;
+    std::vector<MCGLVertex>   m_normals;
+    std::vector<MCGLTexCoord> m_texCoords;
+    std::vector<MCGLColor>    m_colors;
+
+    int m_maxGlyphs;
+    int m_numVertices;
+};
+
+MCTextureTextMesh::MCTextureTextMesh()
+: m_maxGlyphs(0)
+, m_numVertices(0)
+{
+}
+
+void MCTextureTextMesh::reserve(int numGlyphs)
+{
+    m_maxGlyphs = numGlyphs;
+
+    const int NUM_VERTICES = m_maxGlyphs * NUM_VERTICES_PER_GLYPH;
+    m_vertices.resize(NUM_VERTICES);
+    m_normals.resize(NUM_VERTICES);
+    m_texCoords.resize(NUM_VERTICES);
+    m_colors.resize(NUM_VERTICES);
+}
+
+void MCTextureTextMesh::build(const std::wstring & text, MCTextureFont & font)
+{
+    int numGlyphs = 0;
+    for (wchar_t glyph : text)
+    {
+        if (glyph != '\n' && glyph != ' ')
+        {
+            numGlyphs++;
+        }
+    }
+
+    // Grow the buffer only if needed. Normals and colors don't depend on
+    // the text so they are uploaded only when the buffer is (re)allocated.
+    const bool grow = numGlyphs > m_maxGlyphs;
+    if (grow)
+    {
+        reserve(numGlyphs);
+    }
+
+    const MCSurface & surface = font.surface();
+    const MCFloat     w       = surface.width();
+    const MCFloat     h       = surface.height();
+
+    int vertexIndex = 0;
+    int column      = 0;
+    int row         = 0;
+    for (wchar_t glyph : text)
+    {
+        if (glyph == '\n')
+        {
+            column = 0;
+            row++;
+        }
+        else if (glyph == ' ')
+        {
+            column++;
+        }
+        else
+        {
+            MCTextureGlyph & texGlyph = font.glyph(glyph);
+            const MCGLTexCoord uv[4] =
+            {
+                {texGlyph.uv(3).m_u, texGlyph.uv(3).m_v},
+                {texGlyph.uv(0).m_u, texGlyph.uv(0).m_v},
+                {texGlyph.uv(1).m_u, texGlyph.uv(1).m_v},
+                {texGlyph.uv(2).m_u, texGlyph.uv(2).m_v}
+            };
+
+            // Same triangulation as in MCSurface::setTexCoords().
+            const MCGLTexCoord texCoords[NUM_VERTICES_PER_GLYPH] =
+            {
+                uv[0], uv[2], uv[1], uv[0], uv[3], uv[2]
+            };
+
+            for (int i = 0; i < NUM_VERTICES_PER_GLYPH; i++)
+            {
+                const MCGLVertex & vertex = surface.vertices()[i];
+                m_vertices[vertexIndex] = MCGLVertex(
+                    column + vertex.x() / w, vertex.y() / h - row, vertex.z());
+                m_texCoords[vertexIndex] = texCoords[i];
+
+                if (grow)
+                {
+                    m_normals[vertexIndex] = surface.normals()[i];
+                }
+
+                vertexIndex++;
+            }
+
+            column++;
+        }
+    }
+
+    if (grow)
+    {
+        for (int i = vertexIndex; i < static_cast<int>(m_vertices.size()); i++)
+        {
+            m_normals[i] = surface.normals()[i % NUM_VERTICES_PER_GLYPH];
+        }
+    }
+
+    m_numVertices = vertexIndex;
+
+    const int NUM_VERTICES       = m_maxGlyphs * NUM_VERTICES_PER_GLYPH;
+    const int VERTEX_DATA_SIZE   = sizeof(MCGLVertex)   * NUM_VERTICES;
+    const int NORMAL_DATA_SIZE   = sizeof(MCGLVertex)   * NUM_VERTICES;
+    const int TEXCOORD_DATA_SIZE = sizeof(MCGLTexCoord) * NUM_VERTICES;
+    const int COLOR_DATA_SIZE    = sizeof(MCGLColor)    * NUM_VERTICES;
+    const int TOTAL_DATA_SIZE    =
+        VERTEX_DATA_SIZE + NORMAL_DATA_SIZE + TEXCOORD_DATA_SIZE + COLOR_DATA_SIZE;
+
+    if (grow)
+    {
+        initBufferData(TOTAL_DATA_SIZE, GL_DYNAMIC_DRAW);
+
+        addBufferSubData(
+            MCGLShaderProgram::VAL_Vertex, VERTEX_DATA_SIZE,
+            reinterpret_cast<const GLfloat *>(m_vertices.data()));
+        addBufferSubData(
+            MCGLShaderProgram::VAL_Normal, NORMAL_DATA_SIZE,
+            reinterpret_cast<const GLfloat *>(m_normals.data()));
+        addBufferSubData(
+            MCGLShaderProgram::VAL_TexCoords, TEXCOORD_DATA_SIZE,
+            reinterpret_cast<const GLfloat *>(m_texCoords.data()));
+        addBufferSubData(
+            MCGLShaderProgram::VAL_Color, COLOR_DATA_SIZE,
+            reinterpret_cast<const GLfloat *>(m_colors.data()));
+
+        finishBufferData();
+    }
+    else if (m_numVertices)
+    {
+        bindVBO();
+
+        MCGLStateCache & stateCache = MCGLScene::instance().stateCache();
+        glBufferSubData(GL_ARRAY_BUFFER, 0,
+            sizeof(MCGLVertex) * m_numVertices, m_vertices.data());
+        stateCache.countBufferUpload();
+        glBufferSubData(GL_ARRAY_BUFFER, VERTEX_DATA_SIZE + NORMAL_DATA_SIZE,
+            sizeof(MCGLTexCoord) * m_numVertices, m_texCoords.data());
+        stateCache.countBufferUpload();
+
+        releaseVBO();
+    }
+}
+
+void MCTextureTextMesh::render()
+{
+    glDrawArrays(GL_TRIANGLES, 0, m_numVertices);
+    MCGLScene::instance().stateCache().countDrawCall();
+}
+
+int MCTextureTextMesh::numVertices() const
+{
+    return m_numVertices;
+}
+
 MCTextureText::MCTextureText(const std::wstring & text)
 : m_text(text)
 , m_glyphWidth(32)
@@ -36,6 +227,8 @@ MCTextureText::MCTextureText(const std::wstring & text)
 , m_color(1.0, 1.0, 1.0, 1.0)
 , m_xOffset(2.0)
 , m_yOffset(-2.0)
+, m_meshFont(nullptr)
+, m_meshIsUpToDate(false)
 {
     updateTextDimensions();
 }
@@ -71,8 +264,12 @@ void MCTextureText::updateTextDimensions()
 
 void MCTextureText::setText(const std::wstring & text)
 {
-    m_text = text;
-    updateTextDimensions();
+    if (text != m_text)
+    {
+        m_text           = text;
+        m_meshIsUpToDate = false;
+        updateTextDimensions();
+    }
 }
 
 const std::wstring & MCTextureText::text() const
@@ -123,102 +320,64 @@ int MCTextureText::height() const
     return m_textHeight;
 }
 
-void MCTextureText::render(MCFloat x, MCFloat y, MCCamera * camera,
-    MCTextureFont & font, bool shadow)
+void MCTextureText::updateMesh(MCTextureFont & font)
 {
-    glDisable(GL_DEPTH_TEST);
-
-    wchar_t prevGlyph = 0;
-    wchar_t glyph     = 0;
-    int     glyphXPos = x;
-    int     glyphYPos = y;
+    if (!m_mesh)
+    {
+        m_mesh.reset(new MCTextureTextMesh);
+    }
 
-    if (shadow)
+    if (!m_meshIsUpToDate || m_meshFont != &font)
     {
-        font.surface().bindShadow();
+        m_mesh->build(m_text, font);
 
-        for (int i = 0; i < static_cast<int>(m_text.size()); i++)
-        {
-            prevGlyph = glyph;
-            glyph     = m_text[i];
+        m_meshFont       = &font;
+        m_meshIsUpToDate = true;
+    }
 
-            if (glyph == '\n')
-            {
-                glyphXPos  = x;
-                glyphYPos -= m_glyphHeight;
-            }
-            else if (glyph == ' ')
-            {
-                glyphXPos += m_glyphWidth;
-            }
-            else
-            {
-                if (glyph != prevGlyph)
-                {
-                    MCTextureGlyph & texGlyph = font.glyph(glyph);
-                    const MCGLTexCoord uv[4] =
-                    {
-                        {texGlyph.uv(3).m_u, texGlyph.uv(3).m_v},
-                        {texGlyph.uv(0).m_u, texGlyph.uv(0).m_v},
-                        {texGlyph.uv(1).m_u, texGlyph.uv(1).m_v},
-                        {texGlyph.uv(2).m_u, texGlyph.uv(2).m_v}
-                    };
-
-                    font.surface().setTexCoords(uv);
-                }
+    MCSurface & surface = font.surface();
+    m_mesh->setMaterial(surface.material());
+    m_mesh->setShaderProgram(surface.shaderProgram());
+    m_mesh->setShadowShaderProgram(surface.shadowShaderProgram());
+}
 
-                font.surface().setSize(m_glyphWidth, m_glyphHeight);
-                font.surface().renderShadow(camera,
-                    MCVector3dF(glyphXPos + m_xOffset, glyphYPos + m_yOffset, 0), 0, false);
+void MCTextureText::render(MCFloat x, MCFloat y, MCCamera * camera,
+    MCTextureFont & font, bool shadow)
+{
+    MCGLScene::instance().stateCache().setDepthTestEnabled(false);
 
-                glyphXPos += m_glyphWidth;
-            }
-        }
-    }
+    updateMesh(font);
 
-    font.surface().bind();
-    font.surface().setColor(m_color);
+    if (!m_mesh->numVertices())
+    {
+        return;
+    }
 
-    prevGlyph = 0;
-    glyph     = 0;
-    glyphXPos = x;
-    glyphYPos = y;
+    if (camera)
+    {
+        camera->mapToCamera(x, y);
+    }
 
-    for (int i = 0; i < static_cast<int>(m_text.size()); i++)
+    if (shadow)
     {
-        prevGlyph = glyph;
-        glyph     = m_text[i];
+        m_mesh->bindShadow();
 
-        if (glyph == '\n')
-        {
-            glyphXPos  = x;
-            glyphYPos -= m_glyphHeight;
-        }
-        else if (glyph == ' ')
-        {
-            glyphXPos += m_glyphWidth;
-        }
-        else
-        {
-            if (glyph != prevGlyph)
-            {
-                MCTextureGlyph & texGlyph = font.glyph(glyph);
-                const MCGLTexCoord uv[4] =
-                {
-                    {texGlyph.uv(3).m_u, texGlyph.uv(3).m_v},
-                    {texGlyph.uv(0).m_u, texGlyph.uv(0).m_v},
-                    {texGlyph.uv(1).m_u, texGlyph.uv(1).m_v},
-                    {texGlyph.uv(2).m_u, texGlyph.uv(2).m_v}
-                };
+        MCGLShaderProgramPtr program = m_mesh->shadowShaderProgram();
+        program->setScale(m_glyphWidth, m_glyphHeight, 1);
+        program->setTransform(0, MCVector3dF(x + m_xOffset, y + m_yOffset, 0));
 
-                font.surface().setTexCoords(uv);
-            }
+        m_mesh->render();
+        m_mesh->releaseShadow();
+    }
 
-            font.surface().setSize(m_glyphWidth, m_glyphHeight);
-            font.surface().render(camera,
-                MCVector3dF(glyphXPos, glyphYPos, 0), 0, false);
+    m_mesh->bind();
+    font.surface().doAlphaBlend();
 
-            glyphXPos += m_glyphWidth;
-        }
-    }
+    MCGLShaderProgramPtr program = m_mesh->shaderProgram();
+    program->setScale(m_glyphWidth, m_glyphHeight, 1);
+    program->setColor(m_color);
+    program->setTransform(0, MCVector3dF(x, y, 0));
+
+    m_mesh->render();
+    m_mesh->release();
 }
@@ -24,13 +24,17 @@
 #include "mctypes.hh"
 #include "mcmacros.hh"
 
+#include <memory>
 #include <string>
 
 class MCCamera;
 class MCTextureFont;
+class MCTextureTextMesh;
 
 /*! MCTextureText is a renderable texture text object.
- *  A monospace font is assumed (MCTextureFont). */
+ *  A monospace font is assumed (MCTextureFont). The glyph quads are
+ *  cached in a vertex buffer that is rebuilt only when the text or
+ *  the font changes, so a string is drawn with a single draw call. */
 class MCTextureText
 {
 public:
@@ -84,6 +88,8 @@ private:
 
     void updateTextDimensions();
 
+    void updateMesh(MCTextureFont & font);
+
     std::wstring m_text;
     int          m_glyphWidth;
     int          m_glyphHeight;
@@ -92,6 +98,10 @@ private:
     MCGLColor    m_color;
     MCFloat      m_xOffset;
     MCFloat      m_yOffset;
+
+    std::unique_ptr<MCTextureTextMesh> m_mesh;
+    MCTextureFont * m_meshFont;
+    bool            m_meshIsUpToDate;
 };
 
 #endif // MCTEXTUREGLYPH_HH
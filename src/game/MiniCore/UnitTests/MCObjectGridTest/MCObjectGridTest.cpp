@@ -0,0 +1,231 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+
+#include "MCObjectGridTest.hpp"
+#include "../../Core/mcworld.hh"
+#include "../../Core/mcobject.hh"
+#include "../../Physics/mcobjectgrid.hh"
+#include "../../Physics/mcrectshape.hh"
+#include "../../Physics/mcphysicscomponent.hh"
+
+#include <memory>
+#include <vector>
+
+static std::unique_ptr<MCObject> createObject(MCFloat x, MCFloat y)
+{
+    std::unique_ptr<MCObject> object(new MCObject("TEST_OBJECT"));
+    object->setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    object->physicsComponent().preventSleeping(true);
+    object->translate(MCVector3dF(x, y));
+    return object;
+}
+
+static bool hasPair(const MCObjectGrid::CollisionVector & result, MCObject & obj1, MCObject & obj2)
+{
+    for (const MCObjectGrid::PossibleCollision & pair : result)
+    {
+        if ((pair.object1 == &obj1 && pair.object2 == &obj2) ||
+            (pair.object1 == &obj2 && pair.object2 == &obj1))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+MCObjectGridTest::MCObjectGridTest()
+{
+}
+
+void MCObjectGridTest::testInsertAndGetObjectsWithinBBox()
+{
+    MCWorld world; // Objects need a world to be translated.
+    MCObjectGrid grid(0, 0, 100, 100, 10, 10);
+
+    auto object1 = createObject(15, 15);
+    auto object2 = createObject(55, 55);
+    auto object3 = createObject(85, 15);
+
+    grid.insert(*object1);
+    grid.insert(*object2);
+    grid.insert(*object3);
+
+    MCObjectGrid::ObjectSet result;
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 30, 30), result);
+    QVERIFY(result.size() == 1);
+    QVERIFY(result.count(object1.get()));
+
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 100, 100), result);
+    QVERIFY(result.size() == 3);
+
+    // Inserting twice must not duplicate the object.
+    grid.insert(*object1);
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 30, 30), result);
+    QVERIFY(result.size() == 1);
+}
+
+void MCObjectGridTest::testRemove()
+{
+    MCWorld world;
+    MCObjectGrid grid(0, 0, 100, 100, 10, 10);
+
+    auto object1 = createObject(15, 15);
+    auto object2 = createObject(16, 16);
+
+    grid.insert(*object1);
+    grid.insert(*object2);
+
+    QVERIFY(grid.remove(*object1));
+    QVERIFY(!grid.remove(*object1));
+
+    MCObjectGrid::ObjectSet result;
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 30, 30), result);
+    QVERIFY(result.size() == 1);
+    QVERIFY(result.count(object2.get()));
+}
+
+void MCObjectGridTest::testMoveObject()
+{
+    MCWorld world;
+    MCObjectGrid grid(0, 0, 100, 100, 10, 10);
+
+    auto object = createObject(15, 15);
+    grid.insert(*object);
+
+    QVERIFY(grid.remove(*object));
+    object->translate(MCVector3dF(75, 75));
+    grid.insert(*object);
+
+    MCObjectGrid::ObjectSet result;
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 30, 30), result);
+    QVERIFY(result.empty());
+
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(70, 70, 80, 80), result);
+    QVERIFY(result.size() == 1);
+    QVERIFY(result.count(object.get()));
+
+    grid.getObjectsWithinDistance(75, 75, 1, result);
+    QVERIFY(result.size() == 1);
+}
+
+void MCObjectGridTest::testBBoxCollisions()
+{
+    MCWorld world;
+    MCObjectGrid grid(0, 0, 100, 100, 10, 10);
+
+    auto object1 = createObject(55, 55);
+    auto object2 = createObject(56, 55);
+    auto object3 = createObject(15, 15);
+
+    grid.insert(*object1);
+    grid.insert(*object2);
+    grid.insert(*object3);
+
+    MCObjectGrid::CollisionVector result;
+    grid.getBBoxCollisions(result);
+    QVERIFY(result.size() == 1);
+    QVERIFY(hasPair(result, *object1, *object2));
+    QVERIFY(result[0].test12 && result[0].test21);
+
+    // Move the objects apart.
+    grid.remove(*object2);
+    object2->translate(MCVector3dF(85, 85));
+    grid.insert(*object2);
+
+    grid.getBBoxCollisions(result);
+    QVERIFY(result.empty());
+
+    // And back together.
+    grid.remove(*object2);
+    object2->translate(MCVector3dF(15, 16));
+    grid.insert(*object2);
+
+    grid.getBBoxCollisions(result);
+    QVERIFY(result.size() == 1);
+    QVERIFY(hasPair(result, *object2, *object3));
+}
+
+void MCObjectGridTest::testBBoxCollisionsAcrossCells()
+{
+    MCWorld world;
+    MCObjectGrid grid(0, 0, 100, 100, 10, 10);
+
+    // Both objects cover the same four cells, but are one pair.
+    auto object1 = createObject(60, 60);
+    auto object2 = createObject(60.5, 60);
+
+    grid.insert(*object1);
+    grid.insert(*object2);
+
+    MCObjectGrid::CollisionVector result;
+    grid.getBBoxCollisions(result);
+    QVERIFY(result.size() == 1);
+    QVERIFY(hasPair(result, *object1, *object2));
+}
+
+void MCObjectGridTest::testBBoxCollisionsOfObjects()
+{
+    MCWorld world;
+    MCObjectGrid grid(0, 0, 100, 100, 10, 10);
+
+    auto object1 = createObject(55, 55);
+    auto object2 = createObject(56, 55);
+    auto object3 = createObject(15, 15);
+    auto object4 = createObject(16, 15);
+
+    grid.insert(*object1);
+    grid.insert(*object2);
+    grid.insert(*object3);
+    grid.insert(*object4);
+
+    // Only pairs involving the given objects are reported.
+    MCObjectGrid::CollisionVector result;
+    grid.getBBoxCollisions(std::vector<MCObject *>({object1.get(), object2.get()}), result);
+    QVERIFY(result.size() == 1);
+    QVERIFY(hasPair(result, *object1, *object2));
+
+    // Objects not in the grid have no collisions.
+    auto object5 = createObject(15, 16);
+    grid.getBBoxCollisions(std::vector<MCObject *>({object5.get()}), result);
+    QVERIFY(result.empty());
+}
+
+void MCObjectGridTest::testRemoveAll()
+{
+    MCWorld world;
+    MCObjectGrid grid(0, 0, 100, 100, 10, 10);
+
+    auto object1 = createObject(55, 55);
+    auto object2 = createObject(56, 55);
+
+    grid.insert(*object1);
+    grid.insert(*object2);
+    grid.removeAll();
+
+    MCObjectGrid::ObjectSet objects;
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 100, 100), objects);
+    QVERIFY(objects.empty());
+
+    MCObjectGrid::CollisionVector collisions;
+    grid.getBBoxCollisions(collisions);
+    QVERIFY(collisions.empty());
+}
+
+QTEST_MAIN(MCObjectGridTest)
@@ -0,0 +1,292 @@
+// This file belongs to the "MiniCore" game engine.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+// MA  02110-1301, USA.
+//
+#include "MCRenderGridTest.hpp"
+#include "../../Core/mcworld.hh"
+#include "../../Core/mcobject.hh"
+#include "../../Graphics/mccamera.hh"
+#include "../../Graphics/mcrendergrid.hh"
+#include "../../Graphics/mcshapeview.hh"
+#include "../../Graphics/mcworldrenderer.hh"
+#include "../../Physics/mccircleshape.hh"
+#include "../../Physics/mcrectshape.hh"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+//! A view that draws nothing; the world renderer batches only objects with a view.
+class TestView : public MCShapeView
+{
+public:
+
+    TestView()
+    : MCShapeView("TEST_VIEW")
+    {}
+
+    MCBBox3dF bbox() const override
+    {
+        return MCBBox3dF(-1, -1, 0, 1, 1, 0);
+    }
+};
+
+// Objects are translated before they are inserted: a translated object
+// that is in a render grid updates the render grid of the world.
+static std::unique_ptr<MCObject> createObject(MCFloat x, MCFloat y)
+{
+    std::unique_ptr<MCObject> object(new MCObject("TEST_OBJECT"));
+    object->setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+    object->translate(MCVector3dF(x, y));
+    return object;
+}
+
+static std::unique_ptr<MCObject> createRenderableObject(const std::string & typeName)
+{
+    std::unique_ptr<MCObject> object(new MCObject(typeName));
+    object->setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(new TestView), 2.0, 2.0)));
+    return object;
+}
+
+static bool contains(const MCRenderGrid::ObjectVector & result, MCObject & object)
+{
+    return std::find(result.begin(), result.end(), &object) != result.end();
+}
+
+typedef std::map<std::pair<int, int>, std::vector<MCObject *> > BatchMap;
+
+//! \return the sorted object batches of the given layers keyed by layer and type id.
+static BatchMap getBatches(MCWorld & world, MCCamera & camera, int layerCount)
+{
+    world.prepareRendering(&camera);
+
+    BatchMap result;
+    for (int layer = 0; layer < layerCount; layer++)
+    {
+        MCRenderLayer::BatchArray & batches = world.renderer().objectBatches(&camera, layer);
+        for (int typeId : batches.typeIds())
+        {
+            std::vector<MCObject *> batch(batches.batch(typeId));
+            std::sort(batch.begin(), batch.end());
+            result[std::make_pair(layer, typeId)] = batch;
+        }
+    }
+
+    return result;
+}
+
+MCRenderGridTest::MCRenderGridTest()
+{
+}
+
+void MCRenderGridTest::testInsertAndGetObjectsWithinBBox()
+{
+    MCWorld world; // Objects need a world to be translated.
+    MCRenderGrid grid;
+    grid.setDimensions(0, 0, 100, 100, 10, 10);
+
+    auto object1 = createObject(15, 15);
+    auto object2 = createObject(55, 55);
+    auto object3 = createObject(85, 15);
+
+    grid.insert(*object1);
+    grid.insert(*object2);
+    grid.insert(*object3);
+    QVERIFY(grid.count() == 3);
+
+    MCRenderGrid::ObjectVector result;
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 30, 30), result);
+    QVERIFY(result.size() == 1);
+    QVERIFY(contains(result, *object1));
+
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 100, 100), result);
+    QVERIFY(result.size() == 3);
+
+    // Inserting twice must not duplicate the object.
+    grid.insert(*object1);
+    QVERIFY(grid.count() == 3);
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 100, 100), result);
+    QVERIFY(result.size() == 3);
+
+    // Objects outside the grid go to the border cells.
+    auto object4 = createObject(-50, 150);
+    grid.insert(*object4);
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(-100, 120, -60, 200), result);
+    QVERIFY(result.size() == 1);
+    QVERIFY(contains(result, *object4));
+}
+
+void MCRenderGridTest::testQueryIncludesObjectExtent()
+{
+    MCWorld world;
+    MCRenderGrid grid;
+    grid.setDimensions(0, 0, 100, 100, 10, 10);
+
+    // The location is two cells away from the bbox, but the object reaches it.
+    // Particles are tested with their shape, other objects with their view.
+    std::unique_ptr<MCObject> object(new MCObject("TEST_PARTICLE"));
+    object->setShape(MCShapePtr(new MCCircleShape(MCShapeViewPtr(), 15.0)));
+    object->setIsParticle(true);
+    object->translate(MCVector3dF(45, 45));
+    grid.insert(*object);
+
+    MCRenderGrid::ObjectVector result;
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 25, 25), result);
+    QVERIFY(contains(result, *object));
+}
+
+void MCRenderGridTest::testRemove()
+{
+    MCWorld world;
+    MCRenderGrid grid;
+    grid.setDimensions(0, 0, 100, 100, 10, 10);
+
+    auto object1 = createObject(15, 15);
+    auto object2 = createObject(16, 16);
+
+    grid.insert(*object1);
+    grid.insert(*object2);
+
+    grid.remove(*object1);
+    QVERIFY(grid.count() == 1);
+
+    // Removing twice is harmless.
+    grid.remove(*object1);
+    QVERIFY(grid.count() == 1);
+
+    MCRenderGrid::ObjectVector result;
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 30, 30), result);
+    QVERIFY(result.size() == 1);
+    QVERIFY(contains(result, *object2));
+}
+
+void MCRenderGridTest::testRemoveAll()
+{
+    MCWorld world;
+    MCRenderGrid grid;
+    grid.setDimensions(0, 0, 100, 100, 10, 10);
+
+    auto object1 = createObject(15, 15);
+    auto object2 = createObject(55, 55);
+
+    grid.insert(*object1);
+    grid.insert(*object2);
+    grid.removeAll();
+    QVERIFY(grid.count() == 0);
+
+    MCRenderGrid::ObjectVector result;
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 100, 100), result);
+    QVERIFY(result.empty());
+
+    // Objects can be inserted again.
+    grid.insert(*object1);
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 100, 100), result);
+    QVERIFY(result.size() == 1);
+}
+
+void MCRenderGridTest::testSetDimensionsKeepsObjects()
+{
+    MCWorld world;
+    MCRenderGrid grid; // A single cell until the dimensions are set.
+
+    auto object1 = createObject(15, 15);
+    auto object2 = createObject(85, 85);
+
+    grid.insert(*object1);
+    grid.insert(*object2);
+
+    MCRenderGrid::ObjectVector result;
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 30, 30), result);
+    QVERIFY(result.size() == 2);
+
+    grid.setDimensions(0, 0, 100, 100, 10, 10);
+    QVERIFY(grid.count() == 2);
+
+    grid.getObjectsWithinBBox(MCBBox<MCFloat>(0, 0, 30, 30), result);
+    QVERIFY(result.size() == 1);
+    QVERIFY(contains(result, *object1));
+}
+
+void MCRenderGridTest::testTranslateUpdatesWorldGrid()
+{
+    MCWorld world;
+    world.setDimensions(0, 1024, 0, 1024, 0, 10);
+    world.renderer().setVisibilityCulling(MCWorldRenderer::VisibilityCulling::Grid);
+
+    auto object = createRenderableObject("TEST_OBJECT");
+    object->translate(MCVector3dF(900, 900));
+    world.addObject(*object);
+
+    // The camera only sees the cell at the origin.
+    MCCamera camera(100, 100, 50, 50, 1024, 1024);
+    QVERIFY(getBatches(world, camera, 1).empty());
+
+    // The object is found only if it was moved to its new cell.
+    object->translate(MCVector3dF(50, 50));
+    const BatchMap batches = getBatches(world, camera, 1);
+    QVERIFY(batches.size() == 1);
+    QVERIFY(batches.begin()->second.size() == 1);
+    QVERIFY(batches.begin()->second[0] == object.get());
+
+    // And it leaves the old one.
+    object->translate(MCVector3dF(900, 50));
+    QVERIFY(getBatches(world, camera, 1).empty());
+}
+
+void MCRenderGridTest::testGridBatchesMatchLayerScan()
+{
+    MCWorld world;
+    world.setDimensions(0, 2048, 0, 2048, 0, 10);
+
+    const int layerCount = 3;
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<MCFloat> distribution(0, 2048);
+
+    std::vector<std::unique_ptr<MCObject> > objects;
+    for (int i = 0; i < 500; i++)
+    {
+        objects.push_back(createRenderableObject(i % 2 ? "TEST_OBJECT_A" : "TEST_OBJECT_B"));
+        objects.back()->setRenderLayer(i % layerCount);
+        objects.back()->translate(MCVector3dF(distribution(generator), distribution(generator)));
+        world.addObject(*objects.back());
+    }
+
+    MCCamera camera(640, 480, 700, 900, 2048, 2048);
+
+    const BatchMap layerScanBatches = getBatches(world, camera, layerCount);
+    QVERIFY(!layerScanBatches.empty());
+
+    world.renderer().setVisibilityCulling(MCWorldRenderer::VisibilityCulling::Grid);
+    QVERIFY(getBatches(world, camera, layerCount) == layerScanBatches);
+
+    // Move the objects around while the grid is in use.
+    for (auto && object : objects)
+    {
+        object->translate(MCVector3dF(distribution(generator), distribution(generator)));
+    }
+
+    const BatchMap gridBatches = getBatches(world, camera, layerCount);
+    QVERIFY(!gridBatches.empty());
+
+    world.renderer().setVisibilityCulling(MCWorldRenderer::VisibilityCulling::LayerScan);
+    QVERIFY(getBatches(world, camera, layerCount) == gridBatches);
+}
+
+QTEST_MAIN(MCRenderGridTest)
@@ -24,6 +24,9 @@
 #include "../../Physics/mccollisionevent.hh"
 #include "../../Physics/mcphysicscomponent.hh"
 
+#include <thread>
+#include <vector>
+
 class TestObject : public MCObject
 {
 public:
@@ -43,6 +46,24 @@ public:
     bool m_collisionEventReceived;
 };
 
+class StepCountingObject : public MCObject
+{
+public:
+
+    StepCountingObject()
+    : MCObject("STEP_COUNTING_OBJECT")
+    , m_stepCount(0)
+    {
+    }
+
+    virtual void onStepTime(MCFloat)
+    {
+        m_stepCount++;
+    }
+
+    int m_stepCount;
+};
+
 MCWorldTest::MCWorldTest()
 {
 }
@@ -117,4 +138,80 @@ void MCWorldTest::testSimpleCollision()
     QVERIFY(object2.m_collisionEventReceived);
 }
 
+void MCWorldTest::testSleepDuringStep()
+{
+    MCWorld world;
+    world.setDimensions(-10, 10, -10, 10, -10, 10);
+
+    // Falls asleep in its first step, because it doesn't move. That
+    // removes it from the integration vector in the middle of the step.
+    StepCountingObject sleeper;
+    world.addObject(sleeper);
+
+    // Added last, so it is the one moved into the sleeper's place.
+    StepCountingObject mover;
+    mover.physicsComponent().preventSleeping(true);
+    world.addObject(mover);
+    mover.physicsComponent().setVelocity(MCVector3dF(1.0, 0.0));
+
+    world.stepTime(1.0);
+
+    QVERIFY(sleeper.physicsComponent().isSleeping());
+    QCOMPARE(sleeper.m_stepCount, 1);
+    QCOMPARE(mover.m_stepCount, 1);
+    QVERIFY(mover.location().i() > 0.5f);
+}
+
+void MCWorldTest::testWorldsInParallelThreads()
+{
+    const int numThreads = 4;
+    std::vector<int> results(numThreads, 0);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < numThreads; i++)
+    {
+        threads.push_back(std::thread([i, &results] () {
+            // Every thread has its own world and world-wide settings.
+            const MCFloat metersPerUnit = 0.1f * (i + 1);
+
+            MCWorld world;
+            world.setDimensions(-10, 10, -10, 10, -10, 10, metersPerUnit);
+
+            TestObject object1;
+            object1.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+            object1.physicsComponent().preventSleeping(true);
+
+            TestObject object2;
+            object2.setShape(MCShapePtr(new MCRectShape(MCShapeViewPtr(), 2.0, 2.0)));
+            object2.physicsComponent().preventSleeping(true);
+
+            world.addObject(object1);
+            world.addObject(object2);
+
+            object1.translate(MCVector3dF(-0.5, 0.0));
+            object2.translate(MCVector3dF( 0.5, 0.0));
+
+            world.stepTime(1.0);
+
+            results[i] =
+                &MCWorld::instance() == &world &&
+                qFuzzyCompare(MCWorld::metersPerUnit(), metersPerUnit) &&
+                object1.m_collisionEventReceived &&
+                object2.m_collisionEventReceived;
+        }));
+    }
+
+    for (std::thread & thread : threads)
+    {
+        thread.join();
+    }
+
+    for (int result : results)
+    {
+        QVERIFY(result);
+    }
+
+    QVERIFY(!MCWorld::hasInstance());
+}
+
 QTEST_MAIN(MCWorldTest)
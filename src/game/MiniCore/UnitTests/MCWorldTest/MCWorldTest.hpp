@@ -32,6 +32,8 @@ private slots:
     void testAddToWorld();
     void testSetDimensions();
     void testSimpleCollision();
+    void testSleepDuringStep();
+    void testWorldsInParallelThreads();
 
 private:
 
@@ -34,15 +34,41 @@ DUST_API AIFactory& AIFactory::instance()
 
 void AIFactory::add(const std::string& name, std::function<CarController* (Car&)> creationFunction) {
 	m_register[name] = creationFunction;
+	m_batchRegister.erase(name);
+}
+
+void AIFactory::addBatch(const std::string& name, std::function<BatchController* ()> creationFunction) {
+	m_batchRegister[name] = creationFunction;
 }
 
 CarController* AIFactory::create(const std::string& name, Car& car) {
+	return creationFunction(name)(car);
+}
+
+std::function<CarController* (Car&)> AIFactory::creationFunction(const std::string& name) const {
 	auto iter = m_register.find(name);
 	if(iter == m_register.end()) throw std::runtime_error("No creation function registered under name '" + name + "'.");
-	return iter->second(car);
+	return iter->second;
+}
+
+std::function<BatchController* ()> AIFactory::batchCreationFunction(const std::string& name) const {
+	auto iter = m_batchRegister.find(name);
+	if(iter == m_batchRegister.end()) return std::function<BatchController* ()>();
+	return iter->second;
+}
+
+CarController* AIFactory::create(std::function<CarController* (Car&)> creationFunction,
+	const BatchControllerPtr& batchController, Car& car)
+{
+	if(!batchController) return creationFunction(car);
+
+	PIDController* controller = new PIDController(car, false);
+	controller->setBatchController(batchController);
+	return controller;
 }
 
 void AIFactory::clear() {
 	m_register.clear();
+	m_batchRegister.clear();
 }
 
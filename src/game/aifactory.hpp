@@ -18,6 +18,7 @@
 
 #include "config.hpp"
 #include "pidcontroller.hpp"
+#include "batchcontroller.hpp"
 #include <map>
 #include <functional>
 #include <string>
@@ -31,9 +32,15 @@ public:
 
 public:
 	//! Adds the creation function to the factory under the specified name.
-	//! If an entry with the same name exists already, it is replaced.
+	//! If an entry with the same name exists already, it is replaced,
+	//! along with any batch creation function registered under the name.
 	void add(const std::string& name, std::function<CarController* (Car&)> creationFunction);
 
+	//! Adds a batch controller creation function under the specified name.
+	//! Cars that use a controller with a batch creation function get
+	//! their controls from a single batch controller per race instead.
+	void addBatch(const std::string& name, std::function<BatchController* ()> creationFunction);
+
 	/**
 	* Uses the creation function registered under the specified name
 	* to return a new object.
@@ -42,11 +49,33 @@ public:
 	**/
 	CarController* create(const std::string& name, Car& car);
 
+	/**
+	* Returns the creation function registered under the specified name.
+	* Unlike the name, the returned function is not affected by later
+	* calls to add().
+	* \exception std::runtime_error Throws when there is no creation function
+	* registered under the specified name.
+	**/
+	std::function<CarController* (Car&)> creationFunction(const std::string& name) const;
+
+	//! Returns the batch creation function registered under the specified
+	//! name, or an empty function if there is none.
+	std::function<BatchController* ()> batchCreationFunction(const std::string& name) const;
+
+	/**
+	* Creates the controller of a single car, given the creation functions
+	* of the controller type. If batchController is set, the car gets
+	* its controls from it and creationFunction is not used.
+	**/
+	static CarController* create(std::function<CarController* (Car&)> creationFunction,
+		const BatchControllerPtr& batchController, Car& car);
+
 	//! Removes all the registered entries.
 	void clear();
 
 private:
 	std::map<std::string, std::function<CarController* (Car&)> > m_register;
+	std::map<std::string, std::function<BatchController* ()> > m_batchRegister;
 };
 
 #endif // AIFACTORY_HPP
@@ -0,0 +1,75 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#include "aiupdater.hpp"
+#include "car.hpp"
+#include "pidcontroller.hpp"
+#include "timing.hpp"
+
+void AIUpdater::setControllers(const std::vector<AIPtr>& controllers) {
+	clear();
+	m_controllers = controllers;
+
+	for(AIPtr ai: m_controllers) {
+		PIDController* pid = dynamic_cast<PIDController*>(ai.get());
+		BatchController* batchController = pid ? pid->batchController() : nullptr;
+
+		if(!batchController) {
+			m_single.push_back(ai.get());
+			continue;
+		}
+
+		auto iter = m_batches.begin();
+		while(iter != m_batches.end() && iter->controller != batchController) iter++;
+
+		if(iter == m_batches.end()) {
+			m_batches.push_back(Batch());
+			m_batches.back().controller = batchController;
+			iter = m_batches.end() - 1;
+		}
+
+		iter->cars.push_back(pid);
+	}
+
+	for(Batch& batch: m_batches) {
+		batch.observations.resize(batch.cars.size());
+		batch.commands.resize(batch.cars.size());
+	}
+}
+
+void AIUpdater::clear() {
+	m_controllers.clear();
+	m_single.clear();
+	m_batches.clear();
+}
+
+void AIUpdater::update(const Timing& timing) {
+	for(CarController* ai: m_single) {
+		ai->update(timing.raceCompleted(ai->car().index()));
+	}
+
+	for(Batch& batch: m_batches) {
+		for(unsigned int i = 0; i < batch.cars.size(); i++) {
+			PIDController& pid = *batch.cars[i];
+			batch.observations[i] = pid.observe(timing.raceCompleted(pid.car().index()));
+		}
+
+		batch.controller->control(batch.observations, batch.commands);
+
+		for(unsigned int i = 0; i < batch.cars.size(); i++) {
+			batch.cars[i]->apply(batch.commands[i]);
+		}
+	}
+}
@@ -0,0 +1,58 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef AIUPDATER_HPP
+#define AIUPDATER_HPP
+
+#include "batchcontroller.hpp"
+#include "carcontroller.hpp"
+
+#include <vector>
+
+class PIDController;
+class Timing;
+
+/**
+* Updates the controllers of all cars once per tick. Controllers that
+* share a batch controller are observed together, the batch controller
+* is called once for all of them and the resulting commands are applied.
+* The rest are updated one by one, as before.
+**/
+class DUST_API AIUpdater {
+public:
+	//! Sets the controllers to update and groups them by their batch
+	//! controllers. Call again whenever the controllers change.
+	void setControllers(const std::vector<AIPtr>& controllers);
+
+	//! Removes all the controllers.
+	void clear();
+
+	//! Updates all the controllers.
+	void update(const Timing& timing);
+
+private:
+	struct Batch {
+		BatchController* controller;
+		std::vector<PIDController*> cars;
+		std::vector<CarObservation> observations;
+		std::vector<CarCommand> commands;
+	};
+
+	std::vector<AIPtr> m_controllers;
+	std::vector<CarController*> m_single;
+	std::vector<Batch> m_batches;
+};
+
+#endif // AIUPDATER_HPP
@@ -0,0 +1,69 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef BATCHCONTROLLER_HPP
+#define BATCHCONTROLLER_HPP
+
+#include "config.hpp"
+#include "piddata.hpp"
+#include "../common/tracktilebase.hpp"
+
+#include <memory>
+#include <vector>
+
+//! What a controller gets to see of a single car in a single tick.
+struct CarObservation {
+	DiffStore angularErrors;
+	DiffStore distanceErrors;
+	//! The control signals applied in the previous tick.
+	float steerControl = 0;
+	float speedControl = 0;
+	//! Current speed of the car in km/h.
+	float speed = 0;
+	//! The tile the car is currently on. tileType is a TrackTile::TileType,
+	//! kept as an int so that this header stays free of the graphics.
+	TrackTileBase::ComputerHint computerHint = TrackTileBase::CH_NONE;
+	int tileType = 0;
+	bool isRaceCompleted = false;
+};
+
+//! The control signals for a single car.
+struct CarCommand {
+	//! The steering angle; negative means left.
+	float steer = 0;
+	//! The prescribed speed; negative values mean braking.
+	float speed = 0;
+};
+
+/**
+* Computes the controls of any number of cars in a single call, so that
+* the per-call overhead of the controller (an interpreter call, a fuzzy
+* engine pass) is paid once per tick instead of once per car. The cars
+* themselves are driven by PIDControllers that have the batch controller
+* set; see AIUpdater.
+**/
+class DUST_API BatchController {
+public:
+	virtual ~BatchController() = default;
+
+	//! Writes a command for each of the observations; commands is
+	//! already sized to match observations.
+	virtual void control(const std::vector<CarObservation>& observations,
+		std::vector<CarCommand>& commands) = 0;
+};
+
+typedef std::shared_ptr<BatchController> BatchControllerPtr;
+
+#endif // BATCHCONTROLLER_HPP
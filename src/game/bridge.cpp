@@ -18,6 +18,7 @@
 #include "car.hpp"
 #include "layers.hpp"
 #include "renderer.hpp"
+#include "settings.hpp"
 
 #include <MCCollisionEvent>
 #include <MCRectShape>
@@ -61,12 +62,16 @@ Bridge::Bridge(MCSurface & surface, MCSurface & railSurface)
     m_rail0->setRenderLayer(static_cast<int>(Layers::Render::Objects));
     m_rail0->setCollisionLayer(static_cast<int>(Layers::Collision::BridgeRails));
     m_rail0->physicsComponent().setMass(0, true);
-    m_rail0->shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
 
     m_rail1->setRenderLayer(static_cast<int>(Layers::Render::Objects));
     m_rail1->setCollisionLayer(static_cast<int>(Layers::Collision::BridgeRails));
     m_rail1->physicsComponent().setMass(0, true);
-    m_rail1->shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+
+    if (!Settings::instance().getDisableRendering())
+    {
+        m_rail0->shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+        m_rail1->shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+    }
 
     const int triggerXDisplacement = WIDTH / 2;
 
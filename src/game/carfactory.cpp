@@ -44,7 +44,7 @@ CarPtr CarFactory::buildCar(int index, int numCars, Game & game)
     std::string carImage("carYellow");
     if (carImageMap.count(index))
     {
-        carImage = carImageMap[index];
+        carImage = carImageMap.at(index);
     }
 
     CarPtr car;
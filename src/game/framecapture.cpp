@@ -0,0 +1,58 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#include "framecapture.hpp"
+
+#include <QDir>
+#include <QImage>
+
+FrameCapture::FrameCapture(const QString& path, bool raw):
+	m_path(path), m_raw(raw), m_frameCount(0)
+{
+	if(m_raw) {
+		m_rawFile.setFileName(m_path);
+		m_rawFile.open(QIODevice::WriteOnly);
+	} else {
+		QDir().mkpath(m_path);
+	}
+}
+
+bool FrameCapture::isOpen() const {
+	return m_raw ? m_rawFile.isOpen() : QDir(m_path).exists();
+}
+
+bool FrameCapture::write(const QImage& frame) {
+	bool ok = false;
+
+	if(m_raw) {
+		const QImage rgba = frame.convertToFormat(QImage::Format_RGBA8888);
+		const int rowSize = rgba.width() * 4;
+
+		ok = true;
+		for(int y = 0; y < rgba.height() && ok; y++) {
+			ok = m_rawFile.write(reinterpret_cast<const char*>(rgba.constScanLine(y)), rowSize) == rowSize;
+		}
+	} else {
+		const QString fileName = QString("frame%1.png").arg(m_frameCount, 6, 10, QChar('0'));
+		ok = frame.save(m_path + QDir::separator() + fileName, "PNG");
+	}
+
+	if(ok) m_frameCount++;
+	return ok;
+}
+
+int FrameCapture::frameCount() const {
+	return m_frameCount;
+}
@@ -0,0 +1,60 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FRAMECAPTURE_HPP
+#define FRAMECAPTURE_HPP
+
+#include <QFile>
+#include <QString>
+
+class QImage;
+
+/**
+* Writes rendered frames either as a numbered PNG sequence into a
+* directory or as a raw RGBA stream into a file. The file can also be a
+* named pipe feeding an encoder, e.g.
+*
+*   ffmpeg -f rawvideo -pix_fmt rgba -s 1280x720 -r 60 -i frames.fifo out.mp4
+*
+* Raw frames are written top row first.
+**/
+class FrameCapture {
+public:
+	/**
+	* \param path Target directory, or the target file if raw is set.
+	* \param raw Write a raw RGBA stream instead of PNG images.
+	**/
+	FrameCapture(const QString& path, bool raw);
+
+	//! \return True if frames can be written.
+	bool isOpen() const;
+
+	/**
+	* Writes the given frame.
+	* \return False on a write error.
+	**/
+	bool write(const QImage& frame);
+
+	//! \return The number of frames written.
+	int frameCount() const;
+
+private:
+	QString m_path;
+	bool m_raw;
+	QFile m_rawFile;
+	int m_frameCount;
+};
+
+#endif // FRAMECAPTURE_HPP
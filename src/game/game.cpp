@@ -20,7 +20,10 @@
 #include "audioworker.hpp"
 #include "graphicsfactory.hpp"
 #include "eventhandler.hpp"
+#include "framecapture.hpp"
 #include "inputhandler.hpp"
+#include "race.hpp"
+#include "racerunner.hpp"
 #include "renderer.hpp"
 #include "scene.hpp"
 #include "statemachine.hpp"
@@ -42,7 +45,9 @@
 #include <QScreen>
 #include <QSurfaceFormat>
 
+#include <algorithm>
 #include <cassert>
+#include <iostream>
 
 static const unsigned int MAX_PLAYERS = 2;
 
@@ -76,7 +81,15 @@ Game::Game(bool forceNoVSync, bool forceNoSounds)
 {
     assert(!Game::m_instance);
     Game::m_instance = this;
-	createRenderer(forceNoVSync);
+
+	if(!m_settings.getHeadless()) {
+		createRenderer(forceNoVSync);
+	} else {
+		// No renderer to wait for: load geometry only and initialize as soon
+		// as the event loop is running.
+		m_assetManager->setGeometryOnly(true);
+		QMetaObject::invokeMethod(this, "init", Qt::QueuedConnection);
+	}
 
     const QString& mode = Settings::instance().getGameMode();
     if(mode == "OnePlayerRace") setMode(Mode::OnePlayerRace);
@@ -119,6 +132,10 @@ Game::Game(bool forceNoVSync, bool forceNoSounds)
 
     connect(m_stateMachine, &StateMachine::exitGameRequested, this, &Game::exitGame);
 
+    if(m_settings.getFastForward()) {
+    	MCLogger().info() << "Fast-forward mode enabled.";
+    }
+
     // Add race track search paths
     m_trackLoader->addTrackSearchPath(QString(Config::Common::dataPath) +
         QDir::separator() + "levels");
@@ -192,7 +209,14 @@ void Game::createRenderer(bool forceNoVSync)
 
 	if(!Settings::instance().getDisableRendering()) {
 
-		if (fullScreen)
+		if (m_settings.getCapture())
+		{
+		    // No window: the context and the offscreen surface
+		    // are created on the first renderNow().
+		    m_renderer->setOffscreen(true);
+		    QMetaObject::invokeMethod(m_renderer, "renderNow", Qt::QueuedConnection);
+		}
+		else if (fullScreen)
 		{
 		    m_renderer->showFullScreen();
 		}
@@ -311,7 +335,7 @@ void Game::initScene()
     assert(m_stateMachine);
 
     // Create the scene
-    m_scene = new Scene(*this, *m_stateMachine, *m_renderer, m_world);
+    m_scene = new Scene(*this, *m_stateMachine, m_renderer, m_world);
 
     // Add tracks to the menu.
     for (unsigned int i = 0; i < m_trackLoader->tracks(); i++)
@@ -322,13 +346,19 @@ void Game::initScene()
     // Set the current game scene. Renderer calls render()
     // for all objects in the scene.
     if(m_renderer) m_renderer->setScene(*m_scene);
+
+    if(m_settings.getFastForward() || m_settings.getCapture()) {
+    	connect(&m_scene->race(), &Race::finished, [this] () {
+    		std::cout << "result " << m_scene->race().resultRecord().toStdString() << std::endl;
+    	});
+    }
 }
 
 void Game::init()
 {
     Settings& settings = Settings::instance();
 
-	if(!settings.getDisableRendering()) {
+	if(!settings.getDisableRendering() && !settings.getCapture()) {
 		m_audioThread.start();
 		m_audioWorker->moveToThread(&m_audioThread);
 		QMetaObject::invokeMethod(m_audioWorker, "init");
@@ -337,6 +367,15 @@ void Game::init()
 
     m_assetManager->load();
 
+    if(settings.getHeadless()) {
+    	Renderer::loadFonts();
+    }
+
+    if(!settings.getJobFile().isEmpty()) {
+    	runJobs();
+    	return;
+    }
+
     if(settings.getMenusDisabled()) {
     	initScene();
 
@@ -372,7 +411,72 @@ void Game::init()
 void Game::start()
 {
     m_paused = false;
-    m_updateTimer.start();
+
+    if(m_settings.getFastForward()) {
+    	if(m_settings.getCapture()) {
+    		MCLogger().warning() << "Frame capture doesn't work when fast-forwarding and is ignored.";
+    	}
+    	runFastForward();
+    } else if(m_settings.getCapture()) {
+    	// Not directly, as start() may be called from within the first renderNow().
+    	QTimer::singleShot(0, this, &Game::runCapture);
+    } else {
+    	m_updateTimer.start();
+    }
+}
+
+void Game::runFastForward()
+{
+    // Same fixed time step as the timer-driven loop, but without waiting for
+    // the timer or rendering. Race::finished() ends up in exitGame(), which
+    // stops the loop.
+    while(!m_paused) {
+    	m_stateMachine->update();
+    	m_scene->updateFrame(m_timeStep);
+    	m_scene->updateAnimations();
+    }
+}
+
+void Game::runCapture()
+{
+    FrameCapture capture(m_settings.getCapturePath(), m_settings.getCaptureRaw());
+    if(!capture.isOpen()) {
+    	MCLogger().error() << "Cannot write frames to '" << m_settings.getCapturePath().toStdString() << "'.";
+    	exitGame();
+    	return;
+    }
+
+    // The same fixed-step loop as runFastForward(), so captured races
+    // are deterministic and don't depend on the rendering speed.
+    const int interval = std::max(1, m_settings.getCaptureInterval());
+    for(int frame = 0; !m_paused; frame++) {
+    	m_stateMachine->update();
+    	m_scene->updateFrame(m_timeStep);
+    	m_scene->updateAnimations();
+    	m_scene->updateOverlays();
+
+    	if(frame % interval == 0) {
+    		m_renderer->renderNow();
+    		if(!capture.write(m_renderer->grabFrame())) {
+    			MCLogger().error() << "Writing frame " << capture.frameCount() << " failed.";
+    			exitGame();
+    		}
+    	}
+    }
+
+    MCLogger().info() << capture.frameCount() << " frame(s) captured.";
+}
+
+void Game::runJobs()
+{
+    RaceRunner runner(*this, *m_trackLoader);
+    runner.loadJobs(m_settings.getJobFile());
+
+    if(const int failed = runner.run(m_settings.getThreadCount(), std::cout)) {
+    	MCLogger().error() << failed << " race(s) failed.";
+    }
+
+    exitGame();
 }
 
 void Game::stop()
@@ -398,7 +502,8 @@ void Game::togglePause()
 void Game::exitGame()
 {
     stop();
-    m_renderer->close();
+
+    if(m_renderer) m_renderer->close();
 
     m_audioThread.quit();
     m_audioThread.wait();
@@ -139,6 +139,15 @@ private:
 
     void createRenderer(bool forceNoVSync);
 
+    //! Runs the fixed-step update loop back-to-back until the game is stopped.
+    void runFastForward();
+
+    //! Like runFastForward(), but renders offscreen and writes out the frames.
+    void runCapture();
+
+    //! Runs the races of the job file instead of the game and exits.
+    void runJobs();
+
     void initScene();
 
     bool loadTracks();
@@ -62,6 +62,7 @@ HEADERS += \
     eventhandler.hpp \
     fadeanimation.hpp \
     fontfactory.hpp \
+    framecapture.hpp \
     game.hpp \
     graphicsfactory.hpp \
     help.hpp \
@@ -106,6 +107,7 @@ HEADERS += \
     trackobjectfactory.hpp \
     trackselectionmenu.hpp \
     tracktile.hpp \
+    tracktilebatch.hpp \
     treeview.hpp \
     updateableif.hpp \
     vsyncmenu.hpp \
@@ -151,6 +153,7 @@ HEADERS += \
     MiniCore/Graphics/mcglobjectbase.hh \
     MiniCore/Graphics/mcglscene.hh \
     MiniCore/Graphics/mcglshaderprogram.hh \
+    MiniCore/Graphics/mcglstatecache.hh \
     MiniCore/Graphics/mcgltexcoord.hh \
     MiniCore/Graphics/mcglvertex.hh \
     MiniCore/Graphics/mcmesh.hh \
@@ -158,6 +161,7 @@ HEADERS += \
     MiniCore/Graphics/mcshaders.hh \
     MiniCore/Graphics/mcshaders30.hh \
     MiniCore/Graphics/mcshadersGLES.hh \
+    MiniCore/Graphics/mcrendergrid.hh \
     MiniCore/Graphics/mcrenderlayer.hh \
     MiniCore/Graphics/mcshapeview.hh \
     MiniCore/Graphics/mcsurface.hh \
@@ -167,10 +171,11 @@ HEADERS += \
     MiniCore/Graphics/mcparticlerendererbase.hh \
     MiniCore/Graphics/mcsurfaceparticle.hh \
     MiniCore/Graphics/mcsurfaceparticlerenderer.hh \
+    MiniCore/Graphics/mcsurfaceobjectrenderer.hh \
     MiniCore/Physics/mccircleshape.hh \
     MiniCore/Physics/mccollisiondetector.hh \
     MiniCore/Physics/mccollisionevent.hh \
-    MiniCore/Physics/mccontact.hh \
+    MiniCore/Physics/mccontactmanifold.hh \
     MiniCore/Physics/mcdragforcegenerator.hh \
     MiniCore/Physics/mcedge.hh \
     MiniCore/Physics/mcforcegenerator.hh \
@@ -180,6 +185,7 @@ HEADERS += \
     MiniCore/Physics/mcimpulsegenerator.hh \
     MiniCore/Physics/mcobjectgrid.hh \
     MiniCore/Physics/mcoutofboundariesevent.hh \
+    MiniCore/Physics/mcphysicsbodystore.hh \
     MiniCore/Physics/mcrectshape.hh \
     MiniCore/Physics/mcsegment.hh \
     MiniCore/Physics/mcshape.hh \
@@ -225,6 +231,7 @@ SOURCES += \
     eventhandler.cpp \
     fadeanimation.cpp \
     fontfactory.cpp \
+    framecapture.cpp \
     game.cpp \
     graphicsfactory.cpp \
     help.cpp \
@@ -265,6 +272,7 @@ SOURCES += \
     trackobjectfactory.cpp \
     trackselectionmenu.cpp \
     tracktile.cpp \
+    tracktilebatch.cpp \
     treeview.cpp \
     vsyncmenu.cpp \
     MTFH/menu.cpp \
@@ -297,8 +305,10 @@ SOURCES += \
     MiniCore/Graphics/mcglobjectbase.cc \
     MiniCore/Graphics/mcglscene.cc \
     MiniCore/Graphics/mcglshaderprogram.cc \
+    MiniCore/Graphics/mcglstatecache.cc \
     MiniCore/Graphics/mcmesh.cc \
     MiniCore/Graphics/mcmeshview.cc \
+    MiniCore/Graphics/mcrendergrid.cc \
     MiniCore/Graphics/mcrenderlayer.cc \
     MiniCore/Graphics/mcsurface.cc \
     MiniCore/Graphics/mcsurfaceview.cc \
@@ -307,10 +317,11 @@ SOURCES += \
     MiniCore/Graphics/mcparticlerendererbase.cc \
     MiniCore/Graphics/mcsurfaceparticle.cc \
     MiniCore/Graphics/mcsurfaceparticlerenderer.cc \
+    MiniCore/Graphics/mcsurfaceobjectrenderer.cc \
     MiniCore/Physics/mccircleshape.cc \
     MiniCore/Physics/mccollisiondetector.cc \
     MiniCore/Physics/mccollisionevent.cc \
-    MiniCore/Physics/mccontact.cc \
+    MiniCore/Physics/mccontactmanifold.cc \
     MiniCore/Physics/mcdragforcegenerator.cc \
     MiniCore/Physics/mcforcegenerator.cc \
     MiniCore/Physics/mcforceregistry.cc \
@@ -319,6 +330,7 @@ SOURCES += \
     MiniCore/Physics/mcimpulsegenerator.cc \
     MiniCore/Physics/mcobjectgrid.cc \
     MiniCore/Physics/mcoutofboundariesevent.cc \
+    MiniCore/Physics/mcphysicsbodystore.cc \
     MiniCore/Physics/mcrectshape.cc \
     MiniCore/Physics/mcshape.cc \
     MiniCore/Physics/mcspringforcegenerator.cc \
@@ -16,6 +16,7 @@
 #include "intro.hpp"
 #include "game.hpp"
 #include "renderer.hpp"
+#include "settings.hpp"
 
 #include <MCAssetManager>
 #include <MCGLShaderProgram>
@@ -26,7 +27,10 @@ Intro::Intro()
 : m_back(MCAssetManager::surfaceManager().surface("intro"))
 , m_font(MCAssetManager::textureFontManager().font(Game::instance().fontName()))
 {
-    m_back.setShaderProgram(Renderer::instance().program("text"));
+    if (!Settings::instance().getDisableRendering())
+    {
+        m_back.setShaderProgram(Renderer::instance().program("text"));
+    }
     m_back.setColor(MCGLColor(0.9f, 0.9f, 0.9f, 1.0f));
 }
 
@@ -71,6 +71,14 @@ int main(int argc, char ** argv)
     QSettings::setDefaultFormat(QSettings::IniFormat);
 #endif
 
+#ifdef DUSTRAC_SIM
+    // The simulator never opens a window, so it must not need a display either.
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+#endif
+
     Application app(argc, argv);
     QTranslator appTranslator;
     QString lang = "";
@@ -124,6 +132,27 @@ int main(int argc, char ** argv)
 	QCommandLineOption disableRendering(QStringList() << "disable-rendering", QCoreApplication::translate("main", "Disables rendering."));
 	parser.addOption(disableRendering);
 
+	QCommandLineOption fastForward(QStringList() << "fast-forward", QCoreApplication::translate("main", "Runs the race unthrottled with a fixed time step and prints the result (implies --disable-rendering)."));
+	parser.addOption(fastForward);
+
+	QCommandLineOption jobFile(QStringList() << "jobs", QCoreApplication::translate("main", "Runs the races listed in the given file in parallel and prints their results (implies headless)."), "file");
+	parser.addOption(jobFile);
+
+	QCommandLineOption threadCount(QStringList() << "threads", QCoreApplication::translate("main", "Sets the number of races run in parallel with --jobs (0 = one per core)."), "n", "0");
+	parser.addOption(threadCount);
+
+	QCommandLineOption captureDir(QStringList() << "capture-dir", QCoreApplication::translate("main", "Renders the race offscreen as fast as possible and writes the frames as PNG images into the given directory (implies --disable-menus)."), "dir");
+	parser.addOption(captureDir);
+
+	QCommandLineOption captureRaw(QStringList() << "capture-raw", QCoreApplication::translate("main", "Like --capture-dir, but writes the frames as a raw RGBA stream into the given file or named pipe."), "file");
+	parser.addOption(captureRaw);
+
+	QCommandLineOption captureEvery(QStringList() << "capture-every", QCoreApplication::translate("main", "Captures only every n'th simulated frame (60 per second)."), "n", "1");
+	parser.addOption(captureEvery);
+
+	QCommandLineOption glStats(QStringList() << "gl-stats", QCoreApplication::translate("main", "Logs the GL call statistics of every n'th rendered frame."), "n", "0");
+	parser.addOption(glStats);
+
 	QCommandLineOption disableSounds(QStringList() << "disable-sounds", QCoreApplication::translate("main", "Disables sounds."));
 	parser.addOption(disableSounds);
 
@@ -157,8 +186,28 @@ int main(int argc, char ** argv)
 	settings.setCustomTrackFile(parser.value(customTrackFile));
 	settings.setLapCount(parser.value(lapCount).toInt());
 	settings.setDisableRendering(parser.isSet(disableRendering));
+	settings.setFastForward(parser.isSet(fastForward));
+#ifdef DUSTRAC_SIM
+	settings.setHeadless(true);
+#endif
+	settings.setJobFile(parser.value(jobFile));
+	settings.setThreadCount(parser.value(threadCount).toInt());
 	settings.setResetStuckPlayer(parser.isSet(stuckPlayerCheck));
 	settings.setCameraSmoothing(parser.value(cameraSmoothing).toFloat());
+	settings.setGLStatsInterval(parser.value(glStats).toInt());
+
+	if(parser.isSet(captureDir) || parser.isSet(captureRaw)) {
+		if(settings.getFastForward()) {
+			MCLogger().warning() << "Frame capture doesn't work with --fast-forward and is ignored.";
+		} else if(settings.getDisableRendering()) {
+			MCLogger().warning() << "Frame capture needs rendering and is ignored.";
+		} else if(parser.isSet(captureRaw)) {
+			settings.setCapturePath(parser.value(captureRaw), true);
+		} else {
+			settings.setCapturePath(parser.value(captureDir), false);
+		}
+		settings.setCaptureInterval(parser.value(captureEvery).toInt());
+	}
 
 	if(parser.isSet(fullscreenOpt) || parser.isSet(windowedOpt) || parser.isSet(hresOpt) || parser.isSet(vresOpt)) {
 		int hRes, vRes;
@@ -179,7 +228,7 @@ int main(int argc, char ** argv)
     // Create the main game object. The game loop starts immediately after
     // the Renderer has been initialized.
     MCLogger().info() << "Creating game object..";
-    Game game(parser.isSet(vsyncOption), parser.isSet(disableSounds));
+    Game game(parser.isSet(vsyncOption), parser.isSet(disableSounds) || settings.getCapture());
 
 	MCLogger().info() << "Initializing loaded plugins...'";
 	// initialize all plugins
@@ -12,22 +12,54 @@
 #include <MCTypes>
 
 PIDController::PIDController(Car& car, bool random):
-CarController(car), m_data(random)
+CarController(car), m_data(random), m_batchObservations(1), m_batchCommands(1)
 {
 }
 
 void PIDController::update(bool isRaceCompleted) {
+	observe(isRaceCompleted);
+
+	CarCommand command;
+	if(m_batchController) {
+		m_batchObservations[0] = m_observation;
+		m_batchController->control(m_batchObservations, m_batchCommands);
+		command = m_batchCommands[0];
+	} else {
+		// query the controllers
+		command.steer = steerControl(isRaceCompleted);
+		command.speed = speedControl(isRaceCompleted);
+	}
+
+	apply(command);
+}
+
+const CarObservation& PIDController::observe(bool isRaceCompleted) {
 	if(!m_track) throw std::runtime_error("Track must be set for the PIDController before calling update.");
 
 	m_car.clearStatuses();
 	m_data.updateErrors(m_car, m_track->trackData().route());
 
-	// query the controllers
-	float steerC = steerControl(isRaceCompleted);
-	float speedC = speedControl(isRaceCompleted);
+	const TrackTile& currentTile = *m_track->trackTileAtLocation(
+		m_car.location().i(), m_car.location().j());
+
+	m_observation.angularErrors = m_data.angularErrors;
+	m_observation.distanceErrors = m_data.distanceErrors;
+	m_observation.steerControl = m_data.steerControl;
+	m_observation.speedControl = m_data.speedControl;
+	m_observation.speed = m_car.speedInKmh();
+	m_observation.computerHint = currentTile.computerHint();
+	m_observation.tileType = currentTile.tileTypeEnum();
+	m_observation.isRaceCompleted = isRaceCompleted;
+
+	return m_observation;
+}
+
+void PIDController::apply(const CarCommand& command) {
+	float steerC = command.steer;
+	float speedC = command.speed;
 
 	// report the progress to listeners
-	report(steerC, speedC, isRaceCompleted);
+	report(steerC, speedC, m_observation.isRaceCompleted);
 	// log the control signals in CarData
 	m_data.updateControl(steerC, speedC);
 
@@ -48,27 +80,38 @@ void PIDController::update(bool isRaceCompleted) {
 	else if(speedC > m_car.speedInKmh()) m_car.accelerate();
 }
 
+void PIDController::setBatchController(const BatchControllerPtr& batchController) {
+	m_batchController = batchController;
+}
+
 float PIDController::steerControl(bool)
 {
-	return -(m_data.angularErrors.error * 0.025 + m_data.angularErrors.deltaError * 0.025);
+	return pidSteerControl(m_observation);
+}
+
+float PIDController::speedControl(bool)
+{
+	return pidSpeedControl(m_observation);
 }
 
-float PIDController::speedControl(bool isRaceCompleted)
+float PIDController::pidSteerControl(const CarObservation& observation)
+{
+	return -(observation.angularErrors.error * 0.025 + observation.angularErrors.deltaError * 0.025);
+}
+
+float PIDController::pidSpeedControl(const CarObservation& observation)
 {
     // TODO: Maybe it'd be possible to adjust speed according to
     // the difference between current and target angles so that
     // computer hints wouldn't be needed anymore..?
 
-	TrackTile      & currentTile = *m_track->trackTileAtLocation(
-    m_car.location().i(), m_car.location().j());
-
 	// Current speed of the car.
-    const float absSpeed = m_car.speedInKmh();
+    const float absSpeed = observation.speed;
 	// The prescribed speed under the circumnstances.
 	// By default, we accelerate slightly.
 	float controlSpeed = absSpeed + 1;
 
-    if (isRaceCompleted)
+    if (observation.isRaceCompleted)
     {
         return 0;
     }
@@ -76,7 +119,7 @@ float PIDController::speedControl(bool isRaceCompleted)
     {
         // The following speed limits are experimentally defined.
         float scale = 8.1;
-        if (currentTile.computerHint() == TrackTile::CH_BRAKE)
+        if (observation.computerHint == TrackTile::CH_BRAKE)
         {
             if (absSpeed > 14.0 * scale)
             {
@@ -84,7 +127,7 @@ float PIDController::speedControl(bool isRaceCompleted)
             }
         }
 
-        if (currentTile.computerHint() == TrackTile::CH_BRAKE_HARD)
+        if (observation.computerHint == TrackTile::CH_BRAKE_HARD)
         {
             if (absSpeed > 9.5 * scale)
             {
@@ -92,7 +135,7 @@ float PIDController::speedControl(bool isRaceCompleted)
             }
         }
 
-        if (currentTile.tileTypeEnum() == TrackTile::TT_CORNER_90)
+        if (observation.tileType == TrackTile::TT_CORNER_90)
         {
 
 			if (absSpeed > 7.0 * scale)
@@ -101,8 +144,8 @@ float PIDController::speedControl(bool isRaceCompleted)
             }
         }
 
-        if (currentTile.tileTypeEnum() == TrackTile::TT_CORNER_45_LEFT ||
-            currentTile.tileTypeEnum() == TrackTile::TT_CORNER_45_RIGHT)
+        if (observation.tileType == TrackTile::TT_CORNER_45_LEFT ||
+            observation.tileType == TrackTile::TT_CORNER_45_RIGHT)
         {
 			if (absSpeed > 8.3 * scale) {
 				controlSpeed = absSpeed; // we don't accelerate
@@ -17,6 +17,7 @@
 #define PIDCONTROLLER_HPP
 
 #include "carcontroller.hpp"
+#include "batchcontroller.hpp"
 #include "piddata.hpp"
 #include <MCVector2d>
 
@@ -32,8 +33,30 @@ public:
 	//! control and calls steerControl and speedControl, which
 	//! may be reimplemented using other types of control.
 	//! In this version steerControl is called before speedControl.
+	//! With a batch controller set, the batch controller is
+	//! queried instead, with this car alone.
     virtual void update(bool isRaceCompleted);
 
+	//! Recomputes the errors and returns what the controller sees of
+	//! the car. The first half of update().
+	const CarObservation& observe(bool isRaceCompleted);
+
+	//! Reports the command to the listeners and applies it to the car.
+	//! The second half of update().
+	void apply(const CarCommand& command);
+
+	//! Makes the car get its controls from the batch controller, which
+	//! may be shared with other cars.
+	void setBatchController(const BatchControllerPtr& batchController);
+
+	BatchController* batchController() const {return m_batchController.get();}
+
+	//! The default steering logic as applied to an observation.
+	static float pidSteerControl(const CarObservation& observation);
+
+	//! The default brake/accelerate logic as applied to an observation.
+	static float pidSpeedControl(const CarObservation& observation);
+
 protected:
 	//! Steering logic. Returns the steering angle in degrees.
 	//! Negative means left.
@@ -45,6 +68,13 @@ protected:
 
 protected:
 	PIDData m_data;
+	CarObservation m_observation;
+	BatchControllerPtr m_batchController;
+
+private:
+	//! Single-car buffers for the batch controller, reused between updates.
+	std::vector<CarObservation> m_batchObservations;
+	std::vector<CarCommand> m_batchCommands;
 };
 
 #endif // PIDCONTROLLER_HPP
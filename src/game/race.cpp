@@ -37,6 +37,7 @@
 #include <MCAssetManager>
 #include <MCObjectFactory>
 #include <MCPhysicsComponent>
+#include <MCRandom>
 #include <MCShape>
 #include <MCShapeView>
 #include <MCSurfaceManager>
@@ -56,6 +57,7 @@ Race::Race(Game & game, unsigned int numCars)
 , m_winnerFinished(false)
 , m_isfinishedSignalSent(false)
 , m_bestPos(-1)
+, m_isPersistent(true)
 , m_offTrackCounter(0)
 , m_game(game)
 {
@@ -65,13 +67,17 @@ Race::Race(Game & game, unsigned int numCars)
     m_offTrackMessageTimer.setInterval(30000);
 
     connect(&m_timing, &Timing::lapRecordAchieved, [this] (int msecs) {
-        Settings::instance().saveLapRecord(*m_track, msecs);
+        if (m_isPersistent) {
+            Settings::instance().saveLapRecord(*m_track, msecs);
+        }
         emit messageRequested(QObject::tr("New lap record!"));
     });
 
     connect(&m_timing, &Timing::raceRecordAchieved, [this] (int msecs) {
         if (m_game.hasComputerPlayers()) {
-            Settings::instance().saveRaceRecord(*m_track, msecs, m_lapCount, m_game.difficultyProfile().difficulty());
+            if (m_isPersistent) {
+                Settings::instance().saveRaceRecord(*m_track, msecs, m_lapCount, m_game.difficultyProfile().difficulty());
+            }
             emit messageRequested(QObject::tr("New race record!"));
         }
     });
@@ -113,8 +119,12 @@ void Race::init(Track & track, int lapCount)
 
 void Race::initTiming()
 {
-    m_timing.setLapRecord(Settings::instance().loadLapRecord(*m_track));
-    m_timing.setRaceRecord(Settings::instance().loadRaceRecord(*m_track, m_lapCount, m_game.difficultyProfile().difficulty()));
+    if (m_isPersistent)
+    {
+        m_timing.setLapRecord(Settings::instance().loadLapRecord(*m_track));
+        m_timing.setRaceRecord(Settings::instance().loadRaceRecord(*m_track, m_lapCount, m_game.difficultyProfile().difficulty()));
+    }
+
     m_timing.reset();
 }
 
@@ -185,7 +195,7 @@ void Race::translateCarsToStartPositions()
 
         // Move the human player to a starting place that equals the best position
         // of the current race track.
-        if (m_game.hasComputerPlayers() && !m_game.hasTwoHumanPlayers())
+        if (m_isPersistent && m_game.hasComputerPlayers() && !m_game.hasTwoHumanPlayers())
         {
             const int bestPos = Settings::instance().loadBestPos(*m_track, m_lapCount, m_game.difficultyProfile().difficulty());
             if (bestPos > 0)
@@ -454,7 +464,8 @@ void Race::checkForNewBestPosition(const Car & car)
 {
     // Check if the race is completed for a human player and if so,
     // check if new best pos achieved and save it.
-    if (m_game.mode() == Game::Mode::OnePlayerRace || m_game.mode() == Game::Mode::TwoPlayerRace)
+    if (m_isPersistent &&
+        (m_game.mode() == Game::Mode::OnePlayerRace || m_game.mode() == Game::Mode::TwoPlayerRace))
     {
         if (car.isHuman())
         {
@@ -544,8 +555,8 @@ void Race::moveCarOntoPreviousCheckPoint(Car & car)
     TargetNodePtr tnode = route.get(car.prevTargetNodeIndex());
     const int randRadius = 64;
     car.translate(MCVector3dF(
-        tnode->location().x() + rand() % randRadius - randRadius / 2,
-        tnode->location().y() + rand() % randRadius - randRadius / 2));
+        tnode->location().x() + static_cast<int>(MCRandom::getValue() * randRadius) - randRadius / 2,
+        tnode->location().y() + static_cast<int>(MCRandom::getValue() * randRadius) - randRadius / 2));
     car.physicsComponent().reset();
 }
 
@@ -585,7 +596,8 @@ void Race::setTrack(Track & track, int lapCount)
 {
     m_lapCount = lapCount;
     m_track    = &track;
-    m_bestPos  = Settings::instance().loadBestPos(*m_track, m_lapCount, m_game.difficultyProfile().difficulty());
+    m_bestPos  = m_isPersistent ?
+        Settings::instance().loadBestPos(*m_track, m_lapCount, m_game.difficultyProfile().difficulty()) : -1;
 
     for (OffTrackDetectorPtr otd : m_offTrackDetectors)
     {
@@ -602,6 +614,11 @@ void Race::setLapCount(int lapCount_) {
 	m_lapCount = lapCount_;
 }
 
+void Race::setPersistent(bool persistent)
+{
+    m_isPersistent = persistent;
+}
+
 void Race::addCar(Car & car)
 {
     if (find(m_cars.begin(), m_cars.end(), &car) == m_cars.end())
@@ -627,6 +644,23 @@ bool Race::checkeredFlagEnabled() const
     return m_checkeredFlagEnabled;
 }
 
+QString Race::resultRecord() const
+{
+    QString record = QString("track=%1 laps=%2").arg(m_track ? m_track->trackData().name() : QString()).arg(m_lapCount);
+
+    const int numHumans = m_game.hasTwoHumanPlayers() ? 2 : 1;
+    for (int i = HUMAN_PLAYER_INDEX1; i < numHumans && i < static_cast<int>(m_cars.size()); i++)
+    {
+        record += QString(" p%1.position=%2 p%1.raceTime=%3 p%1.bestLap=%4")
+            .arg(i + 1)
+            .arg(getPositionOfCar(*m_cars[i]))
+            .arg(m_timing.raceTime(i))
+            .arg(m_timing.recordLapTime(i));
+    }
+
+    return record;
+}
+
 bool Race::isRaceFinished() const
 {
     if (m_game.hasTwoHumanPlayers())
@@ -62,6 +62,11 @@ public:
     //! Set the number of laps.
     void setLapCount(int lapCount);
 
+    /*! Load and save records, best positions and track unlocks in the
+     *  settings. Enabled by default; batch simulations disable it so that
+     *  they don't touch the player's settings. */
+    void setPersistent(bool persistent);
+
     //! Add a car to the race.
     void addCar(Car & car);
 
@@ -75,6 +80,10 @@ public:
 
     Car & getLeadingCar() const;
 
+    /*! \return a single-line, machine-readable summary of the race
+     *  from the human player(s) point of view. */
+    QString resultRecord() const;
+
 signals:
 
     void finished();
@@ -164,6 +173,8 @@ private:
 
     int m_bestPos;
 
+    bool m_isPersistent;
+
     QTimer m_offTrackMessageTimer;
 
     int m_offTrackCounter;
@@ -0,0 +1,432 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#include "racerunner.hpp"
+
+#include "aifactory.hpp"
+#include "aiupdater.hpp"
+#include "bridge.hpp"
+#include "car.hpp"
+#include "carfactory.hpp"
+#include "game.hpp"
+#include "listenerbank.hpp"
+#include "loadplugins.hpp"
+#include "pidcontroller.hpp"
+#include "pit.hpp"
+#include "race.hpp"
+#include "scene.hpp"
+#include "settings.hpp"
+#include "track.hpp"
+#include "trackdata.hpp"
+#include "trackloader.hpp"
+#include "trackobject.hpp"
+#include "tracktile.hpp"
+
+#include <MCAssetManager>
+#include <MCLogger>
+#include <MCRandom>
+#include <MCWorld>
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <stdexcept>
+
+//! Same fixed step the timer-driven game loop uses; Timing assumes 60 Hz.
+static const float TIME_STEP = 1.0f / 60;
+
+//! The default race time limit per lap.
+static const int LAP_TIME_LIMIT = 10 * 60 * 1000;
+
+//! A worker thread. QThread rather than std::thread, because races own timers.
+class RaceRunner::Worker : public QThread {
+public:
+	Worker(RaceRunner& runner, WorkStealingQueue<const Job*>& queue, unsigned int index):
+		m_runner(runner), m_queue(queue), m_index(index) {}
+
+protected:
+	void run() override {
+		m_runner.runJobs(m_queue, m_index);
+	}
+
+private:
+	RaceRunner& m_runner;
+	WorkStealingQueue<const Job*>& m_queue;
+	unsigned int m_index;
+};
+
+//! Passes reports on to a listener shared by all worker threads, one at a time.
+class SerializedListener : public Listener {
+public:
+	SerializedListener(const ListenerPtr& listener, std::mutex& mutex):
+		m_listener(listener), m_mutex(mutex) {}
+
+	void report(const Car& car, const Track* track, float steerControl,
+		float speedControl, bool isRaceCompleted) override
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_listener->report(car, track, steerControl, speedControl, isRaceCompleted);
+	}
+
+private:
+	ListenerPtr m_listener;
+	std::mutex& m_mutex;
+};
+
+//! Splits a line at white space that is not inside double quotes.
+static QStringList splitFields(const QString& line) {
+	QStringList fields;
+	QString field;
+	bool quoted = false;
+
+	for(QChar c: line) {
+		if(c == '"') {
+			quoted = !quoted;
+		} else if(c.isSpace() && !quoted) {
+			if(!field.isEmpty()) fields << field;
+			field.clear();
+		} else {
+			field += c;
+		}
+	}
+
+	if(!field.isEmpty()) fields << field;
+	return fields;
+}
+
+RaceRunner::RaceRunner(Game& game, const TrackLoader& trackLoader):
+	m_game(game), m_trackLoader(trackLoader), m_timeLimit(0), m_out(nullptr), m_failed(0) {}
+
+void RaceRunner::loadJobs(const QString& fileName) {
+	QFile file(fileName);
+	if(!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		throw std::runtime_error("Couldn't open job file '" + fileName.toStdString() + "'.");
+	}
+
+	const Settings& settings = Settings::instance();
+
+	QTextStream in(&file);
+	int lineNumber = 0;
+	while(!in.atEnd()) {
+		const QString line = in.readLine().trimmed();
+		lineNumber++;
+
+		if(line.isEmpty() || line.startsWith('#')) continue;
+
+		Job job;
+		job.trackFile = settings.getCustomTrackFile();
+		job.controllerType = settings.getControllerType();
+		job.lapCount = m_game.lapCount();
+
+		for(const QString& field: splitFields(line)) {
+			const int sep = field.indexOf('=');
+			const QString key = field.left(sep);
+			const QString value = field.mid(sep + 1);
+			bool ok = sep > 0;
+
+			if(!ok) {
+				// Reported below.
+			} else if(key == "track") {
+				job.trackFile = value;
+			} else if(key == "controller") {
+				job.controllerType = value;
+			} else if(key == "laps") {
+				job.lapCount = value.toInt(&ok);
+				ok = ok && job.lapCount > 0;
+			} else if(key == "seed") {
+				job.seed = value.toInt(&ok);
+			} else if(PluginRegister.count(key.toStdString())) {
+				job.pluginArgs[key.toStdString()] = value;
+			} else {
+				ok = false;
+			}
+
+			if(!ok) {
+				throw std::runtime_error(QString("%1:%2: invalid field '%3'.")
+					.arg(fileName).arg(lineNumber).arg(field).toStdString());
+			}
+		}
+
+		addJob(job);
+	}
+
+	MCLogger().info() << m_jobs.size() << " race(s) loaded from '" << fileName.toStdString() << "'.";
+}
+
+void RaceRunner::addJob(const Job& job) {
+	m_jobs.push_back(job);
+	m_jobs.back().index = static_cast<int>(m_jobs.size()) - 1;
+}
+
+void RaceRunner::setTimeLimit(int msecs) {
+	m_timeLimit = msecs;
+}
+
+void RaceRunner::createControllerFactories() {
+	AIFactory& factory = AIFactory::instance();
+
+	// Plugins register their controllers when initialized, so take the
+	// default ones before any job re-initializes a plugin.
+	for(Job& job: m_jobs) {
+		if(!job.createController && job.pluginArgs.empty()) {
+			job.createController = factory.creationFunction(job.controllerType.toStdString());
+			job.createBatchController = factory.batchCreationFunction(job.controllerType.toStdString());
+		}
+	}
+
+	for(Job& job: m_jobs) {
+		if(!job.createController) {
+			for(auto& args: job.pluginArgs) {
+				QStringList argv = makeArgs(QCoreApplication::applicationFilePath(), args.second);
+				initPlugin(*PluginRegister.at(args.first), argv);
+			}
+
+			job.createController = factory.creationFunction(job.controllerType.toStdString());
+			job.createBatchController = factory.batchCreationFunction(job.controllerType.toStdString());
+		}
+	}
+}
+
+void RaceRunner::createListeners() {
+	const ListenerBank& bank = ListenerBank::instance();
+
+	m_listeners.assign(bank.size(), std::set<ListenerPtr>());
+	for(unsigned int i = 0; i < bank.size(); i++) {
+		for(const ListenerPtr& listener: bank.getListeners(i)) {
+			m_listeners[i].insert(ListenerPtr(new SerializedListener(listener, m_listenerMutex)));
+		}
+	}
+}
+
+void RaceRunner::createSurfaceViews() const {
+	MCWorld world;
+	world.setMetersPerUnit(Scene::metersPerUnit());
+
+	// The start grid objects.
+	Race race(m_game, Scene::NUM_CARS);
+
+	std::vector<CarPtr> cars;
+	for(int i = 0; i < Scene::NUM_CARS; i++) {
+		cars.push_back(CarPtr(CarFactory::buildCar(i, Scene::NUM_CARS, m_game)));
+	}
+
+	Bridge bridge(
+		MCAssetManager::instance().surfaceManager().surface("bridgeObject"),
+		MCAssetManager::instance().surfaceManager().surface("wallLong"));
+
+	// The objects of every track that is raced on.
+	std::set<QString> trackFiles;
+	for(const Job& job: m_jobs) {
+		if(trackFiles.insert(job.trackFile).second) {
+			delete m_trackLoader.loadTrack(job.trackFile, QFileInfo(job.trackFile).isAbsolute());
+		}
+	}
+}
+
+int RaceRunner::run(int numThreads, std::ostream& out) {
+	if(m_jobs.empty()) return 0;
+
+	// Plugins are initialized here, in the calling thread.
+	createControllerFactories();
+	createListeners();
+	createSurfaceViews();
+
+	if(numThreads <= 0) numThreads = QThread::idealThreadCount();
+	numThreads = std::max(1, std::min(numThreads, static_cast<int>(m_jobs.size())));
+
+	MCLogger().info() << "Running " << m_jobs.size() << " race(s) on " << numThreads << " thread(s)..";
+
+	// Deal the jobs out in order; the workers balance the rest by stealing.
+	WorkStealingQueue<const Job*> queue(numThreads);
+	for(const Job& job: m_jobs) {
+		queue.push(job.index % numThreads, &job);
+	}
+
+	m_out = &out;
+	m_failed = 0;
+
+	std::vector<std::unique_ptr<Worker> > workers;
+	for(int i = 0; i < numThreads; i++) {
+		workers.emplace_back(new Worker(*this, queue, i));
+		workers.back()->start();
+	}
+
+	for(auto& worker: workers) {
+		worker->wait();
+	}
+
+	m_out = nullptr;
+	return m_failed;
+}
+
+void RaceRunner::runJobs(WorkStealingQueue<const Job*>& queue, unsigned int worker) {
+	const Job* job = nullptr;
+	while(queue.pop(worker, job)) {
+		try {
+			writeRecord(runRace(*job));
+		} catch(std::exception& e) {
+			MCLogger().error() << "Race " << job->index << " failed: " << e.what();
+			m_failed++;
+		}
+	}
+}
+
+QString RaceRunner::runRace(const Job& job) const {
+	MCRandom::setSeed(job.seed);
+
+	// The world of this thread. Declared first so that it outlives
+	// everything added to it.
+	MCWorld world;
+	world.setMetersPerUnit(Scene::metersPerUnit());
+
+	TrackData* trackData = m_trackLoader.loadTrack(job.trackFile, QFileInfo(job.trackFile).isAbsolute());
+	if(!trackData) {
+		throw std::runtime_error("Couldn't load track '" + job.trackFile.toStdString() + "'.");
+	}
+
+	Track track(trackData);
+	world.setDimensions(0, track.width(), 0, track.height(), 0, 1000, Scene::metersPerUnit());
+
+	Race race(m_game, Scene::NUM_CARS);
+	race.setPersistent(false);
+
+	// The rest mirrors Scene::setActiveTrack() without the presentation.
+	std::vector<CarPtr> cars;
+	std::vector<AIPtr> ai;
+	BatchControllerPtr batchController(job.createBatchController ? job.createBatchController() : nullptr);
+	for(int i = 0; i < Scene::NUM_CARS; i++) {
+		CarPtr car(CarFactory::buildCar(i, Scene::NUM_CARS, m_game));
+		if(!car) continue;
+
+		if(car->isHuman()) {
+			ai.push_back(AIPtr(AIFactory::create(job.createController, batchController, *car)));
+		} else {
+			ai.push_back(AIPtr(new PIDController(*car, true)));
+		}
+
+		if(i < static_cast<int>(m_listeners.size())) {
+			ai.back()->setListeners(&m_listeners[i]);
+		}
+
+		cars.push_back(car);
+		race.addCar(*car);
+	}
+
+	for(CarPtr car: cars) {
+		car->addToWorld();
+	}
+
+	for(unsigned int i = 0; i < trackData->objects().count(); i++) {
+		TrackObject* trackObject = dynamic_cast<TrackObject*>(trackData->objects().object(i).get());
+		MCObject& object = trackObject->object();
+		object.addToWorld();
+		object.translate(object.initialLocation());
+		object.rotate(object.initialAngle());
+
+		if(Pit* pit = dynamic_cast<Pit*>(&object)) {
+			QObject::connect(pit, &Pit::pitStop, &race, &Race::pitStop);
+		}
+	}
+
+	std::vector<MCObjectPtr> bridges;
+	const MapBase& map = trackData->map();
+	for(MCUint j = 0; j <= map.rows(); j++) {
+		for(MCUint i = 0; i <= map.cols(); i++) {
+			TrackTile* tile = dynamic_cast<TrackTile*>(map.getTile(i, j).get());
+			if(tile && tile->tileTypeEnum() == TrackTile::TT_BRIDGE) {
+				MCObjectPtr bridge(new Bridge(
+					MCAssetManager::instance().surfaceManager().surface("bridgeObject"),
+					MCAssetManager::instance().surfaceManager().surface("wallLong")));
+
+				bridge->translate(MCVector3dF(
+					i * TrackTile::TILE_W + TrackTile::TILE_W / 2,
+					j * TrackTile::TILE_H + TrackTile::TILE_H / 2, Bridge::zOffset()));
+				bridge->rotate(tile->rotation());
+				bridge->addToWorld();
+
+				bridges.push_back(bridge);
+			}
+		}
+	}
+
+	race.init(track, job.lapCount);
+
+	for(AIPtr controller: ai) {
+		controller->setTrack(track);
+	}
+
+	AIUpdater aiUpdater;
+	aiUpdater.setControllers(ai);
+
+	bool finished = false;
+	QObject::connect(&race, &Race::finished, [&finished] () {
+		finished = true;
+	});
+
+	race.start();
+
+	// Per human player: lap times and the number of times off the track.
+	const unsigned int numHumans = std::min<unsigned int>(m_game.hasTwoHumanPlayers() ? 2 : 1, cars.size());
+	std::vector<QStringList> lapTimes(numHumans);
+	std::vector<int> offTrackCounts(numHumans, 0);
+	std::vector<bool> wasOffTrack(numHumans, false);
+
+	const int timeLimit = m_timeLimit > 0 ? m_timeLimit : job.lapCount * LAP_TIME_LIMIT;
+	Timing& timing = race.timing();
+
+	while(!finished && timing.raceTime() < timeLimit) {
+		aiUpdater.update(timing);
+
+		world.stepTime(TIME_STEP);
+		race.update();
+
+		for(CarPtr car: cars) {
+			car->update();
+		}
+
+		for(unsigned int i = 0; i < numHumans; i++) {
+			if(timing.lap(i) > lapTimes[i].size()) {
+				lapTimes[i] << QString::number(timing.lastLapTime(i));
+			}
+
+			const bool offTrack = cars[i]->isOffTrack();
+			if(offTrack && !wasOffTrack[i]) offTrackCounts[i]++;
+			wasOffTrack[i] = offTrack;
+		}
+	}
+
+	QString record = QString("job=%1 controller=%2 seed=%3 finished=%4 ")
+		.arg(job.index).arg(job.controllerType).arg(job.seed).arg(finished ? 1 : 0);
+	record += race.resultRecord();
+
+	for(unsigned int i = 0; i < numHumans; i++) {
+		record += QString(" p%1.lapTimes=%2 p%1.offTrack=%3")
+			.arg(i + 1).arg(lapTimes[i].join(",")).arg(offTrackCounts[i]);
+	}
+
+	return record;
+}
+
+void RaceRunner::writeRecord(const QString& record) {
+	std::lock_guard<std::mutex> lock(m_outMutex);
+	*m_out << "result " << record.toStdString() << std::endl;
+}
@@ -0,0 +1,138 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef RACERUNNER_HPP
+#define RACERUNNER_HPP
+
+#include <QString>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "listener.hpp"
+#include "workstealingqueue.hpp"
+
+class BatchController;
+class Car;
+class CarController;
+class Game;
+class TrackLoader;
+
+/**
+* Runs a batch of headless races on a pool of worker threads. Every race
+* gets a world, track and race of its own, so the races don't affect each
+* other. One result record is written per race as soon as it finishes.
+*
+* Jobs are read from a text file with one race per line, given as
+* key=value fields (values with spaces in double quotes):
+*
+*   track=infinity.trk controller=fuzzy laps=3 seed=7 FuzzyController="-p a.fis"
+*
+* Fields left out default to the command line settings. A field named after
+* a loaded plugin re-initializes that plugin with the given arguments for
+* that job. Controllers are created, run and destroyed in the worker
+* threads, so plugins have to be thread-safe; the Python controller takes
+* the GIL on every call, so its controllers run one at a time.
+*
+* The listeners of the ListenerBank are shared by all races, so their
+* reports are serialized: only one listener is called at a time, whatever
+* the number of threads. Listeners still see the cars of all concurrent
+* races interleaved.
+**/
+class RaceRunner {
+public:
+	//! A single race.
+	struct Job {
+		int index = 0;
+		QString trackFile;
+		QString controllerType;
+		//! Plugin name to plugin arguments.
+		std::map<std::string, QString> pluginArgs;
+		int lapCount = 1;
+		int seed = 0;
+		std::function<CarController* (Car&)> createController;
+		//! Empty if the controller has no batch version.
+		std::function<BatchController* ()> createBatchController;
+	};
+
+public:
+	RaceRunner(Game& game, const TrackLoader& trackLoader);
+
+	/**
+	* Reads jobs from the given file.
+	* \exception std::runtime_error Throws when the file can't be read
+	* or has invalid fields.
+	**/
+	void loadJobs(const QString& fileName);
+
+	//! Adds a single job.
+	void addJob(const Job& job);
+
+	//! Races that haven't finished within this much of race time are stopped.
+	void setTimeLimit(int msecs);
+
+	/**
+	* Runs all jobs and writes their result records to the given stream.
+	* \param numThreads Number of worker threads; 0 uses one per core.
+	* \return The number of jobs that failed.
+	**/
+	int run(int numThreads, std::ostream& out);
+
+private:
+	class Worker;
+
+	//! Resolves the controller creation functions of all jobs.
+	void createControllerFactories();
+
+	//! Wraps the listeners of the ListenerBank so that they are called
+	//! one at a time.
+	void createListeners();
+
+	/**
+	* Builds every kind of object the jobs use once in the calling thread.
+	* Constructing a surface view writes the shader programs of its surface,
+	* and the surfaces are shared by all threads; once they are set, views
+	* built by the workers only read them.
+	**/
+	void createSurfaceViews() const;
+
+	void runJobs(WorkStealingQueue<const Job*>& queue, unsigned int worker);
+
+	//! Runs a single race in the calling thread and returns its result record.
+	QString runRace(const Job& job) const;
+
+	void writeRecord(const QString& record);
+
+	Game& m_game;
+	const TrackLoader& m_trackLoader;
+	std::vector<Job> m_jobs;
+	int m_timeLimit;
+
+	std::ostream* m_out;
+	std::mutex m_outMutex;
+	std::atomic<int> m_failed;
+
+	//! The serialized listeners of each car.
+	std::vector<std::set<ListenerPtr> > m_listeners;
+	std::mutex m_listenerMutex;
+};
+
+#endif // RACERUNNER_HPP
@@ -44,6 +44,7 @@
 #include <QFontDatabase>
 #include <QIcon>
 #include <QKeyEvent>
+#include <QOffscreenSurface>
 #include <QOpenGLFramebufferObject>
 #include <QScreen>
 
@@ -62,7 +63,10 @@ Renderer::Renderer(int hRes, int vRes, bool fullScreen, MCGLScene & glScene)
 , m_fullVRes(QGuiApplication::primaryScreen()->geometry().height())
 , m_fullScreen(fullScreen)
 , m_updatePending(false)
+, m_offscreen(false)
+, m_offscreenSurface(nullptr)
 , m_glScene(glScene)
+, m_frameCount(0)
 {
     assert(!Renderer::m_instance);
     Renderer::m_instance = this;
@@ -186,11 +190,38 @@ void Renderer::setFadeValue(float value)
 
 void Renderer::setResolution(QSize resolution)
 {
-    m_hRes = resolution.width();
-    m_vRes = resolution.height();
+    if (resolution.width() != m_hRes || resolution.height() != m_vRes)
+    {
+        m_hRes = resolution.width();
+        m_vRes = resolution.height();
+
+        // The FBOs are re-created with the new size on the next frame.
+        m_fbo.reset();
+        m_shadowFbo.reset();
+    }
+}
+
+void Renderer::createFramebufferObjects()
+{
+    m_fbo.reset(new QOpenGLFramebufferObject(m_hRes, m_vRes));
+    m_fbo->setAttachment(QOpenGLFramebufferObject::Depth);
+
+    m_shadowFbo.reset(new QOpenGLFramebufferObject(m_hRes, m_vRes));
+    m_shadowFbo->setAttachment(QOpenGLFramebufferObject::Depth);
+
+    if (!m_shadowSurface)
+    {
+        MCGLMaterialPtr shadowMaterial(new MCGLMaterial);
+        m_shadowSurface.reset(new MCSurface(shadowMaterial, 2.0f, 2.0f));
+        m_shadowSurface->setShaderProgram(program("fbo"));
 
-    m_fbo.reset();
-    m_shadowFbo.reset();
+        MCGLMaterialPtr fboMaterial(new MCGLMaterial);
+        m_fboSurface.reset(new MCSurface(fboMaterial, 2.0f, 2.0f));
+        m_fboSurface->setShaderProgram(program("fbo"));
+    }
+
+    m_shadowSurface->material()->setTexture(m_shadowFbo->texture(), 0);
+    m_fboSurface->material()->setTexture(m_fbo->texture(), 0);
 }
 
 float Renderer::fadeValue() const
@@ -213,19 +244,18 @@ void Renderer::render()
 
     resizeGL(m_hRes, m_vRes);
 
-    if (!m_fbo)
+    if (!m_fbo || !m_shadowFbo)
     {
-        m_fbo.reset(new QOpenGLFramebufferObject(m_hRes, m_vRes));
-        m_fbo->setAttachment(QOpenGLFramebufferObject::Depth);
+        createFramebufferObjects();
     }
 
-    if (!m_shadowFbo)
-    {
-        m_shadowFbo.reset(new QOpenGLFramebufferObject(m_hRes, m_vRes));
-        m_shadowFbo->setAttachment(QOpenGLFramebufferObject::Depth);
-    }
+    // Qt may have changed the GL state since the previous frame.
+    MCGLStateCache & stateCache = m_glScene.stateCache();
+    stateCache.beginFrame();
+    logGLStats();
 
-    static MCGLMaterialPtr dummyMaterial(new MCGLMaterial);
+    // The main pass and the shadow pass draw from the same batches.
+    m_scene->prepareRendering();
 
     m_fbo->bind();
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -240,17 +270,20 @@ void Renderer::render()
     m_shadowFbo->release();
 
     m_fbo->bind();
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    dummyMaterial->setTexture(m_shadowFbo->texture(), 0);
-    MCSurface ss(dummyMaterial, 2.0f, 2.0f);
-    ss.setShaderProgram(program("fbo"));
-    ss.bindMaterial();
-    ss.render(nullptr, MCVector3dF(), 0);
-    glDisable(GL_BLEND);
+    stateCache.setBlendEnabled(true);
+    stateCache.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    m_shadowSurface->bindMaterial();
+    m_shadowSurface->render(nullptr, MCVector3dF(), 0);
+    stateCache.setBlendEnabled(false);
     m_scene->renderCommonHUD();
     m_fbo->release();
 
+    // Offscreen frames are grabbed directly from the FBO.
+    if (m_offscreen)
+    {
+        return;
+    }
+
     if (m_fullScreen)
     {
         resizeGL(m_fullHRes, m_fullVRes);
@@ -260,11 +293,40 @@ void Renderer::render()
         resizeGL(m_hRes, m_vRes);
     }
 
-    dummyMaterial->setTexture(m_fbo->texture(), 0);
-    MCSurface sd(dummyMaterial, 2.0f, 2.0f);
-    sd.setShaderProgram(program("fbo"));
-    sd.bindMaterial();
-    sd.render(nullptr, MCVector3dF(), 0);
+    m_fboSurface->bindMaterial();
+    m_fboSurface->render(nullptr, MCVector3dF(), 0);
+}
+
+void Renderer::logGLStats()
+{
+    const int interval = Settings::instance().getGLStatsInterval();
+    if (interval > 0 && ++m_frameCount % interval == 0)
+    {
+        const MCGLStateCache::Stats & stats = m_glScene.stateCache().lastFrameStats();
+        MCLogger().info() << "GL calls: " << stats.calls
+            << ", skipped: " << stats.skippedCalls
+            << ", draw calls: " << stats.drawCalls
+            << ", buffer uploads: " << stats.bufferUploads
+            << ", VAO binds: " << stats.vertexArrayBinds
+            << ", VBO binds: " << stats.bufferBinds << ".";
+    }
+}
+
+void Renderer::setOffscreen(bool offscreen)
+{
+    assert(!m_context);
+    m_offscreen = offscreen;
+}
+
+QImage Renderer::grabFrame()
+{
+    if (!m_context || !m_fbo)
+    {
+        return QImage();
+    }
+
+    m_context->makeCurrent(m_offscreen ? static_cast<QSurface *>(m_offscreenSurface) : this);
+    return m_fbo->toImage();
 }
 
 void Renderer::renderLater()
@@ -299,7 +361,7 @@ void Renderer::exposeEvent(QExposeEvent *)
 
 void Renderer::renderNow()
 {
-    if (!isExposed())
+    if (!m_offscreen && !isExposed())
     {
         return;
     }
@@ -308,6 +370,14 @@ void Renderer::renderNow()
 
     if (!m_context)
     {
+        if (m_offscreen)
+        {
+            // A pbuffer or a surfaceless context depending on the platform.
+            m_offscreenSurface = new QOffscreenSurface;
+            m_offscreenSurface->setFormat(requestedFormat());
+            m_offscreenSurface->create();
+        }
+
         m_context = new QOpenGLContext(this);
         m_context->setFormat(requestedFormat());
         m_context->create();
@@ -323,7 +393,7 @@ void Renderer::renderNow()
         needsInitialize = true;
     }
 
-    m_context->makeCurrent(this);
+    m_context->makeCurrent(m_offscreen ? static_cast<QSurface *>(m_offscreenSurface) : this);
 
     if (needsInitialize)
     {
@@ -333,7 +403,10 @@ void Renderer::renderNow()
 
     render();
 
-    m_context->swapBuffers(this);
+    if (!m_offscreen)
+    {
+        m_context->swapBuffers(this);
+    }
 }
 
 void Renderer::resizeEvent(QResizeEvent * event)
@@ -395,4 +468,5 @@ void Renderer::setEventHandler(EventHandler & eventHandler)
 
 Renderer::~Renderer()
 {
+    delete m_offscreenSurface;
 }
@@ -21,6 +21,7 @@
 
 #include "eventhandler.hpp"
 
+#include <QImage>
 #include <QWindow>
 #include <QOpenGLFunctions>
 
@@ -29,7 +30,9 @@
 #include <unordered_map>
 
 class InputHandler;
+class MCSurface;
 class QKeyEvent;
+class QOffscreenSurface;
 class QOpenGLFramebufferObject;
 class QPaintEvent;
 class Scene;
@@ -62,6 +65,10 @@ public:
     //! \return shader program object by the given id string.
     MCGLShaderProgramPtr program(const std::string & id);
 
+    /*! Load the application fonts and generate the texture font. Doesn't need
+     *  a GL context if the surface manager is in geometry-only mode. */
+    static void loadFonts();
+
     //! \return scene face factor 0.0..1.0.
     float fadeValue() const;
 
@@ -75,6 +82,13 @@ public:
         return m_fullScreen;
     }
 
+    /*! Render into the FBO only, using an offscreen surface instead of
+     *  the window. Must be set before the first renderNow(). */
+    void setOffscreen(bool offscreen);
+
+    //! \return the last rendered frame.
+    QImage grabFrame();
+
 signals:
 
     void closed();
@@ -127,14 +141,17 @@ private:
     //! Load vertex and fragment shaders.
     void loadShaders();
 
-    void loadFonts();
-
     void createProgramFromSource(std::string handle, std::string vshSource, std::string fshSource);
 
     void render();
 
     void resizeGL(int viewWidth, int viewHeight);
 
+    void createFramebufferObjects();
+
+    //! Log the GL call statistics every n'th frame if enabled in the settings.
+    void logGLStats();
+
     typedef std::unordered_map<std::string, MCGLShaderProgramPtr > ShaderHash;
 
     QOpenGLContext  * m_context;
@@ -163,13 +180,24 @@ private:
 
     bool m_updatePending;
 
+    bool m_offscreen;
+
+    QOffscreenSurface * m_offscreenSurface;
+
     static Renderer * m_instance;
 
     std::unique_ptr<QOpenGLFramebufferObject> m_fbo;
 
     std::unique_ptr<QOpenGLFramebufferObject> m_shadowFbo;
 
+    //! Full-screen quads used to composite the shadow FBO and the final FBO.
+    std::unique_ptr<MCSurface> m_shadowSurface;
+
+    std::unique_ptr<MCSurface> m_fboSurface;
+
     MCGLScene & m_glScene;
+
+    unsigned int m_frameCount;
 };
 
 #endif // RENDERER_HPP
@@ -84,10 +84,10 @@ int Scene::m_height = 768;
 
 static const MCFloat METERS_PER_UNIT = 0.05f;
 
-Scene::Scene(Game & game, StateMachine & stateMachine, Renderer & renderer, MCWorld & world)
+Scene::Scene(Game & game, StateMachine & stateMachine, Renderer * renderer, MCWorld & world)
 : m_game(game)
 , m_stateMachine(stateMachine)
-, m_renderer(&renderer)
+, m_renderer(renderer)
 , m_messageOverlay(new MessageOverlay)
 , m_race(game, NUM_CARS)
 , m_activeTrack(nullptr)
@@ -125,6 +125,9 @@ Scene::Scene(Game & game, StateMachine & stateMachine, Renderer & renderer, MCWo
 	}
     connect(this, SIGNAL(listenerLocationChanged(float, float)), &m_game.audioWorker(), SLOT(setListenerLocation(float, float)));
 
+    // Physics must be identical with and without rendering.
+    m_world.setMetersPerUnit(METERS_PER_UNIT);
+
     if(!Settings::instance().getDisableRendering()) {
 		m_game.audioWorker().connectAudioSource(m_race);
 
@@ -139,8 +142,6 @@ Scene::Scene(Game & game, StateMachine & stateMachine, Renderer & renderer, MCWo
 		m_startlightsOverlay->setDimensions(width(), height());
 		m_messageOverlay->setDimensions(width(), height());
 
-		m_world.setMetersPerUnit(METERS_PER_UNIT);
-
 		m_world.renderer().enableDepthMaskOnLayer(static_cast<int>(Layers::Render::Smoke), false);
 		m_world.renderer().enableDepthMaskOnLayer(static_cast<int>(Layers::Render::Ground), false);
 
@@ -192,8 +193,17 @@ void Scene::createCars()
     m_race.removeCars();
     m_cars.clear();
     m_ai.clear();
+    m_aiUpdater.clear();
 
     Settings& settings = Settings::instance();
+    const std::string ctype = settings.getControllerType().toStdString();
+
+    // The human cars share a single batch controller, if there is one.
+    BatchControllerPtr batchController;
+    if (auto createBatch = AIFactory::instance().batchCreationFunction(ctype))
+    {
+        batchController.reset(createBatch());
+    }
 
     // Create and add cars.
     for (int i = 0; i < NUM_CARS; i++)
@@ -202,8 +212,8 @@ void Scene::createCars()
         if (car)
         {
             if (car->isHuman()) {
-            	const QString& ctype = settings.getControllerType();
-				m_ai.push_back(AIPtr(AIFactory::instance().create(ctype.toStdString(), *car)));
+				m_ai.push_back(AIPtr(AIFactory::create(
+					AIFactory::instance().creationFunction(ctype), batchController, *car)));
             } else {
                 m_ai.push_back(AIPtr(new PIDController(*car, true)));
             }
@@ -248,6 +258,11 @@ void Scene::setSize(int width, int height)
     Scene::m_height = height;
 }
 
+MCFloat Scene::metersPerUnit()
+{
+    return METERS_PER_UNIT;
+}
+
 void Scene::createMenus()
 {
     m_menuManager = new MTFH::MenuManager;
@@ -373,11 +388,7 @@ void Scene::updateCameraLocation(MCCamera & camera, MCFloat & offset, MCObject &
 
 void Scene::updateAi()
 {
-    for (AIPtr ai : m_ai)
-    {
-        const bool isRaceCompleted = m_race.timing().raceCompleted(ai->car().index());
-        ai->update(isRaceCompleted);
-    }
+    m_aiUpdater.update(m_race.timing());
 }
 
 void Scene::setupCameras(Track & activeTrack)
@@ -415,6 +426,8 @@ void Scene::setupAI(Track & activeTrack)
     {
         ai->setTrack(activeTrack);
     }
+
+    m_aiUpdater.setControllers(m_ai);
 }
 
 void Scene::setActiveTrack(Track & activeTrack)
@@ -455,6 +468,13 @@ void Scene::setWorldDimensions()
     const MCUint maxZ = 1000;
 
     m_world.setDimensions(minX, maxX, minY, maxY, minZ, maxZ, METERS_PER_UNIT);
+
+    // Scanning all objects is cheapest on the stock tracks, but on huge
+    // custom tracks only the objects near the cameras are looked at.
+    const unsigned int GRID_CULLING_MIN_OBJECTS = 1000;
+    m_world.renderer().setVisibilityCulling(
+        m_activeTrack->trackData().objects().count() >= GRID_CULLING_MIN_OBJECTS ?
+            MCWorldRenderer::VisibilityCulling::Grid : MCWorldRenderer::VisibilityCulling::LayerScan);
 }
 
 void Scene::addCarsToWorld()
@@ -573,6 +593,11 @@ Track & Scene::activeTrack() const
     return *m_activeTrack;
 }
 
+Race & Scene::race()
+{
+    return m_race;
+}
+
 TrackSelectionMenu & Scene::trackSelectionMenu() const
 {
     assert(m_trackSelectionMenu);
@@ -636,6 +661,29 @@ void Scene::renderTrack()
     };
 }
 
+void Scene::prepareRendering()
+{
+    switch (m_stateMachine.state())
+    {
+    case StateMachine::State::GameTransitionIn:
+    case StateMachine::State::GameTransitionOut:
+    case StateMachine::State::DoStartlights:
+    case StateMachine::State::Play:
+
+        if (m_game.hasTwoHumanPlayers())
+        {
+            m_world.prepareRendering(&m_camera[1]);
+        }
+
+        m_world.prepareRendering(&m_camera[0]);
+
+        break;
+
+    default:
+        break;
+    };
+}
+
 void Scene::renderObjectShadows()
 {
     const MCFloat fadeValue = m_renderer->fadeValue();
@@ -746,13 +794,13 @@ void Scene::renderObjects()
 
 void Scene::renderPlayerScene(MCCamera & camera)
 {
-    // Assume that m_world.prepareRendering(&camera) is already called.
+    // Assume that prepareRendering() is already called.
     m_world.render(&camera);
 }
 
 void Scene::renderPlayerSceneShadows(MCCamera & camera)
 {
-    m_world.prepareRendering(&camera);
+    // Assume that prepareRendering() is already called.
     m_world.renderShadows(&camera);
 }
 
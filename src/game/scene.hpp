@@ -16,6 +16,7 @@
 #ifndef SCENE_HPP
 #define SCENE_HPP
 
+#include "aiupdater.hpp"
 #include "carcontroller.hpp"
 #include "car.hpp"
 #include "crashoverlay.hpp"
@@ -61,7 +62,8 @@ public:
     static const int NUM_CARS = 12;
 
     //! Constructor.
-    Scene(Game & game, StateMachine & stateMachine, Renderer & renderer, MCWorld & world);
+    //! \param renderer The renderer or nullptr when running headless.
+    Scene(Game & game, StateMachine & stateMachine, Renderer * renderer, MCWorld & world);
 
     //! Destructor.
     ~Scene();
@@ -77,6 +79,9 @@ public:
     //! Set scene size.
     static void setSize(int width, int height);
 
+    //! Scale of the physics world.
+    static MCFloat metersPerUnit();
+
     //! Update physics and objects by the given time step.
     void updateFrame(float timeStep);
 
@@ -95,6 +100,13 @@ public:
     //! Return track selection menu.
     TrackSelectionMenu & trackSelectionMenu() const;
 
+    //! Return the race.
+    Race & race();
+
+    /*! Builds the render batches of the frame. Must be called before the
+     *  other render functions, which all draw from the same batches. */
+    void prepareRendering();
+
     void renderTrack();
 
     void renderObjectShadows();
@@ -162,6 +174,7 @@ private:
 
     typedef std::vector<AIPtr> AIVector;
     AIVector m_ai;
+    AIUpdater m_aiUpdater;
 
 	float m_cameraSmoothing;
 
@@ -138,6 +138,45 @@ public:
 		m_resetStuckPlayer = resetStuckPlayer;
 	}
 
+	bool getFastForward() const {
+		return m_fastForward;
+	}
+
+	//! Runs the simulation unthrottled. Implies disabled rendering.
+	void setFastForward(bool fastForward) {
+		m_fastForward = fastForward;
+		if(m_fastForward) setDisableRendering(true);
+	}
+
+	bool getHeadless() const {
+		return m_headless;
+	}
+
+	//! Runs without a renderer, window, sounds or OpenGL context. Implies fast-forward.
+	void setHeadless(bool headless) {
+		m_headless = headless;
+		if(m_headless) setFastForward(true);
+	}
+
+	const QString& getJobFile() const {
+		return m_jobFile;
+	}
+
+	//! Runs the races listed in the given job file instead of a single race. Implies headless.
+	void setJobFile(const QString& jobFile) {
+		m_jobFile = jobFile;
+		if(!m_jobFile.isEmpty()) setHeadless(true);
+	}
+
+	int getThreadCount() const {
+		return m_threadCount;
+	}
+
+	//! Number of races run in parallel; 0 uses one thread per core.
+	void setThreadCount(int threadCount) {
+		m_threadCount = threadCount;
+	}
+
 	float getCameraSmoothing() const {
 		return m_cameraSmoothing;
 	}
@@ -146,6 +185,44 @@ public:
 		m_cameraSmoothing = cameraSmoothing;
 	}
 
+	bool getCapture() const {
+		return !m_capturePath.isEmpty();
+	}
+
+	const QString& getCapturePath() const {
+		return m_capturePath;
+	}
+
+	bool getCaptureRaw() const {
+		return m_captureRaw;
+	}
+
+	//! Renders offscreen with a fixed time step and writes the frames to the given
+	//! directory as PNG images, or to the given file as raw RGBA. Implies disabled menus.
+	void setCapturePath(const QString& capturePath, bool raw) {
+		m_capturePath = capturePath;
+		m_captureRaw = raw;
+		if(!m_capturePath.isEmpty()) setMenusDisabled(true);
+	}
+
+	int getCaptureInterval() const {
+		return m_captureInterval;
+	}
+
+	//! Only every n'th simulated frame is rendered and captured.
+	void setCaptureInterval(int captureInterval) {
+		m_captureInterval = captureInterval;
+	}
+
+	int getGLStatsInterval() const {
+		return m_glStatsInterval;
+	}
+
+	//! Logs the GL call statistics of every n'th rendered frame; 0 disables.
+	void setGLStatsInterval(int glStatsInterval) {
+		m_glStatsInterval = glStatsInterval;
+	}
+
 private:
     QString m_controllerType;
     QString m_customTrackFile;
@@ -161,9 +238,20 @@ private:
 
     bool m_disableRendering = false;
     bool m_resetStuckPlayer = false;
+    bool m_fastForward = false;
+    bool m_headless = false;
+
+    QString m_jobFile;
+    int m_threadCount = 0;
 
     float m_cameraSmoothing = 0.05;
 
+    QString m_capturePath;
+    bool m_captureRaw = false;
+    int m_captureInterval = 1;
+
+    int m_glStatsInterval = 0;
+
     QString combineActionAndPlayer(int player, InputHandler::Action action);
 
     static Settings * m_instance;
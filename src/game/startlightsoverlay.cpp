@@ -18,6 +18,7 @@
 
 #include <MCAssetManager>
 #include <MCGLColor>
+#include <MCGLScene>
 #include <MCSurface>
 
 StartlightsOverlay::StartlightsOverlay(Startlights & model)
@@ -126,7 +127,7 @@ void StartlightsOverlay::setDimensions(int width, int height)
 
 void StartlightsOverlay::render()
 {
-    glDisable(GL_DEPTH_TEST);
+    MCGLScene::instance().stateCache().setDepthTestEnabled(false);
 
     switch (m_model.state())
     {
@@ -19,6 +19,7 @@
 #include "scene.hpp"
 #include "trackdata.hpp"
 #include "tracktile.hpp"
+#include "tracktilebatch.hpp"
 #include "map.hpp"
 
 #include <MCAssetManager>
@@ -27,6 +28,7 @@
 #include <MCSurface>
 
 #include <cassert>
+#include <map>
 
 Track::Track(TrackData * pTrackData)
 : m_pTrackData(pTrackData)
@@ -111,135 +113,91 @@ void Track::calculateVisibleIndices(const MCBBox<int> & r,
     j2 = j2  >= m_rows ? m_rows - 1 : j2;
 }
 
-void Track::render(MCCamera * camera)
-{
-    // Get the Camera window
-    MCBBox<MCFloat> cameraBox(camera->bbox());
-
-    // Calculate which tiles are visible
-    MCUint i2, j2, i0, j0;
-    calculateVisibleIndices(cameraBox, i0, i2, j0, j2);
-
-    MCGLShaderProgramPtr prog2d = Renderer::instance().program("tile2d");
-    prog2d->bind();
-    renderAsphalt(camera, prog2d, i0, i2, j0, j2);
-    prog2d->release();
-
-    MCGLShaderProgramPtr prog3d = Renderer::instance().program("tile3d");
-    prog3d->bind();
-    renderTiles(camera, prog3d, i0, i2, j0, j2);
-    prog3d->release();
-}
-
-void Track::renderAsphalt(
-    MCCamera * camera, MCGLShaderProgramPtr prog, MCUint i0, MCUint i2, MCUint j0, MCUint j2)
+void Track::buildBatches()
 {
     const MapBase & rMap = m_pTrackData->map();
 
     static const int w = TrackTile::TILE_W;
     static const int h = TrackTile::TILE_H;
 
-    MCFloat x1, y1; // Coordinates mapped to camera
+    m_asphaltBatch.reset(new TrackTileBatch(m_asphalt, m_rows));
 
-    // Bind common geometry and textures for all asphalt tiles.
-    m_asphalt.setShaderProgram(prog);
-    m_asphalt.bind();
+    // The tiles are grouped with respect to their surface in order
+    // to minimize GPU context switches.
+    std::map<MCSurface *, TrackTileBatch *> batches;
 
-    // Loop through the visible tile matrix and draw the tiles
-    int initX = i0 * w;
-    int x     = initX;
-    int y     = j0 * h;
-    for (MCUint j = j0; j <= j2; j++)
+    for (MCUint j = 0; j < m_rows; j++)
     {
-        x = initX;
-        for (MCUint i = i0; i <= i2; i++)
+        for (MCUint i = 0; i < m_cols; i++)
         {
-            TrackTile * pTile = static_cast<TrackTile *>(rMap.getTile(i, j).get());
-            if (pTile->hasAsphalt())
+            TrackTile * tile = static_cast<TrackTile *>(rMap.getTile(i, j).get());
+            const MCFloat x = i * w + w / 2;
+            const MCFloat y = j * h + h / 2;
+
+            if (tile->hasAsphalt())
             {
-                x1 = x;
-                y1 = y;
-                camera->mapToCamera(x1, y1);
-                prog->setTransform(0, MCVector3dF(x1 + w / 2, y1 + h / 2, 0));
-                m_asphalt.render();
+                m_asphaltBatch->addTile(j, x, y, 0);
             }
 
-            x += w;
+            if (MCSurface * surface = tile->surface())
+            {
+                TrackTileBatch * & batch = batches[surface];
+                if (!batch)
+                {
+                    batch = new TrackTileBatch(*surface, m_rows);
+                    m_tileBatches.push_back(std::unique_ptr<TrackTileBatch>(batch));
+                }
+
+                batch->addTile(j, x, y, tile->rotation());
+            }
         }
+    }
 
-        y += h;
+    m_asphaltBatch->build();
+
+    for (auto && batch : m_tileBatches)
+    {
+        batch->build();
     }
 }
 
-void Track::renderTiles(
-    MCCamera * camera, MCGLShaderProgramPtr prog, MCUint i0, MCUint i2, MCUint j0, MCUint j2)
+void Track::render(MCCamera * camera)
 {
-    const MapBase & rMap = m_pTrackData->map();
-
-    static const int w = TrackTile::TILE_W;
-    static const int h = TrackTile::TILE_H;
-
-    MCFloat x1, y1; // Coordinates mapped to camera
-
-    struct SortedTile
+    // The tiles are baked on the first render, because there's
+    // no GL context when the track is loaded.
+    if (!m_asphaltBatch)
     {
-        TrackTile * tile;
-        MCFloat x1, y1;
-    };
+        buildBatches();
+    }
 
-    // The tiles are sorted with respect to their surface in order
-    // to minimize GPU context switches.
-    std::map<MCSurface *, std::vector<SortedTile> > sortedTiles;
+    // Get the Camera window
+    MCBBox<MCFloat> cameraBox(camera->bbox());
 
-    // Loop through the visible tile matrix and sort the tiles.
-    int initX = i0 * w;
-    int x     = initX;
-    int y     = j0 * h;
-    for (MCUint j = j0; j <= j2; j++)
-    {
-        x = initX;
-        for (MCUint i = i0; i <= i2; i++)
-        {
-            TrackTile * tile = static_cast<TrackTile *>(rMap.getTile(i, j).get());
-            if (MCSurface * surface = tile->surface())
-            {
-                x1 = x;
-                y1 = y;
-                camera->mapToCamera(x1, y1);
-
-                SortedTile sortedTile;
-                sortedTile.tile = tile;
-                sortedTile.x1 = x1;
-                sortedTile.y1 = y1;
-                sortedTiles[surface].push_back(sortedTile);
-            }
+    // Calculate which tiles are visible
+    MCUint i2, j2, i0, j0;
+    calculateVisibleIndices(cameraBox, i0, i2, j0, j2);
 
-            x += w;
-        }
+    // The batches are in scene coordinates, so the
+    // transform just maps the scene to the camera.
+    MCFloat x = 0, y = 0;
+    camera->mapToCamera(x, y);
 
-        y += h;
-    }
+    MCGLShaderProgramPtr prog2d = Renderer::instance().program("tile2d");
+    prog2d->bind();
+    prog2d->setTransform(0, MCVector3dF(x, y, 0));
+    m_asphaltBatch->setShaderProgram(prog2d);
+    m_asphaltBatch->render(j0, j2);
+    prog2d->release();
 
-    // Render the tiles.
-    auto iter = sortedTiles.begin();
-    while (iter != sortedTiles.end())
+    MCGLShaderProgramPtr prog3d = Renderer::instance().program("tile3d");
+    prog3d->bind();
+    prog3d->setTransform(0, MCVector3dF(x, y, 0));
+    for (auto && batch : m_tileBatches)
     {
-        MCSurface * surface = iter->first;
-        surface->setShaderProgram(prog);
-        surface->bindMaterial();
-
-        for (unsigned int i = 0; i < iter->second.size(); i++)
-        {
-            x1 = iter->second[i].x1;
-            y1 = iter->second[i].y1;
-
-            const TrackTile * tile = iter->second[i].tile;
-            prog->setTransform(tile->rotation(), MCVector3dF(x1 + w / 2, y1 + h / 2, 0));
-            surface->render();
-        }
-
-        iter++;
+        batch->setShaderProgram(prog3d);
+        batch->render(j0, j2);
     }
+    prog3d->release();
 }
 
 void Track::setNext(Track & next)
@@ -22,8 +22,12 @@
 #include <MCGLShaderProgram>
 #include <MCTypes>
 
+#include <memory>
+#include <vector>
+
 class TrackData;
 class TrackTile;
+class TrackTileBatch;
 class MCCamera;
 class MCSurface;
 
@@ -76,17 +80,18 @@ private:
     void calculateVisibleIndices(const MCBBox<int> & r,
         MCUint & i0, MCUint & i2, MCUint & j0, MCUint & j2);
 
-    void renderAsphalt(
-        MCCamera * camera, MCGLShaderProgramPtr prog, MCUint i0, MCUint i2, MCUint j0, MCUint j2);
-
-    void renderTiles(
-        MCCamera * camera, MCGLShaderProgramPtr prog, MCUint i0, MCUint i2, MCUint j0, MCUint j2);
+    //! Bake the tiles into static vertex buffers.
+    void buildBatches();
 
     TrackData * m_pTrackData;
     MCUint      m_rows, m_cols, m_width, m_height;
     MCSurface & m_asphalt;
     Track     * m_next;
     Track     * m_prev;
+
+    std::unique_ptr<TrackTileBatch> m_asphaltBatch;
+
+    std::vector<std::unique_ptr<TrackTileBatch> > m_tileBatches;
 };
 
 #endif // TRACK_HPP
@@ -18,6 +18,7 @@
 #include "layers.hpp"
 #include "pit.hpp"
 #include "renderer.hpp"
+#include "settings.hpp"
 #include "trackobject.hpp"
 #include "treeview.hpp"
 
@@ -30,6 +31,15 @@
 #include <MCShapeView>
 #include <MCSurface>
 
+static void setSpecularShaderProgram(MCObject & object)
+{
+    // There are no shader programs without the renderer.
+    if (!Settings::instance().getDisableRendering())
+    {
+        object.shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+    }
+}
+
 TrackObjectFactory::TrackObjectFactory(MCObjectFactory & objectFactory)
 : m_objectFactory(objectFactory)
 {
@@ -53,7 +63,7 @@ TrackObject * TrackObjectFactory::build(
         data.setRenderLayer(static_cast<int>(Layers::Render::Objects));
 
         object = m_objectFactory.build(data);
-        object->shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+        setSpecularShaderProgram(*object);
 
         // Wrap the MCObject in a TrackObject
         return new TrackObject(category, role, object);
@@ -99,7 +109,7 @@ TrackObject * TrackObjectFactory::build(
         data.setRenderLayer(static_cast<int>(Layers::Render::Objects));
 
         object = m_objectFactory.build(data);
-        object->shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+        setSpecularShaderProgram(*object);
 
         // Wrap the MCObject in a TrackObject
         return new TrackObject(category, role, object);
@@ -194,7 +204,7 @@ TrackObject * TrackObjectFactory::build(
         data.setRenderLayer(static_cast<int>(Layers::Render::Objects));
 
         object = m_objectFactory.build(data);
-        object->shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+        setSpecularShaderProgram(*object);
 
         // Wrap the MCObject in a TrackObject
         return new TrackObject(category, role, object);
@@ -237,7 +247,7 @@ TrackObject * TrackObjectFactory::build(
         data.setInitialLocation(MCVector3dF(location.i(), location.j(), 8));
 
         object = m_objectFactory.build(data);
-        object->shape()->view()->setShaderProgram(Renderer::instance().program("defaultSpecular"));
+        setSpecularShaderProgram(*object);
 
         // Wrap the MCObject in a TrackObject
         return new TrackObject(category, role, object);
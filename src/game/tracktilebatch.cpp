@@ -0,0 +1,102 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+
+#include "tracktilebatch.hpp"
+
+#include <MCGLScene>
+#include <MCTrigonom>
+
+#include <cassert>
+#include <numeric>
+
+TrackTileBatch::TrackTileBatch(MCSurface & surface, MCUint rows)
+    : m_surface(surface)
+    , m_rowBegin(rows + 1, 0)
+{
+    setMaterial(surface.material());
+}
+
+void TrackTileBatch::addTile(MCUint row, MCFloat x, MCFloat y, MCFloat rotation)
+{
+    assert(row + 1 < m_rowBegin.size());
+
+    // Count the tiles per row. build() turns the counts into indices.
+    m_rowBegin[row + 1]++;
+
+    const MCGLVertex * vertices = m_surface.vertices();
+    const MCGLVertex * normals = m_surface.normals();
+    const MCGLTexCoord * texCoords = m_surface.texCoords();
+
+    const MCFloat cosRotation = MCTrigonom::cos(rotation);
+    const MCFloat sinRotation = MCTrigonom::sin(rotation);
+
+    for (int i = 0; i < MCSurface::NUM_VERTICES; i++)
+    {
+        const MCGLVertex & vertex = vertices[i];
+        m_vertices.push_back(MCGLVertex(
+            x + cosRotation * vertex.x() - sinRotation * vertex.y(),
+            y + sinRotation * vertex.x() + cosRotation * vertex.y(),
+            vertex.z()));
+
+        // The tile shaders don't rotate the normals, so neither do we.
+        m_normals.push_back(normals[i]);
+        m_texCoords.push_back(texCoords[i]);
+        m_colors.push_back(MCGLColor());
+    }
+}
+
+void TrackTileBatch::build()
+{
+    std::partial_sum(m_rowBegin.begin(), m_rowBegin.end(), m_rowBegin.begin());
+
+    const int VERTEX_DATA_SIZE = sizeof(MCGLVertex) * m_vertices.size();
+    const int NORMAL_DATA_SIZE = sizeof(MCGLVertex) * m_normals.size();
+    const int TEXCOORD_DATA_SIZE = sizeof(MCGLTexCoord) * m_texCoords.size();
+    const int COLOR_DATA_SIZE = sizeof(MCGLColor) * m_colors.size();
+    const int TOTAL_DATA_SIZE = VERTEX_DATA_SIZE + NORMAL_DATA_SIZE + TEXCOORD_DATA_SIZE + COLOR_DATA_SIZE;
+
+    initBufferData(TOTAL_DATA_SIZE, GL_STATIC_DRAW);
+
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Vertex, VERTEX_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_vertices.data()));
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Normal, NORMAL_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_normals.data()));
+    addBufferSubData(
+        MCGLShaderProgram::VAL_TexCoords, TEXCOORD_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_texCoords.data()));
+    addBufferSubData(
+        MCGLShaderProgram::VAL_Color, COLOR_DATA_SIZE, reinterpret_cast<const GLfloat *>(m_colors.data()));
+
+    finishBufferData();
+
+    // The data lives on the GPU from now on.
+    m_vertices = std::vector<MCGLVertex>();
+    m_normals = std::vector<MCGLVertex>();
+    m_texCoords = std::vector<MCGLTexCoord>();
+    m_colors = std::vector<MCGLColor>();
+}
+
+void TrackTileBatch::render(MCUint j0, MCUint j2)
+{
+    assert(j2 + 1 < m_rowBegin.size());
+
+    const int first = m_rowBegin[j0];
+    const int count = m_rowBegin[j2 + 1] - first;
+    if (count > 0)
+    {
+        bind();
+        glDrawArrays(GL_TRIANGLES, first * MCSurface::NUM_VERTICES, count * MCSurface::NUM_VERTICES);
+        MCGLScene::instance().stateCache().countDrawCall();
+        release();
+    }
+}
@@ -0,0 +1,68 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+
+#ifndef TRACKTILEBATCH_HPP
+#define TRACKTILEBATCH_HPP
+
+#include <MCGLColor>
+#include <MCGLObjectBase>
+#include <MCGLVertex>
+#include <MCSurface>
+#include <MCTypes>
+
+#include <vector>
+
+/*! Static vertex buffer of all tiles of a track that use the same surface.
+ *  The tiles are baked in row order once, so that the visible rows
+ *  can be drawn with a single call. */
+class TrackTileBatch : public MCGLObjectBase
+{
+public:
+
+    /*! Constructor.
+     *  \param surface The surface common for all tiles in the batch.
+     *  \param rows Number of rows in the track. */
+    TrackTileBatch(MCSurface & surface, MCUint rows);
+
+    /*! Add a tile centered at the given location. The tiles must be
+     *  added row by row. */
+    void addTile(MCUint row, MCFloat x, MCFloat y, MCFloat rotation);
+
+    //! Upload the added tiles to the GPU.
+    void build();
+
+    /*! Render the tiles on rows from j0 to j2. The shader program must
+     *  be set and its transform must map the scene to the camera. */
+    void render(MCUint j0, MCUint j2);
+
+private:
+
+    DISABLE_COPY(TrackTileBatch);
+    DISABLE_ASSI(TrackTileBatch);
+
+    MCSurface & m_surface;
+
+    //! Index of the first tile on each row. The last item is the tile count.
+    std::vector<int> m_rowBegin;
+
+    std::vector<MCGLVertex> m_vertices;
+
+    std::vector<MCGLVertex> m_normals;
+
+    std::vector<MCGLTexCoord> m_texCoords;
+
+    std::vector<MCGLColor> m_colors;
+};
+
+#endif // TRACKTILEBATCH_HPP
@@ -0,0 +1,82 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2015 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef WORKSTEALINGQUEUE_HPP
+#define WORKSTEALINGQUEUE_HPP
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+/**
+* A job queue for a fixed set of workers. Every worker has a queue of its
+* own and takes jobs from its front. A worker whose queue has run dry steals
+* from the back of the other queues, so that long jobs don't leave the
+* other workers idle.
+**/
+template<typename T>
+class WorkStealingQueue {
+public:
+	explicit WorkStealingQueue(unsigned int numWorkers):
+		m_queues(numWorkers) {}
+
+	//! Adds a job to the queue of the given worker.
+	void push(unsigned int worker, const T& job) {
+		Queue& queue = m_queues.at(worker);
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(job);
+	}
+
+	//! Takes the next job for the given worker, stealing one if necessary.
+	//! \return false when all queues are empty.
+	bool pop(unsigned int worker, T& job) {
+		{
+			Queue& own = m_queues.at(worker);
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if(!own.jobs.empty()) {
+				job = own.jobs.front();
+				own.jobs.pop_front();
+				return true;
+			}
+		}
+
+		for(unsigned int i = 1; i < m_queues.size(); i++) {
+			Queue& victim = m_queues[(worker + i) % m_queues.size()];
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if(!victim.jobs.empty()) {
+				job = victim.jobs.back();
+				victim.jobs.pop_back();
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	//! The number of workers.
+	unsigned int workers() const {
+		return static_cast<unsigned int>(m_queues.size());
+	}
+
+private:
+	struct Queue {
+		std::mutex mutex;
+		std::deque<T> jobs;
+	};
+
+	std::vector<Queue> m_queues;
+};
+
+#endif // WORKSTEALINGQUEUE_HPP
@@ -0,0 +1,163 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2012 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#include "FuzzyLookupTableTest.hpp"
+#include "fuzzylookuptable.hpp"
+
+#include <fl/Headers.h>
+
+#include <cmath>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::unique_ptr<fl::Engine> loadFis(const std::string& fis)
+{
+	return std::unique_ptr<fl::Engine>(fl::FisImporter().fromString(fis));
+}
+
+static std::unique_ptr<fl::Engine> loadController()
+{
+	std::ifstream file(FIS_FILE);
+	return loadFis(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+}
+
+FuzzyLookupTableTest::FuzzyLookupTableTest()
+{
+}
+
+void FuzzyLookupTableTest::testMatchesFuzzyliteWithinMaxError()
+{
+	std::unique_ptr<fl::Engine> engine = loadController();
+	const float maxError = 0.01f;
+	FuzzyLookupTable table(*engine, 2, 9, maxError);
+
+	QVERIFY(table.numInputs() == 2);
+	QVERIFY(table.numOutputs() == static_cast<unsigned int>(engine->numberOfOutputVariables()));
+	QVERIFY(table.error() <= maxError);
+
+	// Some rule fires everywhere within the ranges of the controller, so
+	// all of the outputs are defined there.
+	std::mt19937 generator(11);
+	std::vector<std::uniform_real_distribution<float> > distributions;
+	for(unsigned int i = 0; i < table.numInputs(); i++) {
+		const fl::InputVariable* input = engine->getInputVariable(i);
+		distributions.push_back(std::uniform_real_distribution<float>(input->getMinimum(), input->getMaximum()));
+	}
+
+	std::vector<float> inputs(table.numInputs());
+	std::vector<float> outputs(table.numOutputs());
+	for(unsigned int p = 0; p < 1000; p++) {
+		for(unsigned int i = 0; i < table.numInputs(); i++) {
+			inputs[i] = distributions[i](generator);
+			engine->getInputVariable(i)->setValue(inputs[i]);
+		}
+
+		engine->process();
+		table.evaluate(inputs.data(), outputs.data());
+
+		for(unsigned int o = 0; o < table.numOutputs(); o++) {
+			const fl::OutputVariable* output = engine->getOutputVariable(o);
+			const float range = output->getMaximum() - output->getMinimum();
+
+			// The error is measured at other random points, so allow
+			// some slack over it.
+			QVERIFY(std::abs(output->getValue() - outputs[o]) <= 2 * maxError * range);
+		}
+	}
+}
+
+void FuzzyLookupTableTest::testClampsResolution()
+{
+	// A trivial controller, as the table is sampled at its full size.
+	std::unique_ptr<fl::Engine> engine = loadFis(
+		"[System]\n"
+		"Name='trivial'\n"
+		"Type='mamdani'\n"
+		"Version=2.0\n"
+		"NumInputs=2\n"
+		"NumOutputs=1\n"
+		"NumRules=1\n"
+		"AndMethod='min'\n"
+		"OrMethod='max'\n"
+		"ImpMethod='min'\n"
+		"AggMethod='max'\n"
+		"DefuzzMethod='centroid'\n"
+		"\n"
+		"[Input1]\n"
+		"Name='a'\n"
+		"Range=[0 1]\n"
+		"NumMFs=1\n"
+		"MF1='any':'trapmf',[-1 0 1 2]\n"
+		"\n"
+		"[Input2]\n"
+		"Name='b'\n"
+		"Range=[0 1]\n"
+		"NumMFs=1\n"
+		"MF1='any':'trapmf',[-1 0 1 2]\n"
+		"\n"
+		"[Output1]\n"
+		"Name='out'\n"
+		"Range=[0 1]\n"
+		"NumMFs=1\n"
+		"MF1='half':'trimf',[0 0.5 1]\n"
+		"\n"
+		"[Rules]\n"
+		"1 1, 1 (1) : 1\n");
+
+	// 5000 x 5000 samples would be far beyond the limit of 2^20.
+	FuzzyLookupTable table(*engine, 2, 5000, 1);
+
+	QVERIFY(table.numInputs() == 2);
+	QVERIFY(table.resolution() * table.resolution() <= (1u << 20));
+	QVERIFY(table.resolution() > 1000);
+}
+
+void FuzzyLookupTableTest::testClampsInputs()
+{
+	std::unique_ptr<fl::Engine> engine = loadController();
+	FuzzyLookupTable table(*engine, 2, 9, 0.01f);
+
+	const fl::InputVariable* error = engine->getInputVariable(0);
+	const fl::InputVariable* deltaError = engine->getInputVariable(1);
+
+	const float edges[][2] = {
+		{static_cast<float>(error->getMinimum()), static_cast<float>(deltaError->getMinimum())},
+		{static_cast<float>(error->getMaximum()), static_cast<float>(deltaError->getMaximum())},
+		{static_cast<float>(error->getMinimum()), 0},
+		{static_cast<float>(error->getMaximum()), 0}
+	};
+
+	std::vector<float> atEdge(table.numOutputs());
+	std::vector<float> beyond(table.numOutputs());
+
+	// Inputs beyond the ranges give the outputs at their edges.
+	for(const auto& edge : edges) {
+		table.evaluate(edge, atEdge.data());
+
+		for(float scale : {1.5f, 10.0f}) {
+			const float inputs[] = {edge[0] * scale, edge[1] * scale};
+			table.evaluate(inputs, beyond.data());
+
+			for(unsigned int o = 0; o < table.numOutputs(); o++) {
+				QCOMPARE(beyond[o], atEdge[o]);
+			}
+		}
+	}
+}
+
+QTEST_MAIN(FuzzyLookupTableTest)
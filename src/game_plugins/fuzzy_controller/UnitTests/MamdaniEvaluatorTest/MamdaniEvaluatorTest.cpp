@@ -0,0 +1,141 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2012 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#include "MamdaniEvaluatorTest.hpp"
+#include "mamdanievaluator.hpp"
+
+#include <fl/Headers.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+static std::string readFis()
+{
+	std::ifstream file(FIS_FILE);
+	return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+//! std::isnan() is folded to false under -ffast-math, so test the bits.
+static bool isNan(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return (bits & 0x7f800000u) == 0x7f800000u && (bits & 0x007fffffu) != 0;
+}
+
+MamdaniEvaluatorTest::MamdaniEvaluatorTest()
+{
+}
+
+void MamdaniEvaluatorTest::testMatchesFuzzyliteOnRandomInputs()
+{
+	const std::string fis = readFis();
+	std::unique_ptr<fl::Engine> engine(fl::FisImporter().fromString(fis));
+	std::istringstream stream(fis);
+	MamdaniEvaluator evaluator(stream);
+
+	QVERIFY(evaluator.numInputs() == static_cast<unsigned int>(engine->numberOfInputVariables()));
+	QVERIFY(evaluator.numOutputs() == static_cast<unsigned int>(engine->numberOfOutputVariables()));
+
+	const unsigned int numInputs = evaluator.numInputs();
+	const unsigned int numOutputs = evaluator.numOutputs();
+	const unsigned int count = 1000;
+
+	// Also cover inputs somewhat outside of the ranges.
+	std::mt19937 generator(7);
+	std::vector<float> inputs(count * numInputs);
+	for(unsigned int i = 0; i < numInputs; i++) {
+		const fl::InputVariable* input = engine->getInputVariable(i);
+		const float margin = (input->getMaximum() - input->getMinimum()) * 0.2f;
+		std::uniform_real_distribution<float> distribution(input->getMinimum() - margin, input->getMaximum() + margin);
+
+		for(unsigned int car = 0; car < count; car++) {
+			inputs[car * numInputs + i] = distribution(generator);
+		}
+	}
+
+	std::vector<float> outputs(count * numOutputs);
+	evaluator.evaluate(inputs.data(), outputs.data(), count);
+
+	for(unsigned int car = 0; car < count; car++) {
+		for(unsigned int i = 0; i < numInputs; i++) {
+			engine->getInputVariable(i)->setValue(inputs[car * numInputs + i]);
+		}
+
+		engine->process();
+
+		for(unsigned int o = 0; o < numOutputs; o++) {
+			const fl::OutputVariable* output = engine->getOutputVariable(o);
+			const float expected = output->getValue();
+			const float actual = outputs[car * numOutputs + o];
+
+			if(isNan(expected)) {
+				QVERIFY(isNan(actual));
+			} else {
+				QVERIFY(!isNan(actual));
+				const float tolerance = (output->getMaximum() - output->getMinimum()) * 1e-4f;
+				QVERIFY(std::abs(expected - actual) <= tolerance);
+			}
+		}
+	}
+}
+
+void MamdaniEvaluatorTest::testPartialBlocks()
+{
+	std::istringstream stream(readFis());
+	MamdaniEvaluator evaluator(stream);
+
+	const unsigned int numInputs = evaluator.numInputs();
+	const unsigned int numOutputs = evaluator.numOutputs();
+	const unsigned int count = MamdaniEvaluator::LANES + 3;
+
+	std::vector<float> inputs(count * numInputs);
+	for(unsigned int i = 0; i < inputs.size(); i++) {
+		inputs[i] = static_cast<float>(i % 7) - 3;
+	}
+
+	std::vector<float> outputs(count * numOutputs);
+	evaluator.evaluate(inputs.data(), outputs.data(), count);
+
+	// A car gets the same outputs however it is blocked with others.
+	for(unsigned int car = 0; car < count; car++) {
+		std::vector<float> single(numOutputs);
+		evaluator.evaluate(&inputs[car * numInputs], single.data(), 1);
+
+		for(unsigned int o = 0; o < numOutputs; o++) {
+			QCOMPARE(single[o], outputs[car * numOutputs + o]);
+		}
+	}
+}
+
+void MamdaniEvaluatorTest::testRejectsUnsupportedFis()
+{
+	std::string fis = readFis();
+	const size_t pos = fis.find("'centroid'");
+	QVERIFY(pos != std::string::npos);
+	fis.replace(pos, 10, "'bisector'");
+
+	std::istringstream stream(fis);
+	QVERIFY_EXCEPTION_THROWN(MamdaniEvaluator evaluator(stream), std::runtime_error);
+}
+
+QTEST_MAIN(MamdaniEvaluatorTest)
@@ -0,0 +1,25 @@
+#include <fiscache.hpp>
+#include <fuzzycontroller.hpp>
+
+#include <QFileInfo>
+
+FisCache& FisCache::instance() {
+	static thread_local FisCache cache;
+	return cache;
+}
+
+EnginePtr FisCache::engine(const std::string& fis_filename) {
+	const QDateTime modified = QFileInfo(QString::fromStdString(fis_filename)).lastModified();
+
+	Entry& entry = m_entries[fis_filename];
+	if(!entry.engine || entry.modified != modified) {
+		entry.engine.reset(FuzzyController::loadFis(fis_filename));
+		entry.modified = modified;
+	}
+
+	return entry.engine;
+}
+
+void FisCache::clear() {
+	m_entries.clear();
+}
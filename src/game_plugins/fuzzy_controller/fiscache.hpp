@@ -0,0 +1,61 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2012 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FISCACHE_HPP
+#define FISCACHE_HPP
+
+#include <fl/Headers.h>
+#include <QDateTime>
+#include <map>
+#include <memory>
+#include <string>
+
+typedef std::shared_ptr<fl::Engine> EnginePtr;
+
+/**
+* Parsed .fis files keyed by path and modification time, so that a file
+* is parsed once no matter how many cars and races use it. A file is
+* only parsed again after it has been modified.
+*
+* Evaluating an engine changes its input and output values, so an
+* engine may only be shared by controllers that are updated one at a
+* time. Each thread therefore gets a cache of its own, like MCWorld.
+**/
+class FisCache {
+public:
+	//! Returns the cache of the calling thread.
+	static FisCache& instance();
+
+	/**
+	* Returns the engine parsed from the given file.
+	* \exception fl::Exception Throws when the engine is not ready.
+	**/
+	EnginePtr engine(const std::string& fis_filename);
+
+	//! Drops all the engines; controllers keep the ones they use.
+	void clear();
+
+private:
+	FisCache() = default;
+
+	struct Entry {
+		QDateTime modified;
+		EnginePtr engine;
+	};
+
+	std::map<std::string, Entry> m_entries;
+};
+
+#endif // FISCACHE_HPP
@@ -0,0 +1,92 @@
+#include <fuzzybatchcontroller.hpp>
+#include <fuzzycontroller.hpp>
+#include <fuzzylookuptable.hpp>
+#include <mamdanievaluator.hpp>
+
+FuzzyBatchController::FuzzyBatchController(const std::string& fis_filename):
+	m_fis(FisCache::instance().engine(fis_filename)) {}
+
+FuzzyBatchController::FuzzyBatchController(const FuzzyLookupTablePtr& table):
+	m_table(table) {}
+
+FuzzyBatchController::FuzzyBatchController(const MamdaniEvaluatorPtr& evaluator):
+	m_native(evaluator) {}
+
+void FuzzyBatchController::control(const std::vector<CarObservation>& observations,
+	std::vector<CarCommand>& commands)
+{
+	if(m_table) {
+		controlTable(observations, commands);
+		return;
+	}
+
+	if(m_native) {
+		controlNative(observations, commands);
+		return;
+	}
+
+	const int numInputs = m_fis->numberOfInputVariables();
+	const bool controlsSpeed = m_fis->numberOfOutputVariables() >= 2;
+
+	fl::InputVariable* error = m_fis->getInputVariable(0);
+	fl::InputVariable* deltaError = numInputs >= 2 ? m_fis->getInputVariable(1) : nullptr;
+	fl::InputVariable* speed = numInputs >= 3 ? m_fis->getInputVariable(2) : nullptr;
+	fl::OutputVariable* steerOutput = m_fis->getOutputVariable(0);
+	fl::OutputVariable* speedOutput = controlsSpeed ? m_fis->getOutputVariable(1) : nullptr;
+
+	for(unsigned int i = 0; i < observations.size(); i++) {
+		const CarObservation& observation = observations[i];
+
+		error->setValue(observation.angularErrors.error);
+		if(deltaError) deltaError->setValue(observation.angularErrors.deltaError);
+		if(speed) speed->setValue(observation.speed);
+
+		m_fis->process();
+
+		commands[i].steer = steerOutput->getValue();
+		commands[i].speed = speedOutput ? speedOutput->getValue() :
+			PIDController::pidSpeedControl(observation);
+	}
+}
+
+void FuzzyBatchController::controlTable(const std::vector<CarObservation>& observations,
+	std::vector<CarCommand>& commands)
+{
+	const bool controlsSpeed = m_table->numOutputs() >= 2;
+	std::vector<float> outputs(m_table->numOutputs());
+
+	for(unsigned int i = 0; i < observations.size(); i++) {
+		const CarObservation& observation = observations[i];
+		const float inputs[] = {observation.angularErrors.error, observation.angularErrors.deltaError, observation.speed};
+
+		m_table->evaluate(inputs, outputs.data());
+
+		commands[i].steer = outputs[0];
+		commands[i].speed = controlsSpeed ? outputs[1] :
+			PIDController::pidSpeedControl(observation);
+	}
+}
+
+void FuzzyBatchController::controlNative(const std::vector<CarObservation>& observations,
+	std::vector<CarCommand>& commands)
+{
+	const unsigned int numInputs = m_native->numInputs();
+	const unsigned int numOutputs = m_native->numOutputs();
+
+	m_inputs.resize(observations.size() * numInputs);
+	m_outputs.resize(observations.size() * numOutputs);
+
+	for(unsigned int i = 0; i < observations.size(); i++) {
+		const CarObservation& observation = observations[i];
+		const float inputs[] = {observation.angularErrors.error, observation.angularErrors.deltaError, observation.speed};
+		std::copy(inputs, inputs + numInputs, &m_inputs[i * numInputs]);
+	}
+
+	m_native->evaluate(m_inputs.data(), m_outputs.data(), observations.size());
+
+	for(unsigned int i = 0; i < observations.size(); i++) {
+		commands[i].steer = m_outputs[i * numOutputs];
+		commands[i].speed = numOutputs >= 2 ? m_outputs[i * numOutputs + 1] :
+			PIDController::pidSpeedControl(observations[i]);
+	}
+}
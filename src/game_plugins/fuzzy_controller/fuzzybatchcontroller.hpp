@@ -0,0 +1,57 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2012 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FUZZYBATCHCONTROLLER_HPP
+#define FUZZYBATCHCONTROLLER_HPP
+
+#include <batchcontroller.hpp>
+#include <fuzzycontroller.hpp>
+#include <fl/Headers.h>
+#include <memory>
+#include <string>
+
+//! Runs all the cars of a race through a single fuzzylite engine, taken
+//! from the FisCache of the thread. The inputs and outputs are the same
+//! as those of FuzzyController.
+class FuzzyBatchController: public BatchController {
+public:
+	FuzzyBatchController(const std::string& fis_filename);
+	//! Serves the controls from a table compiled from the engine instead.
+	FuzzyBatchController(const FuzzyLookupTablePtr& table);
+	//! Evaluates all the cars natively, several at a time.
+	FuzzyBatchController(const MamdaniEvaluatorPtr& evaluator);
+	virtual ~FuzzyBatchController() = default;
+
+	virtual void control(const std::vector<CarObservation>& observations,
+		std::vector<CarCommand>& commands);
+
+private:
+	//! Runs the observations through the compiled table.
+	void controlTable(const std::vector<CarObservation>& observations,
+		std::vector<CarCommand>& commands);
+
+	//! Runs the observations through the native evaluator.
+	void controlNative(const std::vector<CarObservation>& observations,
+		std::vector<CarCommand>& commands);
+
+private:
+	EnginePtr m_fis;
+	FuzzyLookupTablePtr m_table;
+	MamdaniEvaluatorPtr m_native;
+	std::vector<float> m_inputs;
+	std::vector<float> m_outputs;
+};
+
+#endif // FUZZYBATCHCONTROLLER_HPP
@@ -1,14 +1,25 @@
 #include <fuzzycontroller.hpp>
+#include <fuzzylookuptable.hpp>
+#include <mamdanievaluator.hpp>
 #include <car.hpp>
 
 FuzzyController::FuzzyController(Car& car, fl::Engine* engine):
-	PIDController(car, false), m_fis(engine) {}
+	FuzzyController(car, EnginePtr(engine)) {}
+
+FuzzyController::FuzzyController(Car& car, const EnginePtr& engine):
+	PIDController(car, false), m_fis(engine), m_outputs(engine->numberOfOutputVariables()) {}
 
 FuzzyController::FuzzyController(Car& car, const std::string& fis_filename):
-	PIDController(car, false), m_fis(loadFis(fis_filename)) {}
+	FuzzyController(car, FisCache::instance().engine(fis_filename)) {}
 
 FuzzyController::FuzzyController(Car& car, std::istream& fis_file):
-	PIDController(car, false), m_fis(loadFis(fis_file)) {}
+	FuzzyController(car, loadFis(fis_file)) {}
+
+FuzzyController::FuzzyController(Car& car, const FuzzyLookupTablePtr& table):
+	PIDController(car, false), m_fis(nullptr), m_table(table), m_outputs(table->numOutputs()) {}
+
+FuzzyController::FuzzyController(Car& car, const MamdaniEvaluatorPtr& evaluator):
+	PIDController(car, false), m_fis(nullptr), m_native(evaluator), m_outputs(evaluator->numOutputs()) {}
 
 fl::Engine* FuzzyController::loadFis(std::istream& fis_file) {
 	std::string strfis{
@@ -33,6 +44,18 @@ fl::Engine* FuzzyController::loadFis(const std::string& fis_filename) {
 }
 
 float FuzzyController::steerControl(bool) {
+	if(m_table) {
+		const float inputs[] = {m_data.angularErrors.error, m_data.angularErrors.deltaError, float(m_car.speedInKmh())};
+		m_table->evaluate(inputs, m_outputs.data());
+		return m_outputs[0];
+	}
+
+	if(m_native) {
+		const float inputs[] = {m_data.angularErrors.error, m_data.angularErrors.deltaError, float(m_car.speedInKmh())};
+		m_native->evaluate(inputs, m_outputs.data(), 1);
+		return m_outputs[0];
+	}
+
 	// if there is only one input variable, run this as a P controller,
 	// if two, run as a PD
 	if(m_fis->numberOfInputVariables() >= 3) {
@@ -46,16 +69,21 @@ float FuzzyController::steerControl(bool) {
 		m_fis->getInputVariable(0)->setValue(m_data.angularErrors.error);
 	}
 
-	// run the fuzzy controller
+	// run the fuzzy controller; the engine may be used by another car
+	// before speedControl is called, so keep the outputs
 	m_fis->process();
-	return m_fis->getOutputVariable(0)->getValue();
+	for(unsigned int i = 0; i < m_outputs.size(); i++) {
+		m_outputs[i] = m_fis->getOutputVariable(i)->getValue();
+	}
+
+	return m_outputs[0];
 }
 
 float FuzzyController::speedControl(bool isRaceCompleted) {
 	// if the fuzzy controller has two outputs, use the second one for speed
 	// control; otherwise fall back to the standard version
-	if(m_fis->numberOfOutputVariables() >= 2) {
-		return m_fis->getOutputVariable(1)->getValue();
+	if(m_outputs.size() >= 2) {
+		return m_outputs[1];
 	} else {
 		return PIDController::speedControl(isRaceCompleted);
 	}
@@ -17,19 +17,35 @@
 #define FUZZYCONTROLLER_HPP
 
 #include <pidcontroller.hpp>
+#include <fiscache.hpp>
 #include <fl/Headers.h>
 #include <string>
 #include <fstream>
+#include <memory>
+#include <vector>
 
-//! A controller based on fuzzylite.
+class FuzzyLookupTable;
+typedef std::shared_ptr<const FuzzyLookupTable> FuzzyLookupTablePtr;
+class MamdaniEvaluator;
+typedef std::shared_ptr<const MamdaniEvaluator> MamdaniEvaluatorPtr;
+
+//! A controller based on fuzzylite. The engine may be shared by the cars
+//! of a thread: the controller keeps its own outputs between the calls.
 class FuzzyController: public PIDController {
 public:
+	//! Takes ownership of the engine.
 	FuzzyController(Car& car, fl::Engine* engine);
+	FuzzyController(Car& car, const EnginePtr& engine);
+	//! Gets the engine from the FisCache of the calling thread.
 	FuzzyController(Car& car, const std::string& fis_filename);
 	FuzzyController(Car& car, std::istream& fis_file);
+	//! Serves the controls from a table compiled from the engine instead.
+	FuzzyController(Car& car, const FuzzyLookupTablePtr& table);
+	//! Evaluates the controller natively instead of using fuzzylite.
+	FuzzyController(Car& car, const MamdaniEvaluatorPtr& evaluator);
 	virtual ~FuzzyController() = default;
 
-private:
+public:
 	static fl::Engine* loadFis(std::istream& fis_file);
 	static fl::Engine* loadFis(const std::string& fis_filename);
 
@@ -40,7 +56,11 @@ protected:
 	virtual float speedControl(bool isRaceCompleted);
 
 protected:
-    fl::Engine* m_fis;
+    EnginePtr m_fis;
+    FuzzyLookupTablePtr m_table;
+    MamdaniEvaluatorPtr m_native;
+    //! Outputs of the current tick.
+    std::vector<float> m_outputs;
 };
 
 #endif // FUZZYCONTROLLER_HPP
@@ -0,0 +1,202 @@
+#include <fuzzylookuptable.hpp>
+
+#include <MCLogger>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+namespace {
+	//! The largest number of samples a table may grow to.
+	const unsigned int MAX_SAMPLES = 1 << 20;
+	//! Number of random points the error is measured at.
+	const unsigned int ERROR_POINTS = 4096;
+	//! The largest number of inputs that are sampled.
+	const unsigned int MAX_INPUTS = 8;
+
+	//! std::isfinite() is folded to true under -ffast-math, so test the
+	//! exponent bits instead.
+	bool isFinite(float value) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return (bits & 0x7f800000u) != 0x7f800000u;
+	}
+}
+
+FuzzyLookupTable::FuzzyLookupTable(fl::Engine& engine, unsigned int numInputs,
+	unsigned int resolution, float maxError):
+	m_numOutputs(engine.numberOfOutputVariables()),
+	m_resolution(std::max(resolution, 2u)),
+	m_error(0)
+{
+	numInputs = std::min<unsigned int>({numInputs, MAX_INPUTS,
+		static_cast<unsigned int>(engine.numberOfInputVariables())});
+
+	for(unsigned int i = 0; i < numInputs; i++) {
+		m_min.push_back(engine.getInputVariable(i)->getMinimum());
+		m_max.push_back(engine.getInputVariable(i)->getMaximum());
+	}
+
+	for(unsigned int o = 0; o < m_numOutputs; o++) {
+		fl::OutputVariable* output = engine.getOutputVariable(o);
+		m_outputRange.push_back(std::max<float>(output->getMaximum() - output->getMinimum(), 1e-6f));
+	}
+
+	// The initial resolution is user input, so keep it within MAX_SAMPLES too.
+	if(std::pow(static_cast<double>(m_resolution), static_cast<double>(numInputs)) > MAX_SAMPLES) {
+		unsigned int clamped = static_cast<unsigned int>(std::pow(static_cast<double>(MAX_SAMPLES), 1.0 / numInputs));
+		while(clamped > 2 && std::pow(static_cast<double>(clamped), static_cast<double>(numInputs)) > MAX_SAMPLES) {
+			clamped--;
+		}
+
+		MCLogger().warning() << "The fuzzy lookup table resolution " << m_resolution
+			<< " is too large for " << numInputs << " inputs; using " << clamped << ".";
+		m_resolution = clamped;
+	}
+
+	while(true) {
+		sample(engine);
+		m_error = measureError(engine);
+		if(m_error <= maxError) break;
+
+		// Refining to 2r - 1 keeps the current samples.
+		const unsigned int refined = 2 * m_resolution - 1;
+		if(std::pow(static_cast<double>(refined), static_cast<double>(numInputs)) > MAX_SAMPLES) {
+			MCLogger().warning() << "The fuzzy lookup table has an error of " << m_error
+				<< " at resolution " << m_resolution << ", above the requested " << maxError << ".";
+			break;
+		}
+
+		m_resolution = refined;
+	}
+
+	m_defined.clear();
+	m_defined.shrink_to_fit();
+}
+
+void FuzzyLookupTable::sample(fl::Engine& engine) {
+	const unsigned int numInputs = m_min.size();
+
+	m_strides.assign(numInputs, 1);
+	unsigned int numSamples = 1;
+	for(unsigned int i = 0; i < numInputs; i++) {
+		m_strides[i] = numSamples;
+		numSamples *= m_resolution;
+	}
+
+	m_values.resize(numSamples * m_numOutputs);
+	m_defined.resize(numSamples);
+
+	std::vector<float> inputs(numInputs);
+	for(unsigned int s = 0; s < numSamples; s++) {
+		for(unsigned int i = 0; i < numInputs; i++) {
+			const unsigned int k = (s / m_strides[i]) % m_resolution;
+			inputs[i] = m_min[i] + (m_max[i] - m_min[i]) * k / (m_resolution - 1);
+		}
+
+		m_defined[s] = process(engine, inputs.data(), &m_values[s * m_numOutputs]);
+	}
+}
+
+float FuzzyLookupTable::measureError(fl::Engine& engine) const {
+	const unsigned int numInputs = m_min.size();
+
+	std::mt19937 generator(m_resolution);
+	std::vector<std::uniform_real_distribution<float> > distributions;
+	for(unsigned int i = 0; i < numInputs; i++) {
+		distributions.push_back(std::uniform_real_distribution<float>(m_min[i], m_max[i]));
+	}
+
+	std::vector<float> inputs(numInputs);
+	std::vector<float> expected(m_numOutputs);
+	std::vector<float> actual(m_numOutputs);
+	float fraction[MAX_INPUTS];
+	float error = 0;
+
+	for(unsigned int p = 0; p < ERROR_POINTS; p++) {
+		for(unsigned int i = 0; i < numInputs; i++) {
+			inputs[i] = distributions[i](generator);
+		}
+
+		const unsigned int base = cell(inputs.data(), fraction);
+		bool defined = true;
+		for(unsigned int corner = 0; corner < (1u << numInputs) && defined; corner++) {
+			unsigned int sample = base;
+			for(unsigned int i = 0; i < numInputs; i++) {
+				if(corner & (1u << i)) sample += m_strides[i];
+			}
+			defined = m_defined[sample];
+		}
+
+		if(!defined || !process(engine, inputs.data(), expected.data())) continue;
+		evaluate(inputs.data(), actual.data());
+
+		for(unsigned int o = 0; o < m_numOutputs; o++) {
+			error = std::max(error, std::abs(expected[o] - actual[o]) / m_outputRange[o]);
+		}
+	}
+
+	return error;
+}
+
+bool FuzzyLookupTable::process(fl::Engine& engine, const float* inputs, float* outputs) const {
+	for(unsigned int i = 0; i < m_min.size(); i++) {
+		engine.getInputVariable(i)->setValue(inputs[i]);
+	}
+
+	engine.process();
+
+	bool defined = true;
+	for(unsigned int o = 0; o < m_numOutputs; o++) {
+		const float value = engine.getOutputVariable(o)->getValue();
+		defined = defined && isFinite(value);
+		outputs[o] = isFinite(value) ? value : 0;
+	}
+
+	return defined;
+}
+
+unsigned int FuzzyLookupTable::cell(const float* inputs, float* fraction) const {
+	unsigned int base = 0;
+	for(unsigned int i = 0; i < m_min.size(); i++) {
+		const float range = m_max[i] - m_min[i];
+		float x = range > 0 ? (inputs[i] - m_min[i]) / range * (m_resolution - 1) : 0;
+		x = std::min(std::max(x, 0.0f), static_cast<float>(m_resolution - 1));
+
+		const unsigned int k = std::min(static_cast<unsigned int>(x), m_resolution - 2);
+		fraction[i] = x - k;
+		base += k * m_strides[i];
+	}
+
+	return base;
+}
+
+void FuzzyLookupTable::evaluate(const float* inputs, float* outputs) const {
+	const unsigned int numInputs = m_min.size();
+
+	float fraction[MAX_INPUTS];
+	const unsigned int base = cell(inputs, fraction);
+
+	std::fill(outputs, outputs + m_numOutputs, 0.0f);
+
+	// Blend the 2^n corners of the cell.
+	for(unsigned int corner = 0; corner < (1u << numInputs); corner++) {
+		unsigned int sample = base;
+		float weight = 1;
+		for(unsigned int i = 0; i < numInputs; i++) {
+			if(corner & (1u << i)) {
+				sample += m_strides[i];
+				weight *= fraction[i];
+			} else {
+				weight *= 1 - fraction[i];
+			}
+		}
+
+		const float* values = &m_values[sample * m_numOutputs];
+		for(unsigned int o = 0; o < m_numOutputs; o++) {
+			outputs[o] += weight * values[o];
+		}
+	}
+}
@@ -0,0 +1,95 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2012 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef FUZZYLOOKUPTABLE_HPP
+#define FUZZYLOOKUPTABLE_HPP
+
+#include <fl/Headers.h>
+#include <vector>
+
+/**
+* A fuzzy controller compiled into a dense lookup table. The engine is
+* sampled on a regular grid over the ranges of its inputs and the outputs
+* are then interpolated multilinearly, so that evaluation takes constant
+* time regardless of the number of rules.
+*
+* Inputs outside of their ranges are clamped to them. Outputs for which
+* no rule fires (NaN) are stored as 0, which is how the controllers
+* treat them anyway.
+*
+* Note that this differs from fuzzylite, which does not clamp: an input
+* beyond its range, such as an angular error larger than the range of
+* the controller, usually fires no rule there and gives NaN, i.e. no
+* steering, whereas the table gives the output at the edge of the range.
+**/
+class FuzzyLookupTable {
+public:
+	/**
+	* Samples the first numInputs inputs of the engine.
+	* \param resolution Initial number of samples per input; lowered (with
+	* a warning) if the table would be too large.
+	* \param maxError The allowed interpolation error as a fraction of the
+	* output ranges. The resolution is refined until the error measured
+	* between the samples falls below it or the table gets too large.
+	**/
+	FuzzyLookupTable(fl::Engine& engine, unsigned int numInputs,
+		unsigned int resolution, float maxError);
+
+	unsigned int numInputs() const {return m_min.size();}
+	unsigned int numOutputs() const {return m_numOutputs;}
+
+	//! Number of samples per input.
+	unsigned int resolution() const {return m_resolution;}
+
+	//! The largest error measured, as a fraction of the output ranges.
+	float error() const {return m_error;}
+
+	//! Evaluates numInputs() inputs into numOutputs() outputs.
+	void evaluate(const float* inputs, float* outputs) const;
+
+private:
+	void sample(fl::Engine& engine);
+
+	//! Returns the largest relative error against the engine at random
+	//! points between the samples. Cells next to samples for which no
+	//! rule fired are skipped, as the output is discontinuous there.
+	float measureError(fl::Engine& engine) const;
+
+	//! Returns the sample at the lower corner of the cell containing the
+	//! inputs and stores the position within the cell into fraction.
+	unsigned int cell(const float* inputs, float* fraction) const;
+
+	//! Sets the inputs of the engine and returns its outputs;
+	//! returns false if any of them is undefined.
+	bool process(fl::Engine& engine, const float* inputs, float* outputs) const;
+
+private:
+	unsigned int m_numOutputs;
+	unsigned int m_resolution;
+	float m_error;
+
+	std::vector<float> m_min;
+	std::vector<float> m_max;
+	std::vector<float> m_outputRange;
+	//! Offsets of neighbouring samples along each input.
+	std::vector<unsigned int> m_strides;
+	//! numOutputs() values per sample.
+	std::vector<float> m_values;
+	//! Whether all outputs were defined, per sample; only kept while
+	//! the table is being built.
+	std::vector<bool> m_defined;
+};
+
+#endif // FUZZYLOOKUPTABLE_HPP
@@ -1,11 +1,15 @@
 #include <iostream>
+#include <stdexcept>
 #include <aifactory.hpp>
 
 #include <QCommandLineOption>
 #include <QCommandLineParser>
 
 #include "loader.hpp"
+#include "fuzzybatchcontroller.hpp"
 #include "fuzzycontroller.hpp"
+#include "fuzzylookuptable.hpp"
+#include "mamdanievaluator.hpp"
 
 std::shared_ptr<PluginInfo> pluginInfo() {
 	auto info = std::make_shared<PluginInfo>();
@@ -17,15 +21,69 @@ void init(Game&, PluginInfo& info, QStringList& args) {
 	QCommandLineParser parser;
 	QCommandLineOption pathOption(QStringList() << "p" << "controller-path", QCoreApplication::translate("main", "Path to the controller file (if any)."), "file", "controller.fis");
 	parser.addOption(pathOption);
+	QCommandLineOption compileOption(QStringList() << "c" << "compile", QCoreApplication::translate("main", "Compile the controller into a lookup table."));
+	parser.addOption(compileOption);
+	QCommandLineOption resolutionOption(QStringList() << "r" << "resolution", QCoreApplication::translate("main", "Initial number of lookup table samples per input."), "samples", "33");
+	parser.addOption(resolutionOption);
+	QCommandLineOption errorOption(QStringList() << "e" << "max-error", QCoreApplication::translate("main", "Allowed lookup table error as a fraction of the output ranges."), "error", "0.01");
+	parser.addOption(errorOption);
+	QCommandLineOption backendOption(QStringList() << "b" << "backend", QCoreApplication::translate("main", "Fuzzy inference backend: fuzzylite or native (trimf/trapmf, min/max and centroid only)."), "backend", "fuzzylite");
+	parser.addOption(backendOption);
 	parser.parse(args);
 
 	PathResolver resolver(QStringList("") << QString(info.path.c_str()));
 	std::string controllerPath = resolver.resolve(parser.value(pathOption)).toStdString();
 
 	AIFactory& factory = AIFactory::instance();
+
+	if(parser.isSet(compileOption)) {
+		EnginePtr engine(FisCache::instance().engine(controllerPath));
+		FuzzyLookupTablePtr table(new FuzzyLookupTable(*engine, 3,
+			parser.value(resolutionOption).toUInt(), parser.value(errorOption).toFloat()));
+
+		factory.add("fuzzy",
+			[table](Car& car) {
+				return new FuzzyController(car, table);
+			}
+		);
+		factory.addBatch("fuzzy",
+			[table]() {
+				return new FuzzyBatchController(table);
+			}
+		);
+
+		return;
+	}
+
+	const QString backend = parser.value(backendOption);
+	if(backend == "native") {
+		MamdaniEvaluatorPtr evaluator(MamdaniEvaluator::load(controllerPath));
+		if(evaluator->numInputs() > 3) throw std::runtime_error("The native fuzzy backend supports at most 3 inputs.");
+
+		factory.add("fuzzy",
+			[evaluator](Car& car) {
+				return new FuzzyController(car, evaluator);
+			}
+		);
+		factory.addBatch("fuzzy",
+			[evaluator]() {
+				return new FuzzyBatchController(evaluator);
+			}
+		);
+
+		return;
+	} else if(backend != "fuzzylite") {
+		throw std::runtime_error("Unknown fuzzy backend '" + backend.toStdString() + "'.");
+	}
+
 	factory.add("fuzzy",
 		[controllerPath](Car& car) {
 			return new FuzzyController(car, controllerPath);
 		}
 	);
+	factory.addBatch("fuzzy",
+		[controllerPath]() {
+			return new FuzzyBatchController(controllerPath);
+		}
+	);
 }
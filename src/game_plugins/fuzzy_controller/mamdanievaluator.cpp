@@ -0,0 +1,352 @@
+#include <mamdanievaluator.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+	std::string trim(const std::string& str) {
+		const size_t begin = str.find_first_not_of(" \t\r\n");
+		if(begin == std::string::npos) return "";
+		const size_t end = str.find_last_not_of(" \t\r\n");
+		return str.substr(begin, end - begin + 1);
+	}
+
+	std::string unquote(const std::string& str) {
+		std::string result = trim(str);
+		if(result.size() >= 2 && result.front() == '\'' && result.back() == '\'') {
+			result = result.substr(1, result.size() - 2);
+		}
+		return result;
+	}
+
+	//! Reads the numbers of "[a b c]" or "a b c".
+	std::vector<float> numbers(const std::string& str) {
+		std::string list = str;
+		std::replace(list.begin(), list.end(), '[', ' ');
+		std::replace(list.begin(), list.end(), ']', ' ');
+
+		std::istringstream stream(list);
+		std::vector<float> result;
+		float value;
+		while(stream >> value) result.push_back(value);
+		return result;
+	}
+
+	// By value and without branches, unlike std::min and std::max, so that
+	// the loops over lanes vectorize.
+	inline float minimum(float a, float b) {
+		return b < a ? b : a;
+	}
+
+	inline float maximum(float a, float b) {
+		return a < b ? b : a;
+	}
+
+	void require(bool condition, const std::string& what) {
+		if(!condition) throw std::runtime_error("Unsupported .fis file: " + what + ".");
+	}
+}
+
+const unsigned int MamdaniEvaluator::LANES;
+
+MamdaniEvaluator::MamdaniEvaluator(std::istream& fis_file, unsigned int resolution):
+	m_numInputTerms(0), m_numOutputTerms(0), m_resolution(std::max(resolution, 1u))
+{
+	parse(fis_file);
+	precomputeOutputs(m_resolution);
+}
+
+std::shared_ptr<const MamdaniEvaluator> MamdaniEvaluator::load(const std::string& fis_filename,
+	unsigned int resolution)
+{
+	std::ifstream file(fis_filename);
+	if(!file) throw std::runtime_error("Couldn't open '" + fis_filename + "'.");
+	return std::make_shared<MamdaniEvaluator>(file, resolution);
+}
+
+void MamdaniEvaluator::parse(std::istream& fis_file) {
+	std::string section;
+	std::vector<Variable>* variables = nullptr;
+	std::vector<std::string> rules;
+
+	std::string line;
+	while(std::getline(fis_file, line)) {
+		line = trim(line);
+		if(line.empty() || line[0] == '%' || line[0] == '#') continue;
+
+		if(line[0] == '[') {
+			section = line.substr(1, line.find(']') - 1);
+			variables = nullptr;
+
+			if(section.compare(0, 5, "Input") == 0) variables = &m_inputs;
+			else if(section.compare(0, 6, "Output") == 0) variables = &m_outputs;
+			if(variables) variables->push_back(Variable());
+
+			continue;
+		}
+
+		if(section == "Rules") {
+			rules.push_back(line);
+			continue;
+		}
+
+		const size_t eq = line.find('=');
+		if(eq == std::string::npos) continue;
+		const std::string key = trim(line.substr(0, eq));
+		const std::string value = trim(line.substr(eq + 1));
+
+		if(section == "System") {
+			if(key == "Type") require(unquote(value) == "mamdani", "only mamdani systems are supported");
+			else if(key == "AndMethod") require(unquote(value) == "min", "AndMethod must be min");
+			else if(key == "OrMethod") require(unquote(value) == "max", "OrMethod must be max");
+			else if(key == "ImpMethod") require(unquote(value) == "min", "ImpMethod must be min");
+			else if(key == "AggMethod") require(unquote(value) == "max", "AggMethod must be max");
+			else if(key == "DefuzzMethod") require(unquote(value) == "centroid", "DefuzzMethod must be centroid");
+		} else if(variables) {
+			Variable& variable = variables->back();
+
+			if(key == "Range") {
+				const std::vector<float> range = numbers(value);
+				require(range.size() == 2, "malformed Range");
+				variable.min = range[0];
+				variable.max = range[1];
+			} else if(key.compare(0, 2, "MF") == 0) {
+				// 'name':'type',[params]
+				const size_t bracket = value.find('[');
+				require(bracket != std::string::npos, "malformed " + key);
+
+				std::string head = trim(value.substr(0, bracket));
+				if(!head.empty() && head.back() == ',') head.pop_back();
+				const std::string type = unquote(head.substr(head.rfind(':') + 1));
+				const std::vector<float> params = numbers(value.substr(bracket));
+
+				Term term;
+				if(type == "trimf") {
+					require(params.size() == 3, "trimf takes 3 parameters");
+					term = {params[0], params[1], params[1], params[2]};
+				} else if(type == "trapmf") {
+					require(params.size() == 4, "trapmf takes 4 parameters");
+					term = {params[0], params[1], params[2], params[3]};
+				} else {
+					require(false, "only trimf and trapmf terms are supported, not " + type);
+				}
+
+				variable.terms.push_back(term);
+			}
+		}
+	}
+
+	require(!m_inputs.empty() && !m_outputs.empty(), "there must be inputs and outputs");
+
+	for(Variable& input: m_inputs) {
+		input.offset = m_numInputTerms;
+		m_numInputTerms += input.terms.size();
+	}
+
+	for(Variable& output: m_outputs) {
+		output.offset = m_numOutputTerms;
+		m_numOutputTerms += output.terms.size();
+	}
+
+	// e.g. "1 2, 5 0 (1) : 1"
+	for(const std::string& line: rules) {
+		const size_t comma = line.find(',');
+		const size_t paren = line.find('(');
+		const size_t colon = line.find(':');
+		require(comma != std::string::npos && paren != std::string::npos &&
+			colon != std::string::npos, "malformed rule '" + line + "'");
+
+		const std::vector<float> antecedents = numbers(line.substr(0, comma));
+		const std::vector<float> consequents = numbers(line.substr(comma + 1, paren - comma - 1));
+		const std::vector<float> weight = numbers(line.substr(paren + 1, line.find(')') - paren - 1));
+		const std::vector<float> connective = numbers(line.substr(colon + 1));
+
+		require(antecedents.size() == m_inputs.size() && consequents.size() == m_outputs.size() &&
+			weight.size() == 1 && connective.size() == 1, "malformed rule '" + line + "'");
+
+		Rule rule;
+		rule.weight = weight[0];
+		rule.isOr = connective[0] == 2;
+
+		for(unsigned int i = 0; i < antecedents.size(); i++) {
+			const int term = static_cast<int>(antecedents[i]);
+			require(term >= 0, "negated terms are not supported");
+			require(term <= static_cast<int>(m_inputs[i].terms.size()), "rule term out of range");
+			rule.antecedents.push_back(term - 1);
+		}
+
+		for(unsigned int o = 0; o < consequents.size(); o++) {
+			const int term = static_cast<int>(consequents[o]);
+			require(term >= 0, "negated terms are not supported");
+			require(term <= static_cast<int>(m_outputs[o].terms.size()), "rule term out of range");
+			rule.consequents.push_back(term - 1);
+		}
+
+		m_rules.push_back(rule);
+	}
+
+	m_termRules.resize(m_numOutputTerms);
+	for(unsigned int r = 0; r < m_rules.size(); r++) {
+		for(unsigned int o = 0; o < m_outputs.size(); o++) {
+			if(m_rules[r].consequents[o] >= 0) {
+				m_termRules[m_outputs[o].offset + m_rules[r].consequents[o]].push_back(r);
+			}
+		}
+	}
+}
+
+void MamdaniEvaluator::precomputeOutputs(unsigned int resolution) {
+	m_samples.resize(m_outputs.size() * resolution);
+	m_sampleMemberships.resize(m_numOutputTerms * resolution);
+
+	// Sampled at the middles of resolution equal intervals, like fuzzylite.
+	for(unsigned int o = 0; o < m_outputs.size(); o++) {
+		const Variable& output = m_outputs[o];
+		const double dx = (static_cast<double>(output.max) - output.min) / resolution;
+
+		for(unsigned int k = 0; k < resolution; k++) {
+			const float x = output.min + (k + 0.5) * dx;
+			m_samples[o * resolution + k] = x;
+
+			for(unsigned int t = 0; t < output.terms.size(); t++) {
+				m_sampleMemberships[(output.offset + t) * resolution + k] = membership(output.terms[t], x);
+			}
+		}
+	}
+}
+
+float MamdaniEvaluator::membership(const Term& term, float x) {
+	if(x < term.a || x > term.d) return 0;
+	if(x < term.b) return (x - term.a) / (term.b - term.a);
+	if(x <= term.c) return 1;
+	if(x < term.d) return (term.d - x) / (term.d - term.c);
+	return 0;
+}
+
+void MamdaniEvaluator::evaluate(const float* inputs, float* outputs, unsigned int count) const {
+	static thread_local std::vector<float> scratch;
+	scratch.resize((m_numInputTerms + m_rules.size() + m_numOutputTerms) * LANES);
+
+	for(unsigned int start = 0; start < count; start += LANES) {
+		evaluateBlock(inputs + start * m_inputs.size(), outputs + start * m_outputs.size(),
+			std::min(LANES, count - start), scratch.data());
+	}
+}
+
+void MamdaniEvaluator::evaluateBlock(const float* inputs, float* outputs, unsigned int count, float* scratch) const {
+	// Each step accumulates into arrays local to the loop, which the
+	// compiler knows not to alias the scratch memory, and stores them after.
+	const unsigned int numInputs = m_inputs.size();
+	const unsigned int numOutputs = m_outputs.size();
+
+	float* memberships = scratch;
+	float* activations = memberships + m_numInputTerms * LANES;
+	float* degrees = activations + m_rules.size() * LANES;
+
+	// Fuzzify. A ramp that is a step (a == b or c == d) gets a zero slope
+	// and a unit step instead, which gives the same degrees as membership().
+	for(unsigned int i = 0; i < numInputs; i++) {
+		float x[LANES] = {0};
+		for(unsigned int lane = 0; lane < count; lane++) {
+			x[lane] = inputs[lane * numInputs + i];
+		}
+
+		for(unsigned int t = 0; t < m_inputs[i].terms.size(); t++) {
+			const Term& term = m_inputs[i].terms[t];
+			const float a = term.a;
+			const float d = term.d;
+			const float leftStep = term.b > term.a ? 0 : 1;
+			const float rightStep = term.d > term.c ? 0 : 1;
+			const float leftSlope = leftStep ? 0 : 1 / (term.b - term.a);
+			const float rightSlope = rightStep ? 0 : 1 / (term.d - term.c);
+
+			float degree[LANES];
+			for(unsigned int lane = 0; lane < LANES; lane++) {
+				const float left = (x[lane] - a) * leftSlope + (x[lane] >= a ? leftStep : 0.0f);
+				const float right = (d - x[lane]) * rightSlope + (x[lane] <= d ? rightStep : 0.0f);
+				degree[lane] = maximum(0.0f, minimum(1.0f, minimum(left, right)));
+			}
+
+			std::copy(degree, degree + LANES, memberships + (m_inputs[i].offset + t) * LANES);
+		}
+	}
+
+	// Activate the rules.
+	for(unsigned int r = 0; r < m_rules.size(); r++) {
+		const Rule& rule = m_rules[r];
+
+		float activation[LANES];
+		std::fill(activation, activation + LANES, rule.isOr ? 0.0f : 1.0f);
+
+		for(unsigned int i = 0; i < numInputs; i++) {
+			if(rule.antecedents[i] < 0) continue;
+
+			const float* degree = memberships + (m_inputs[i].offset + rule.antecedents[i]) * LANES;
+			if(rule.isOr) {
+				for(unsigned int lane = 0; lane < LANES; lane++) {
+					activation[lane] = maximum(activation[lane], degree[lane]);
+				}
+			} else {
+				for(unsigned int lane = 0; lane < LANES; lane++) {
+					activation[lane] = minimum(activation[lane], degree[lane]);
+				}
+			}
+		}
+
+		const float weight = rule.weight;
+		for(unsigned int lane = 0; lane < LANES; lane++) {
+			activation[lane] *= weight;
+		}
+
+		std::copy(activation, activation + LANES, activations + r * LANES);
+	}
+
+	// Aggregate the activations per output term.
+	for(unsigned int t = 0; t < m_numOutputTerms; t++) {
+		float degree[LANES] = {0};
+
+		for(unsigned int r: m_termRules[t]) {
+			const float* activation = activations + r * LANES;
+			for(unsigned int lane = 0; lane < LANES; lane++) {
+				degree[lane] = maximum(degree[lane], activation[lane]);
+			}
+		}
+
+		std::copy(degree, degree + LANES, degrees + t * LANES);
+	}
+
+	// Defuzzify with the centroid of the clipped terms.
+	for(unsigned int o = 0; o < numOutputs; o++) {
+		const Variable& output = m_outputs[o];
+		float numerator[LANES] = {0};
+		float area[LANES] = {0};
+
+		for(unsigned int k = 0; k < m_resolution; k++) {
+			const float x = m_samples[o * m_resolution + k];
+			float y[LANES] = {0};
+
+			for(unsigned int t = 0; t < output.terms.size(); t++) {
+				const float sample = m_sampleMemberships[(output.offset + t) * m_resolution + k];
+				const float* degree = degrees + (output.offset + t) * LANES;
+
+				for(unsigned int lane = 0; lane < LANES; lane++) {
+					y[lane] = maximum(y[lane], minimum(degree[lane], sample));
+				}
+			}
+
+			for(unsigned int lane = 0; lane < LANES; lane++) {
+				numerator[lane] += y[lane] * x;
+				area[lane] += y[lane];
+			}
+		}
+
+		for(unsigned int lane = 0; lane < count; lane++) {
+			outputs[lane * numOutputs + o] = area[lane] > 0 ?
+				numerator[lane] / area[lane] : std::numeric_limits<float>::quiet_NaN();
+		}
+	}
+}
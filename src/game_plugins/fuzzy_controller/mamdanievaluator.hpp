@@ -0,0 +1,112 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2012 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef MAMDANIEVALUATOR_HPP
+#define MAMDANIEVALUATOR_HPP
+
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+* A native evaluator for the subset of Mamdani systems that our .fis files
+* use: trimf and trapmf terms, min for AND and implication, max for OR and
+* aggregation, and centroid defuzzification over a fixed number of samples
+* of the output range. fuzzylite remains the reference implementation.
+*
+* Cars are evaluated in blocks of LANES. Every step loops over the lanes
+* of a block without branching, so that the compiler can vectorize it
+* across cars. The evaluator holds no per-car state and may be shared
+* by any number of threads.
+**/
+class MamdaniEvaluator {
+public:
+	//! The number of cars evaluated together.
+	static const unsigned int LANES = 8;
+
+	/**
+	* Reads a system from a .fis file.
+	* \param resolution The number of samples of the output ranges used for
+	* defuzzification; fuzzylite uses 100.
+	* \exception std::runtime_error Throws when the file is malformed or
+	* uses anything outside of the supported subset.
+	**/
+	MamdaniEvaluator(std::istream& fis_file, unsigned int resolution = 100);
+
+	static std::shared_ptr<const MamdaniEvaluator> load(const std::string& fis_filename,
+		unsigned int resolution = 100);
+
+	unsigned int numInputs() const {return m_inputs.size();}
+	unsigned int numOutputs() const {return m_outputs.size();}
+
+	/**
+	* Evaluates count cars. The inputs hold numInputs() values per car and
+	* the outputs receive numOutputs() values per car. Outputs for which
+	* no rule fires are NaN, as in fuzzylite.
+	**/
+	void evaluate(const float* inputs, float* outputs, unsigned int count) const;
+
+private:
+	//! A trimf is stored as a trapezoid with b == c.
+	struct Term {
+		float a, b, c, d;
+	};
+
+	struct Variable {
+		float min, max;
+		std::vector<Term> terms;
+		//! Index of the first term among the terms of all the inputs,
+		//! or all the outputs.
+		unsigned int offset;
+	};
+
+	struct Rule {
+		//! Term per input, -1 if the input doesn't matter.
+		std::vector<int> antecedents;
+		//! Term per output, -1 if the output isn't affected.
+		std::vector<int> consequents;
+		float weight;
+		bool isOr;
+	};
+
+	void parse(std::istream& fis_file);
+	void precomputeOutputs(unsigned int resolution);
+
+	static float membership(const Term& term, float x);
+
+	//! Evaluates a block of up to LANES cars.
+	void evaluateBlock(const float* inputs, float* outputs, unsigned int count, float* scratch) const;
+
+private:
+	std::vector<Variable> m_inputs;
+	std::vector<Variable> m_outputs;
+	std::vector<Rule> m_rules;
+	//! The rules that conclude each output term.
+	std::vector<std::vector<unsigned int> > m_termRules;
+	unsigned int m_numInputTerms;
+	unsigned int m_numOutputTerms;
+	unsigned int m_resolution;
+
+	//! The output samples, resolution per output.
+	std::vector<float> m_samples;
+	//! Membership of every output sample in every term of its output,
+	//! resolution per output term.
+	std::vector<float> m_sampleMemberships;
+};
+
+typedef std::shared_ptr<const MamdaniEvaluator> MamdaniEvaluatorPtr;
+
+#endif // MAMDANIEVALUATOR_HPP
@@ -9,4 +9,33 @@ class PIDData:
         self.angularErrors = angularErrors
         self.distanceErrors = distanceErrors
         self.steerControl = steerControl
-        self.speedControl = speedControl
\ No newline at end of file
+        self.speedControl = speedControl
+
+
+# Columns of the observation rows passed to the control method of batch
+# controllers; mirrors PyObservationBuffer::ObservationField.
+ANGULAR_ERROR = 0
+ANGULAR_DELTA_ERROR = 1
+ANGULAR_DELTA_ERROR2 = 2
+DISTANCE_ERROR = 3
+DISTANCE_DELTA_ERROR = 4
+DISTANCE_DELTA_ERROR2 = 5
+STEER_CONTROL = 6
+SPEED_CONTROL = 7
+SPEED = 8
+COMPUTER_HINT = 9
+TILE_TYPE = 10
+RACE_COMPLETED = 11
+
+# Columns of the command rows; mirrors PyObservationBuffer::CommandField.
+STEER = 0
+SPEED_COMMAND = 1
+
+def asArray(view):
+    """Wraps an observation or command view in a NumPy array without
+    copying, or returns the view itself when NumPy is not available."""
+    try:
+        import numpy
+    except ImportError:
+        return view
+    return numpy.asarray(view)
@@ -17,3 +17,25 @@ class Controller:
 #
 #    def __del__(self):
 #        None
+
+#class BatchController:
+#    def __init__(self):
+#        None
+#
+#    def steerControl(self, data):
+#        return [-(d.angularErrors.error * 0.025 + d.angularErrors.deltaError * 0.025) for d in data]
+#
+#    def speedControl(self, data):
+#        return [60 for d in data]
+
+#import bindings
+#
+#class BufferController:
+#    def __init__(self):
+#        None
+#
+#    def control(self, observations, commands):
+#        obs = bindings.asArray(observations)
+#        cmd = bindings.asArray(commands)
+#        cmd[:, bindings.STEER] = -(obs[:, bindings.ANGULAR_ERROR] * 0.025 +
+#            obs[:, bindings.ANGULAR_DELTA_ERROR] * 0.025)
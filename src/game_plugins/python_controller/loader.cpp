@@ -8,10 +8,16 @@
 #include <QCommandLineParser>
 
 #include "loader.hpp"
+#include "pythonbatchcontroller.hpp"
 #include "pythoncontroller.hpp"
+#include "pygilguard.hpp"
 #include "pylistener.hpp"
 #include "pythonexception.hpp"
 
+//! The state of the thread that initialized Python, saved while the GIL
+//! is released.
+static PyThreadState* mainThreadState = nullptr;
+
 std::shared_ptr<PluginInfo> pluginInfo() {
 	auto info = std::make_shared<PluginInfo>();
 	info->name = "PythonController";
@@ -24,6 +30,8 @@ void init(Game&, const PluginInfo& info, const QStringList& args) {
 	parser.addOption(pathOption);
 	QCommandLineOption methodOption(QStringList() << "m" << "method", QCoreApplication::translate("main", "Name of the method used to create the controller object."), "file", "Controller");
 	parser.addOption(methodOption);
+	QCommandLineOption batchMethodOption(QStringList() << "b" << "batch-method", QCoreApplication::translate("main", "Name of the method used to create the batch controller object, which controls all the cars in a single call (if any)."), "file", "");
+	parser.addOption(batchMethodOption);
 	QCommandLineOption listenerOption(QStringList() << "l" << "listener", QCoreApplication::translate("main", "Name of the method used to create the listener."), "file");
 	parser.addOption(listenerOption);
 	QCommandLineOption listenerPathOption(QStringList() << "t" << "listener-path", QCoreApplication::translate("main", "Path to the listener file (if any). If not specified, falls back to looking for the listener in the controller file."), "file", "");
@@ -32,13 +40,25 @@ void init(Game&, const PluginInfo& info, const QStringList& args) {
 
 	std::string controllerPath = parser.value(pathOption).toStdString();
 	std::string method = parser.value(methodOption).toStdString();
+	std::string batchMethod = parser.value(batchMethodOption).toStdString();
 	std::string listener = parser.value(listenerOption).toStdString();
 	std::string listenerPath = parser.value(listenerPathOption).toStdString();
 
-    // Initialize the Python Interpreter
-    Py_Initialize();
-	// Pass in the CLI arguments
-	PySys_SetArgvEx(0, 0, 0);
+	if(!Py_IsInitialized()) {
+		// Initialize the Python Interpreter
+		Py_Initialize();
+#if PY_VERSION_HEX < 0x03070000
+		PyEval_InitThreads();
+#endif
+		// Pass in the CLI arguments
+		PySys_SetArgvEx(0, 0, 0);
+
+		// Let go of the GIL, so that controllers can run in other threads;
+		// every entry point takes it with a PyGILGuard.
+		mainThreadState = PyEval_SaveThread();
+	}
+
+	PyGILGuard gil;
 
 	PyObject* sys = PyImport_ImportModule("sys");
 	PyObject* sys_path = PyObject_GetAttrString(sys, "path");
@@ -68,6 +88,18 @@ void init(Game&, const PluginInfo& info, const QStringList& args) {
 		}
 	);
 
+	if(batchMethod.size()) {
+		// borrowed reference
+		PyObject* batchFunc = PyDict_GetItemString(pModuleDict, batchMethod.c_str());
+		if(!batchFunc) throw PythonException("Function '" + batchMethod + "' not found in the Python module.");
+
+		factory.addBatch("python",
+			[batchFunc, dataMaker]() {
+				return new PythonBatchController(batchFunc, dataMaker);
+			}
+		);
+	}
+
 	if(listener.size()) {
 		PyObject* listenerDict = pModuleDict;
 
@@ -98,6 +130,7 @@ void init(Game&, const PluginInfo& info, const QStringList& args) {
 struct PyFinalizer {
 	// Finish the Python Interpreter when this lib is unloaded.
 	~PyFinalizer() {
+		if(mainThreadState) PyEval_RestoreThread(mainThreadState);
 		Py_Finalize();
 	}
 } pyFinalizer;
@@ -1,10 +1,14 @@
 #include "pydata.hpp"
 #include "pythonexception.hpp"
+#include "pygilguard.hpp"
 
+#include <batchcontroller.hpp>
 #include <piddata.hpp>
 
 PyDataMaker::PyDataMaker(PyObject* bindingsModule)
 {
+	PyGILGuard gil;
+
 	// pModuleDict is a borrowed reference
 	if(!bindingsModule) throw std::runtime_error("NULL pointer to bindings module.");
 	PyObject* pDict = PyModule_GetDict(bindingsModule);
@@ -21,6 +25,10 @@ PyDataMaker::PyDataMaker(PyObject* bindingsModule)
 }
 
 PyDataMaker::~PyDataMaker() {
+	// Held by process-wide registries, so this may run after Py_Finalize.
+	if(!Py_IsInitialized()) return;
+	PyGILGuard gil;
+
 	Py_DECREF(m_dataMethod);
 	Py_DECREF(m_diffMethod);
 }
@@ -31,10 +39,18 @@ PyObject* PyDataMaker::makeData(const DiffStore& diffData)
 }
 
 PyObject* PyDataMaker::makeData(const PIDData& pidData) {
-	PyObject* angularErrors = makeData(pidData.angularErrors);
-	PyObject* distanceErrors = makeData(pidData.distanceErrors);
-	PyObject* steerControl = PyFloat_FromDouble(pidData.steerControl);
-	PyObject* speedControl = PyFloat_FromDouble(pidData.speedControl);
+	return makeData(pidData.angularErrors, pidData.distanceErrors, pidData.steerControl, pidData.speedControl);
+}
+
+PyObject* PyDataMaker::makeData(const CarObservation& observation) {
+	return makeData(observation.angularErrors, observation.distanceErrors, observation.steerControl, observation.speedControl);
+}
+
+PyObject* PyDataMaker::makeData(const DiffStore& angularData, const DiffStore& distanceData, float steerControlValue, float speedControlValue) {
+	PyObject* angularErrors = makeData(angularData);
+	PyObject* distanceErrors = makeData(distanceData);
+	PyObject* steerControl = PyFloat_FromDouble(steerControlValue);
+	PyObject* speedControl = PyFloat_FromDouble(speedControlValue);
 
 	PyObject* data = PyObject_CallFunctionObjArgs(m_dataMethod, angularErrors, distanceErrors, steerControl, speedControl, NULL);
 
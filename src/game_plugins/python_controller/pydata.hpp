@@ -21,6 +21,7 @@
 
 class PIDData;
 class DiffStore;
+struct CarObservation;
 
 class PyDataMaker {
 public:
@@ -31,8 +32,13 @@ public:
 	//! Turns PIDData into a Python object. Remeber to decref the
 	//! object using Py_DECREF when you are done with it.
 	PyObject* makeData(const PIDData& pidData);
+	//! Turns the PIDData part of the observation into a Python PIDData.
+	PyObject* makeData(const CarObservation& observation);
 	PyObject* makeData(const DiffStore& diffData);
 
+private:
+	PyObject* makeData(const DiffStore& angularData, const DiffStore& distanceData, float steerControl, float speedControl);
+
 private:
 	PyObject* m_dataMethod = nullptr;
 	PyObject* m_diffMethod = nullptr;
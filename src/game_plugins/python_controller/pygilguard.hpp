@@ -0,0 +1,40 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2012 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PYGILGUARD_HPP
+#define PYGILGUARD_HPP
+
+#include <Python.h>
+
+/**
+* Holds the GIL for the calling thread while in scope. The plugin releases
+* the GIL once it has been initialized, so every entry point from the game
+* into Python code has to take it first: controllers may be created, run
+* and destroyed in any thread, e.g. by the parallel RaceRunner. Guards may
+* be nested.
+**/
+class PyGILGuard {
+public:
+	PyGILGuard(): m_state(PyGILState_Ensure()) {}
+	~PyGILGuard() {PyGILState_Release(m_state);}
+
+	PyGILGuard(const PyGILGuard&) = delete;
+	PyGILGuard& operator=(const PyGILGuard&) = delete;
+
+private:
+	PyGILState_STATE m_state;
+};
+
+#endif // PYGILGUARD_HPP
@@ -1,6 +1,7 @@
 #include "pylistener.hpp"
 #include "pydata.hpp"
 #include "pythonexception.hpp"
+#include "pygilguard.hpp"
 
 #include <car.hpp>
 #include <track.hpp>
@@ -13,6 +14,8 @@
 PyListener::PyListener(PyObject* listenerFunc, const PyDataMakerPtr& dataMaker):
 m_data(false), m_dataMaker(dataMaker)
 {
+	PyGILGuard gil;
+
 	m_listenerObj = PyObject_CallObject(listenerFunc, NULL);
 	if(!m_listenerObj) throw std::runtime_error("The Python listener creation function has not returned a valid object.");
 	
@@ -22,6 +25,10 @@ m_data(false), m_dataMaker(dataMaker)
 }
 
 PyListener::~PyListener() {
+	// Held by process-wide registries, so this may run after Py_Finalize.
+	if(!Py_IsInitialized()) return;
+	PyGILGuard gil;
+
 	Py_DECREF(m_reportFunc);
 	Py_DECREF(m_listenerObj);
 }
@@ -33,6 +40,8 @@ void PyListener::report(
 	float speedControl,
 	bool
 ) {
+	PyGILGuard gil;
+
 	const Route    & route       = track->trackData().route();
 	TargetNodeBase & tnode       = *route.get(car.currentTargetNodeIndex());
 
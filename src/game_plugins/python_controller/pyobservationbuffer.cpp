@@ -0,0 +1,82 @@
+#include "pyobservationbuffer.hpp"
+#include "pythonexception.hpp"
+#include "pygilguard.hpp"
+
+#include <algorithm>
+
+PyObservationBuffer::~PyObservationBuffer() {
+	PyGILGuard gil;
+	release();
+}
+
+void PyObservationBuffer::resize(unsigned int numCars) {
+	if(numCars == m_numCars && m_observationView) return;
+
+	release();
+
+	m_observationData = createView(numCars, OBSERVATION_FIELDS, m_observationBytes, m_observationView);
+	m_commandData = createView(numCars, COMMAND_FIELDS, m_commandBytes, m_commandView);
+	m_numCars = numCars;
+}
+
+float* PyObservationBuffer::createView(unsigned int rows, unsigned int cols, PyObject*& bytes, PyObject*& view) {
+	bytes = PyByteArray_FromStringAndSize(NULL, rows * cols * sizeof(float));
+	if(!bytes) throw PythonException("Could not allocate the observation buffer.");
+
+	float* data = reinterpret_cast<float*>(PyByteArray_AS_STRING(bytes));
+	std::fill(data, data + rows * cols, 0.0f);
+
+	PyObject* flat = PyMemoryView_FromObject(bytes);
+	if(!flat) throw PythonException("Could not create a view of the observation buffer.");
+
+	view = PyObject_CallMethod(flat, const_cast<char*>("cast"), const_cast<char*>("s(II)"), "f", rows, cols);
+	Py_DECREF(flat);
+	if(!view) throw PythonException("Could not shape the view of the observation buffer.");
+
+	return data;
+}
+
+void PyObservationBuffer::release() {
+	Py_XDECREF(m_observationView);
+	Py_XDECREF(m_observationBytes);
+	Py_XDECREF(m_commandView);
+	Py_XDECREF(m_commandBytes);
+
+	m_observationView = m_observationBytes = nullptr;
+	m_commandView = m_commandBytes = nullptr;
+	m_observationData = m_commandData = nullptr;
+	m_numCars = 0;
+}
+
+void PyObservationBuffer::write(unsigned int i, const CarObservation& observation) {
+	float* row = m_observationData + i * OBSERVATION_FIELDS;
+
+	row[ANGULAR_ERROR] = observation.angularErrors.error;
+	row[ANGULAR_DELTA_ERROR] = observation.angularErrors.deltaError;
+	row[ANGULAR_DELTA_ERROR2] = observation.angularErrors.deltaError2;
+	row[DISTANCE_ERROR] = observation.distanceErrors.error;
+	row[DISTANCE_DELTA_ERROR] = observation.distanceErrors.deltaError;
+	row[DISTANCE_DELTA_ERROR2] = observation.distanceErrors.deltaError2;
+	row[STEER_CONTROL] = observation.steerControl;
+	row[SPEED_CONTROL] = observation.speedControl;
+	row[SPEED] = observation.speed;
+	row[COMPUTER_HINT] = observation.computerHint;
+	row[TILE_TYPE] = observation.tileType;
+	row[RACE_COMPLETED] = observation.isRaceCompleted ? 1 : 0;
+}
+
+CarCommand PyObservationBuffer::command(unsigned int i) const {
+	const float* row = m_commandData + i * COMMAND_FIELDS;
+
+	CarCommand command;
+	command.steer = row[STEER];
+	command.speed = row[SPEED_COMMAND];
+	return command;
+}
+
+void PyObservationBuffer::setCommand(unsigned int i, const CarCommand& command) {
+	float* row = m_commandData + i * COMMAND_FIELDS;
+
+	row[STEER] = command.steer;
+	row[SPEED_COMMAND] = command.speed;
+}
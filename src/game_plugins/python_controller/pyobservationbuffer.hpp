@@ -0,0 +1,103 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2012 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PYOBSERVATIONBUFFER_HPP
+#define PYOBSERVATIONBUFFER_HPP
+
+#include <batchcontroller.hpp>
+#include <Python.h>
+
+/**
+* Observations and commands of a batch of cars, kept in memory that is
+* shared with Python. The game writes the observations in place every tick
+* and reads the commands back, so no Python objects are created per tick.
+*
+* Both are exposed as 2D float memoryviews (one row per car) that support
+* the buffer protocol, so numpy.asarray() wraps them without copying. The
+* memory belongs to Python bytearrays, so views kept by Python stay valid
+* even after the buffer has been resized.
+**/
+class PyObservationBuffer {
+public:
+	//! Columns of the observation rows; mirrored in bindings.py.
+	enum ObservationField {
+		ANGULAR_ERROR = 0,
+		ANGULAR_DELTA_ERROR,
+		ANGULAR_DELTA_ERROR2,
+		DISTANCE_ERROR,
+		DISTANCE_DELTA_ERROR,
+		DISTANCE_DELTA_ERROR2,
+		STEER_CONTROL,
+		SPEED_CONTROL,
+		SPEED,
+		COMPUTER_HINT,
+		TILE_TYPE,
+		RACE_COMPLETED,
+		OBSERVATION_FIELDS
+	};
+
+	//! Columns of the command rows; mirrored in bindings.py.
+	enum CommandField {
+		STEER = 0,
+		SPEED_COMMAND,
+		COMMAND_FIELDS
+	};
+
+public:
+	PyObservationBuffer() = default;
+	~PyObservationBuffer();
+
+	PyObservationBuffer(const PyObservationBuffer&) = delete;
+	PyObservationBuffer& operator=(const PyObservationBuffer&) = delete;
+
+	//! Makes room for the given number of cars. New views are only
+	//! created when the number changes.
+	void resize(unsigned int numCars);
+
+	unsigned int size() const {return m_numCars;}
+
+	//! Writes the observation of the i-th car.
+	void write(unsigned int i, const CarObservation& observation);
+
+	//! Reads the command of the i-th car.
+	CarCommand command(unsigned int i) const;
+
+	//! Writes the command of the i-th car.
+	void setCommand(unsigned int i, const CarCommand& command);
+
+	//! A borrowed reference to the observation view.
+	PyObject* observations() const {return m_observationView;}
+
+	//! A borrowed reference to the command view.
+	PyObject* commands() const {return m_commandView;}
+
+private:
+	//! Creates a bytearray of rows x cols floats and a view over it;
+	//! returns the data pointer.
+	static float* createView(unsigned int rows, unsigned int cols, PyObject*& bytes, PyObject*& view);
+
+	void release();
+
+private:
+	unsigned int m_numCars = 0;
+	PyObject* m_observationBytes = nullptr;
+	PyObject* m_observationView = nullptr;
+	PyObject* m_commandBytes = nullptr;
+	PyObject* m_commandView = nullptr;
+	float* m_observationData = nullptr;
+	float* m_commandData = nullptr;
+};
+
+#endif // PYOBSERVATIONBUFFER_HPP
@@ -0,0 +1,128 @@
+#include "pythonbatchcontroller.hpp"
+#include "pythonexception.hpp"
+#include "pygilguard.hpp"
+
+#include <pidcontroller.hpp>
+
+PythonBatchController::PythonBatchController(PyObject* creation_method, const PyDataMakerPtr& dataMaker):
+	m_dataMaker(dataMaker)
+{
+	PyGILGuard gil;
+
+	if(!PyCallable_Check(creation_method)) throw PythonException("The specified Python batch creation function is not a callable.");
+
+	m_controller = PyObject_CallObject(creation_method, NULL);
+	if(!m_controller) throw PythonException("The Python batch creation function has not returned a valid object.");
+
+	if(PyObject_HasAttrString(m_controller, "control")) {
+		m_control = PyObject_GetAttrString(m_controller, "control");
+		if(!PyCallable_Check(m_control))
+			throw PythonException("Name control did not resolve into a valid method.");
+	}
+
+	if(PyObject_HasAttrString(m_controller, "steerControl")) {
+		m_steerControl = PyObject_GetAttrString(m_controller, "steerControl");
+		if(!PyCallable_Check(m_steerControl))
+			throw PythonException("Name steerControl did not resolve into a valid method.");
+	}
+
+	if(PyObject_HasAttrString(m_controller, "speedControl")) {
+		m_speedControl = PyObject_GetAttrString(m_controller, "speedControl");
+		if(!PyCallable_Check(m_speedControl))
+			throw PythonException("Name speedControl did not resolve into a valid method.");
+	}
+}
+
+PythonBatchController::~PythonBatchController() {
+	PyGILGuard gil;
+
+	if(m_control) Py_DECREF(m_control);
+	if(m_steerControl) Py_DECREF(m_steerControl);
+	if(m_speedControl) Py_DECREF(m_speedControl);
+	if(m_controller) Py_DECREF(m_controller);
+}
+
+void PythonBatchController::control(const std::vector<CarObservation>& observations,
+	std::vector<CarCommand>& commands)
+{
+	PyGILGuard gil;
+
+	if(m_control) {
+		callBufferControl(observations, commands);
+		return;
+	}
+
+	PyObject* data = PyList_New(observations.size());
+	for(unsigned int i = 0; i < observations.size(); i++) {
+		// PyList_SET_ITEM steals the reference
+		PyList_SET_ITEM(data, i, m_dataMaker->makeData(observations[i]));
+	}
+
+	if(m_steerControl) {
+		callControl(m_steerControl, data, commands, &CarCommand::steer);
+	} else {
+		for(unsigned int i = 0; i < observations.size(); i++) {
+			commands[i].steer = PIDController::pidSteerControl(observations[i]);
+		}
+	}
+
+	if(m_speedControl) {
+		callControl(m_speedControl, data, commands, &CarCommand::speed);
+	} else {
+		for(unsigned int i = 0; i < observations.size(); i++) {
+			commands[i].speed = PIDController::pidSpeedControl(observations[i]);
+		}
+	}
+
+	Py_DECREF(data);
+}
+
+void PythonBatchController::callBufferControl(const std::vector<CarObservation>& observations,
+	std::vector<CarCommand>& commands)
+{
+	m_buffer.resize(observations.size());
+
+	for(unsigned int i = 0; i < observations.size(); i++) {
+		m_buffer.write(i, observations[i]);
+
+		CarCommand command;
+		command.steer = PIDController::pidSteerControl(observations[i]);
+		command.speed = PIDController::pidSpeedControl(observations[i]);
+		m_buffer.setCommand(i, command);
+	}
+
+	PyObject* res = PyObject_CallFunctionObjArgs(m_control, m_buffer.observations(), m_buffer.commands(), NULL);
+	if(!res) throw PythonException("An error calling python batch control.");
+	Py_DECREF(res);
+
+	for(unsigned int i = 0; i < commands.size(); i++) {
+		commands[i] = m_buffer.command(i);
+	}
+}
+
+void PythonBatchController::callControl(PyObject* method, PyObject* data,
+	std::vector<CarCommand>& commands, float CarCommand::* field)
+{
+	PyObject* controlObj = PyObject_CallFunctionObjArgs(method, data, NULL);
+	if(!controlObj) throw PythonException("An error calling python batch control.");
+
+	PyObject* controls = PySequence_Fast(controlObj, "The batch control has not returned a sequence.");
+	Py_DECREF(controlObj);
+
+	if(!controls || PySequence_Fast_GET_SIZE(controls) != static_cast<Py_ssize_t>(commands.size())) {
+		if(controls) Py_DECREF(controls);
+		throw PythonException("The batch control has not returned a control for each car.");
+	}
+
+	for(unsigned int i = 0; i < commands.size(); i++) {
+		const double control = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(controls, i));
+		if(control == -1.0 && PyErr_Occurred()) {
+			Py_DECREF(controls);
+			throw PythonException("The batch control has returned a control that is not a number.");
+		}
+
+		commands[i].*field = control;
+	}
+
+	Py_DECREF(controls);
+}
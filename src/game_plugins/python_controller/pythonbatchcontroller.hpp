@@ -0,0 +1,65 @@
+// This file is part of Dust Racing 2D.
+// Copyright (C) 2012 Jussi Lind <jussi.lind@iki.fi>
+//
+// Dust Racing 2D is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+// Dust Racing 2D is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with Dust Racing 2D. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PYTHONBATCHCONTROLLER_HPP
+#define PYTHONBATCHCONTROLLER_HPP
+
+#include <batchcontroller.hpp>
+#include "pydata.hpp"
+#include "pyobservationbuffer.hpp"
+
+#include <Python.h>
+
+/**
+* Controls all the cars of a race through a single Python object. Its
+* steerControl and speedControl methods take a list with a PIDData per
+* car and return a sequence with a control per car, so there are at
+* most two Python calls per tick regardless of the number of cars.
+* Without speedControl, the speed is controlled as in PIDController.
+*
+* If the object has a control method instead, it is called once per tick
+* as control(observations, commands) with the views of a
+* PyObservationBuffer: a row of observations per car to read and a row
+* of commands per car to write in place. The commands come pre-filled
+* with what PIDController would do.
+**/
+class PythonBatchController: public BatchController {
+public:
+	PythonBatchController(PyObject* creation_method, const PyDataMakerPtr& dataMaker);
+	virtual ~PythonBatchController();
+
+	virtual void control(const std::vector<CarObservation>& observations,
+		std::vector<CarCommand>& commands);
+
+private:
+	//! Calls method with the data list and stores the returned
+	//! sequence into the member pointed to by field.
+	void callControl(PyObject* method, PyObject* data,
+		std::vector<CarCommand>& commands, float CarCommand::* field);
+
+	//! Runs the control method over the shared buffers.
+	void callBufferControl(const std::vector<CarObservation>& observations,
+		std::vector<CarCommand>& commands);
+
+private:
+	PyObject* m_controller = nullptr;
+	PyObject* m_control = nullptr;
+	PyObject* m_steerControl = nullptr;
+	PyObject* m_speedControl = nullptr;
+	PyDataMakerPtr m_dataMaker = nullptr;
+	PyObservationBuffer m_buffer;
+};
+
+#endif // PYTHONBATCHCONTROLLER_HPP
@@ -10,10 +10,13 @@
 
 #include <MCTrigonom>
 #include "pythonexception.hpp"
+#include "pygilguard.hpp"
 
 PythonController::PythonController(Car& car, PyObject* creation_method, const PyDataMakerPtr& dataMaker):
 	PIDController(car, false), m_dataMaker(dataMaker)
 {
+	PyGILGuard gil;
+
 	if (PyCallable_Check(creation_method)) {
         m_controller = PyObject_CallObject(creation_method, NULL);
     } else {
@@ -36,22 +39,40 @@ PythonController::PythonController(Car& car, PyObject* creation_method, const Py
 }
 
 PythonController::~PythonController() {
+	PyGILGuard gil;
+
+	if(m_tickData) Py_DECREF(m_tickData);
 	if(m_steerControl) Py_DECREF(m_steerControl);
 	if(m_speedControl) Py_DECREF(m_speedControl);
 	if(m_controller) Py_DECREF(m_controller);
 }
 
+void PythonController::update(bool isRaceCompleted) {
+	PyGILGuard gil;
+
+	// the data of the previous tick is stale by now
+	if(m_tickData) {
+		Py_DECREF(m_tickData);
+		m_tickData = nullptr;
+	}
+
+	PIDController::update(isRaceCompleted);
+}
+
+PyObject* PythonController::tickData() {
+	if(!m_tickData) m_tickData = m_dataMaker->makeData(m_data);
+	return m_tickData;
+}
+
 //! Steering logic. Returns the steering angle in degrees.
 //! Negative means left.
 float PythonController::steerControl(bool isRaceCompleted) {
 	if(m_steerControl) {
-		PyObject* data = m_dataMaker->makeData(m_data);
-
-		PyObject* controlObj = PyObject_CallFunctionObjArgs(m_steerControl, data, NULL);
+		PyGILGuard gil;
+		PyObject* controlObj = PyObject_CallFunctionObjArgs(m_steerControl, tickData(), NULL);
 		if(!controlObj) throw PythonException("An error calling python steerControl.");
 
 		float control = PyFloat_AsDouble(controlObj);
-		Py_DECREF(data);
 		Py_DECREF(controlObj);
 
 		return control;
@@ -64,13 +85,12 @@ float PythonController::steerControl(bool isRaceCompleted) {
 //! Negative values mean braking.
 float PythonController::speedControl(bool isRaceCompleted) {
 	if(m_speedControl) {
-		PyObject* data = m_dataMaker->makeData(m_data);
-		PyObject* controlObj = PyObject_CallFunctionObjArgs(m_speedControl, data, NULL);
+		PyGILGuard gil;
+		PyObject* controlObj = PyObject_CallFunctionObjArgs(m_speedControl, tickData(), NULL);
 
 		if(!controlObj) throw PythonException("An error calling python steerControl.");
 
 		float control = PyFloat_AsDouble(controlObj);
-		Py_DECREF(data);
 		Py_DECREF(controlObj);
 
 		return control;
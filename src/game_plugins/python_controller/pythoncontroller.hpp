@@ -29,6 +29,10 @@ public:
 	PythonController(Car& car, PyObject* creation_method, const PyDataMakerPtr& dataMaker);
 	virtual ~PythonController();
 
+	//! Drops the Python data of the previous tick and runs
+	//! PIDController::update.
+	virtual void update(bool isRaceCompleted);
+
 protected:
 	//! Steering logic. Returns the steering angle in degrees.
 	//! Negative means left.
@@ -38,8 +42,14 @@ protected:
 	//! Negative values mean braking.
 	virtual float speedControl(bool isRaceCompleted);
 
+private:
+	//! The Python PIDData of the current tick, made once and shared
+	//! by steerControl and speedControl.
+	PyObject* tickData();
+
 private:
 	PyObject* m_controller = nullptr;
+	PyObject* m_tickData = nullptr;
 	PyObject* m_steerControl = nullptr;
 	PyObject* m_speedControl = nullptr;
 	PyDataMakerPtr m_dataMaker = nullptr;
@@ -1,10 +1,13 @@
 #include "pythonexception.hpp"
+#include "pygilguard.hpp"
 #include <Python.h>
 
 PythonException::PythonException(const std::string& what_arg):
 	std::runtime_error(""),
 	m_what(what_arg)
 {
+	PyGILGuard gil;
+
 	// retrieve the python error message	
 	PyObject *ptype, *pvalue, *ptraceback;
 	PyErr_Fetch(&ptype, &pvalue, &ptraceback);